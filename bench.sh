@@ -0,0 +1,16 @@
+#!/bin/bash
+# usage: ./bench.sh [rounds], run every benchmark file rounds times with a Release build, under both engines
+rounds=${1:-20}
+rm -rf ./build
+mkdir ./build
+cd ./build
+cmake -DCMAKE_BUILD_TYPE=Release ..
+make
+for file in ../test/fib.test.rkt ../test/fact.test.rkt ../test/harmonic.test.rkt
+do
+    for engine in ast vm
+    do
+        echo "$file --engine=$engine x $rounds"
+        time (for ((i = 0; i < rounds; i++)); do ./Little-Racket --engine=$engine "$file" > /dev/null; done)
+    done
+done
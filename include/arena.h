@@ -0,0 +1,33 @@
+#ifndef ARENA
+#define ARENA
+
+#include <stddef.h>
+
+// arena parts
+/*
+    region allocation: objects are bumped out of large blocks and released all at once, never one by one
+    blocks are kept by arena_reset() and arena_release(), so a reused arena stops calling malloc
+*/
+typedef struct _z_arena_block Arena_Block;
+typedef struct _z_arena_block {
+    Arena_Block *next; // blocks after the current one are empty
+    size_t length; // bytes of data
+    size_t used;
+    _Alignas(16) unsigned char data[];
+} Arena_Block;
+typedef struct _z_arena {
+    Arena_Block *first;
+    Arena_Block *current; // allocations are bumped from here
+} Arena;
+typedef struct _z_arena_mark {
+    Arena_Block *block;
+    size_t used;
+} Arena_Mark; // a point to release back to, see arena_mark()
+Arena *arena_new(void);
+int arena_free(Arena *arena);
+void *arena_alloc(Arena *arena, size_t size);
+Arena_Mark arena_mark(Arena *arena);
+void arena_release(Arena *arena, Arena_Mark mark);
+void arena_reset(Arena *arena);
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef BIGNUM
+#define BIGNUM
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// bignum parts
+/*
+    arbitrary-precision integers, sign and magnitude, the magnitude is an array of 32-bit limbs, least significant first
+    a bignum is one malloc block, it is freed by free(), every operation returns a new one and never changes its operands
+    the magnitude never has leading zero limbs, 0 has no limbs and is never negative
+    multiplication switches from schoolbook to karatsuba once both operands reach BIGNUM_KARATSUBA_THRESHOLD limbs
+    bitwise operations see a negative number in two's complement with infinitely many leading 1 bits, like racket
+*/
+#define BIGNUM_KARATSUBA_THRESHOLD ((size_t)32)
+typedef uint32_t Bignum_Limb;
+typedef struct _z_bignum {
+    bool negative;
+    size_t length; // limbs in use
+    Bignum_Limb limbs[];
+} Bignum;
+typedef enum _z_bignum_bitwise {
+    BIGNUM_AND, BIGNUM_IOR, BIGNUM_XOR
+} Bignum_Bitwise;
+Bignum *bignum_from_integer(long long int n);
+Bignum *bignum_from_string(const char *text);
+Bignum *bignum_copy(const Bignum *n);
+size_t bignum_size(const Bignum *n);
+bool bignum_to_integer(const Bignum *n, long long int *integer);
+double bignum_to_double(const Bignum *n);
+char *bignum_to_string(const Bignum *n);
+int bignum_compare(const Bignum *a, const Bignum *b);
+Bignum *bignum_negate(const Bignum *n);
+Bignum *bignum_add(const Bignum *a, const Bignum *b);
+Bignum *bignum_subtract(const Bignum *a, const Bignum *b);
+Bignum *bignum_multiply(const Bignum *a, const Bignum *b);
+void bignum_divide(const Bignum *a, const Bignum *b, Bignum **quotient, Bignum **remainder);
+Bignum *bignum_bitwise(const Bignum *a, const Bignum *b, Bignum_Bitwise operation);
+Bignum *bignum_shift(const Bignum *n, long long int shift); // left when shift > 0, right rounds down
+size_t bignum_bit_length(const Bignum *n); // bits without the sign, such as integer-length in racket
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef ENVIRONMENT
+#define ENVIRONMENT
+
+#include "parser.h"
+#include "vector.h"
+#include <stddef.h>
+
+// environment parts
+typedef struct _z_environment Environment;
+typedef struct _z_environment {
+    /*
+        one environment is one activation record, created by a procedure call or let, let*, letrec
+        the global environment is created in calculator() and has no parent
+        procedure body is shared and never copied, it is evaluated against the environment
+        the slots are laid out by the context of the node which creates the environment,
+        so a variable is found by its Lexical_Address without comparing any name
+    */
+    Environment *parent; // lexically enclosing environment, NULL for the global environment
+    AST_Node **slots; // values are shared and owned by the collector, NULL means not initialized yet (letrec, define)
+    size_t length;
+    size_t reference_count; // held by evaluation, child environments and closures
+    // every live environment is linked for the collector, see gc.h
+    Environment *previous;
+    Environment *next;
+    size_t mark; // the last major collection which reached it
+} Environment;
+Environment *environment_new(Environment *parent, size_t length);
+Environment *environment_retain(Environment *env);
+int environment_release(Environment *env);
+AST_Node **environment_slot(Environment *env, Lexical_Address address);
+
+#endif
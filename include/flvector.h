@@ -0,0 +1,25 @@
+#ifndef FLVECTOR
+#define FLVECTOR
+
+#include <stddef.h>
+
+// flvector parts
+/*
+    the storage and arithmetic kernels behind the Flvector value, see racket_built_in.c for the procedures
+    elements are one contiguous block of doubles aligned to FLVECTOR_ALIGNMENT, freed by flvector_elements_free()
+    the kernels stream through it with avx when the cpu has it, sse2 otherwise on x86-64, plain loops elsewhere,
+    the choice is made once at the first call, sums are split across lanes so they may round unlike a serial loop
+    sqrt and abs are single instructions per lane, the other elementary functions run flvector_map() over libm
+*/
+#define FLVECTOR_ALIGNMENT ((size_t)32) // one avx register
+double *flvector_elements_new(size_t length); // zeroed
+void flvector_elements_free(double *elements);
+void flvector_add(double *result, const double *a, const double *b, size_t length);
+void flvector_multiply(double *result, const double *a, const double *b, size_t length);
+double flvector_sum(const double *a, size_t length);
+double flvector_dot(const double *a, const double *b, size_t length);
+void flvector_sqrt(double *result, const double *a, size_t length);
+void flvector_abs(double *result, const double *a, size_t length);
+void flvector_map(double *result, const double *a, size_t length, double (*function)(double x));
+
+#endif
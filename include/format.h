@@ -0,0 +1,18 @@
+#ifndef FORMAT
+#define FORMAT
+
+#include <stddef.h>
+
+// format parts
+/*
+    number to text without printf, the text is written into buffer with a '\0', the return is its length
+    an integer takes its digits two at a time from a table
+    a double takes the shortest digits which read back as the same double (grisu2), in racket's notation:
+    1.0, 0.1, 123.456, 1e+21, 1e-05, +inf.0, -inf.0, +nan.0
+*/
+#define FORMAT_INTEGER_LENGTH ((size_t)21) // -9223372036854775808 and '\0'
+#define FORMAT_DOUBLE_LENGTH ((size_t)32) // 17 digits, sign, point, exponent and '\0' with room to spare
+size_t format_integer(long long int n, char *buffer);
+size_t format_double(double x, char *buffer);
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef GC
+#define GC
+
+#include "parser.h"
+#include "environment.h"
+#include "vector.h"
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+// gc parts
+/*
+    precise tracing collector of runtime values, every ast_node_new(NOT_IN_AST, ...) after parsing comes from here
+    values are fixed size cells which never move, so a C local keeps pointing to its value across a collection
+    nursery: cells allocated since the last minor collection, bumped out of blocks or reused from the free list
+    old space: cells which survived a collection, promoted in place, only swept by a major collection
+    values are immutable once built, so an old value never points to a younger one, except through the two mutable holders:
+    environments, a minor collection scans all of them, a major one traces them,
+    and vectors and hash tables, every store into one goes through gc_write_barrier(), which remembers an old holder of a nursery value
+    the doubles of an flvector can change too, but they are not values
+    roots: environments and values held by C code must be pushed while something can allocate, see gc_push_xxx()
+    constants: values of literals are built once and kept by gc_keep(), every evaluation shares them
+*/
+typedef void (*GC_Root_Function)(void *data); // marks what data holds by gc_mark_value() and gc_mark_environment()
+typedef struct _z_gc_stats {
+    size_t minor_collections;
+    size_t major_collections;
+    size_t bytes_allocated;
+    size_t bytes_promoted; // survived the nursery
+    size_t bytes_freed;
+    size_t heap_bytes; // blocks taken from malloc, cells never go back to it before gc_free()
+    double pause_total; // milliseconds
+    double pause_max;
+} GC_Stats;
+AST_Node *gc_alloc(void);
+void gc_set_nursery_length(size_t length);
+void gc_push_values(AST_Node **values, size_t length);
+void gc_push_vector(Vector *values);
+void gc_push_environment(Environment **env);
+void gc_push_root(GC_Root_Function function, void *data);
+void gc_keep(AST_Node *value);
+void gc_pop(size_t count);
+void gc_mark_value(AST_Node *value);
+void gc_mark_environment(Environment *env);
+void gc_collect(bool major);
+void gc_write_barrier(AST_Node *holder, AST_Node *value);
+void gc_track_environment(Environment *env);
+void gc_untrack_environment(Environment *env);
+GC_Stats gc_stats(void);
+void gc_print_stats(FILE *stream);
+int gc_free(void);
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef HAMT
+#define HAMT
+
+#include "parser.h"
+#include "hash_table.h"
+#include <stddef.h>
+#include <stdbool.h>
+
+// hamt parts
+/*
+    the trie behind an immutable hash, a hash array mapped trie of Hash_Node values, see racket_built_in.c for the procedures
+    every level takes HAMT_BITS bits of the hash of a key, hash_table_hash(HASH_EQUAL, key), as one of 32 branches,
+    a node keeps only the branches it has, an entry is found at the popcount of the bits of bitmap below its branch
+    keys whose hashes have the same bits all the way down share a node with a bitmap of 0, searched one by one
+    nodes are never changed once built, hamt_set() and hamt_remove() copy the nodes on the path to the key,
+    at most one per level, and share the rest with the trie they are given, so a trie is a value like a list
+    they allocate, root, key and value must be rooted by the caller, the new root is held by nothing
+*/
+#define HAMT_BITS 5
+AST_Node *hamt_get(AST_Node *root, AST_Node *key, bool *found); // the value of key, found is false when key is not in the trie
+AST_Node *hamt_set(AST_Node *root, AST_Node *key, AST_Node *value, bool *added); // added is whether key was not in the trie
+AST_Node *hamt_remove(AST_Node *root, AST_Node *key, bool *removed); // NULL when nothing is left
+void hamt_for_each(AST_Node *root, Hash_Table_Function function, void *aux_data); // entries are copies, their hash is 0
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef HASH_TABLE
+#define HASH_TABLE
+
+#include "parser.h"
+#include <stddef.h>
+#include <stdbool.h>
+
+// hash table parts
+/*
+    the storage behind the Racket_Hash value, see racket_built_in.c for the procedures
+    open addressing like a swiss table: every slot has one control byte, empty, deleted, or 7 bits of the hash of its key
+    slots are probed a group of HASH_TABLE_GROUP at a time, the control bytes of a group are compared with the 7 bits
+    in one sse2 instruction on x86-64, a plain loop elsewhere, so a key is only compared with the slots whose byte matches
+    groups are visited in triangular order, a group with an empty slot ends a lookup
+    HASH_EQUAL tables compare keys by value_equal() and hash them by value_hash(), HASH_EQ tables by identity
+    a key changed after it was added, such as a vector, is not found again, like racket
+    the table holds values but never allocates one, the collector marks them through hash_table_for_each()
+*/
+#define HASH_TABLE_GROUP ((size_t)16) // one sse2 register of control bytes
+typedef enum _z_hash_table_equality {
+    HASH_EQUAL, HASH_EQ
+} Hash_Table_Equality;
+typedef struct _z_hash_table_entry {
+    AST_Node *key;
+    AST_Node *value;
+    size_t hash; // kept so growing never hashes a key again
+} Hash_Table_Entry;
+typedef struct _z_hash_table {
+    Hash_Table_Equality equality;
+    signed char *control; // capacity bytes, aligned to HASH_TABLE_GROUP
+    Hash_Table_Entry *entries; // capacity slots, valid where control is not empty or deleted
+    size_t length; // keys in the table
+    size_t capacity; // a power of 2, at least HASH_TABLE_GROUP
+    size_t growth_left; // empty slots which may still be taken before the table grows, 1/8 of them always stay empty
+} Hash_Table;
+typedef void (*Hash_Table_Function)(Hash_Table_Entry *entry, void *aux_data);
+Hash_Table *hash_table_new(Hash_Table_Equality equality);
+void hash_table_free(Hash_Table *table);
+Hash_Table_Entry *hash_table_get(Hash_Table *table, AST_Node *key); // NULL when key is not in the table
+void hash_table_set(Hash_Table *table, AST_Node *key, AST_Node *value);
+bool hash_table_remove(Hash_Table *table, AST_Node *key);
+void hash_table_for_each(Hash_Table *table, Hash_Table_Function function, void *aux_data); // function must not change the table
+size_t hash_table_hash(Hash_Table_Equality equality, AST_Node *key); // the hash of key a table of equality uses
+
+#endif
@@ -2,14 +2,25 @@
 #define INTERPRETER
 
 #include "parser.h"
+#include "environment.h"
 #include "vector.h"
+#include <stdbool.h>
 
 // calculator parts
 typedef AST_Node *Result; // the result of whole racket code
+typedef enum _z_engine {
+    AST_ENGINE, // eval() walks the ast, the default
+    VM_ENGINE // compile() to bytecode, then vm_run()
+} Engine;
 void generate_context(AST_Node *node, AST_Node *parent, void *aux_data);
-Result eval(AST_Node *ast_node, void *aux_data);
-Vector *calculator(AST ast, void *aux_data);
-int results_free(Vector *results);
-void output_results(Vector *results, void *aux_data);
+void resolve_addresses(AST ast, void *aux_data);
+Result eval(AST_Node *ast_node, Environment *env, void *aux_data);
+Result apply_procedure(AST_Node *procedure, size_t argc, AST_Node **argv);
+typedef void (*Result_Function)(Result result, void *aux_data); // takes every top level result as soon as its form is done
+void calculator(AST ast, Engine engine, Result_Function function, void *aux_data);
+void output_result_line(Result result, void *aux_data);
+bool is_false(AST_Node *value);
+void set_procedure_name(AST_Node *procedure, const unsigned char *name);
+AST_Node *lookup_value(Environment *env, Lexical_Address address, const unsigned char *name);
 
 #endif
\ No newline at end of file
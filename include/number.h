@@ -0,0 +1,49 @@
+#ifndef ZNUMBER
+#define ZNUMBER
+
+#include "parser.h"
+#include "bignum.h"
+#include <stdbool.h>
+
+// number parts
+/*
+    arithmetic over runtime numbers: exact integers, which are fixnums or bignums, exact rationals and flonums
+    two fixnums take the fast path, a bignum is only made when the exact result leaves the fixnum range
+    and is demoted back as soon as it fits again, an inexact operand makes the result inexact
+    a rational is kept in lowest terms with a positive denominator, it collapses to an integer when the denominator is 1,
+    when its parts are fixnums and nothing overflows it is computed natively and reduced by binary gcd
+    operands must be numbers and stay untouched, the result may be a new heap value
+    integer division and rounding keep exact numbers exact, an exact power is computed by squaring,
+    and the root of an exact perfect square is exact, complex numbers are not supported so a root of a negative is +nan.0
+    bitwise operations take exact integers in two's complement, two fixnums never leave native words
+*/
+#define NUMBER_UNORDERED 2 // number_compare() of a NaN, no order holds
+typedef enum _z_number_division {
+    NUMBER_QUOTIENT, // truncated
+    NUMBER_REMAINDER, // takes the sign of the dividend
+    NUMBER_MODULO // takes the sign of the divisor
+} Number_Division;
+typedef enum _z_number_rounding {
+    NUMBER_FLOOR, NUMBER_CEILING,
+    NUMBER_ROUND, // to the nearest, ties to even
+    NUMBER_TRUNCATE
+} Number_Rounding;
+AST_Node *number_add(AST_Node *a, AST_Node *b);
+AST_Node *number_subtract(AST_Node *a, AST_Node *b);
+AST_Node *number_multiply(AST_Node *a, AST_Node *b);
+AST_Node *number_divide(AST_Node *a, AST_Node *b);
+AST_Node *number_negate(AST_Node *a);
+int number_compare(AST_Node *a, AST_Node *b);
+bool number_is_integer(AST_Node *n);
+AST_Node *number_integer_divide(AST_Node *a, AST_Node *b, Number_Division division); // integers, b is not 0
+AST_Node *number_round(AST_Node *a, Number_Rounding rounding);
+AST_Node *number_expt(AST_Node *base, AST_Node *exponent); // not 0 to a negative exact power, an exact base to a bignum power is 0, 1 or -1
+AST_Node *number_sqrt(AST_Node *a); // a is not negative
+AST_Node *number_abs(AST_Node *a);
+AST_Node *number_bitwise(AST_Node *a, AST_Node *b, Bignum_Bitwise operation);
+AST_Node *number_bitwise_not(AST_Node *a);
+AST_Node *number_arithmetic_shift(AST_Node *a, long long int shift);
+size_t number_integer_length(AST_Node *a);
+char *number_to_string(AST_Node *n);
+
+#endif
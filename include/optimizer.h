@@ -0,0 +1,19 @@
+#ifndef OPTIMIZER
+#define OPTIMIZER
+
+#include "parser.h"
+
+// optimizer parts
+/*
+    rewrites the ast between parser() and calculator(), the program must behave the same
+    constant folding: a call of + - * / = < > <= >= on literal operands is replaced by its result,
+    only numbers and booleans, whose identity can not be seen, a list is a fresh value on every call
+    so is (not literal), a built-in is only folded when its name is bound nowhere in the program,
+    by define, set!, let, let*, letrec or a lambda param
+    nothing which raises an error is folded, such as a division by zero, it is still raised when evaluated
+    identities: (+ x 0) (+ 0 x) (- x 0) (* x 1) (* 1 x) (/ x 1) become x when 0 and 1 are exact and x is a number
+    or an arithmetic call, an inexact 0.0 or 1.0 can change the exactness of the result so it is kept
+*/
+void optimizer(AST ast);
+
+#endif
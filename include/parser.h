@@ -3,25 +3,40 @@
 
 #include "tokenizer.h"
 #include "vector.h"
+#include "symbol.h"
+#include "arena.h"
 #include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
 
 // parser parts
 typedef enum _z_ast_node_tag{
     IN_AST, // this kind of ast_node will be freed in ast_free() in main.c
-    NOT_IN_AST, // fresh data, not in ast
+    NOT_IN_AST, // runtime value, allocated and freed by the collector, see gc.h
     BUILT_IN_PROCEDURE, // built-in procedure
     BUILT_IN_BINDING, // built-in binding
     ADDON_PROCEDURE, // addon procedure
     ADDON_BINDING, // addon binding
     IMMUTABLE // read only value, can not be changed
 } AST_Node_Tag;
+typedef enum _z_ast_node_storage {
+    MALLOC_STORAGE, // freed by ast_node_free()
+    ARENA_STORAGE, // allocated by parser() from the AST arena with its literal payloads, released by ast_free() all at once
+    GC_STORAGE // a runtime value, ast_node_free() leaves it to the collector
+} AST_Node_Storage;
 typedef void (*Function)(void); // Function points to any type of function
 typedef enum _z_ast_node_type {
     Number_Literal, String_Literal, Character_Literal,
-    List_Literal, Pair_Literal, Boolean_Literal,
+    List_Literal, Pair_Literal, Boolean_Literal, Vector_Literal,
     Local_Binding_Form, Set_Form, Conditional_Form, Lambda_Form,
     Call_Expression, Binding, Procedure, Program, Cond_Clause,
     NULL_Expression, EMPTY_Expression,
+    Pair, // runtime pair of car and cdr, a list is a chain of them ending with '(), see value.h
+    Rational, // runtime exact ratio of two integers, a number like Number_Literal, see number.h
+    Flvector, // runtime mutable vector of doubles, one aligned block, see flvector.h
+    Racket_Vector, // runtime mutable vector of values, one contiguous block, an IMMUTABLE tag refuses changes
+    Racket_Hash, // runtime hash of keys to values, a mutable table, see hash_table.h, or an IMMUTABLE trie of Hash_Node, see hamt.h
+    Hash_Node, // runtime node of the trie of an immutable hash, shared by every hash made from it
     LAST // sign for iterate
 } AST_Node_Type;
 typedef enum _z_local_binding_form_type {
@@ -33,9 +48,20 @@ typedef enum _z_conditional_form_type {
 typedef enum _z_boolean_type {
     R_FALSE, R_TRUE // any value other than #f counts as true
 } Boolean_Type;
+typedef enum _z_exactness_type {
+    EXACT, INEXACT // c_native_value of a Number_Literal is a Bignum * or a double
+} Exactness_Type;
 typedef enum _z_cond_clause_type {
     TEST_EXPR_WITH_THENBODY, ELSE_STATEMENT, TEST_EXPR_WITH_PROC, SINGLE_TEST_EXPR
 } Cond_Clause_Type;
+typedef struct _z_environment Environment; // see environment.h
+typedef struct _z_lexical_address {
+    bool resolved; // false when the identifier is not bound anywhere, reported when it is evaluated
+    size_t depth; // how many environments up from the current one
+    size_t index; // slot in that environment, the position in the context of the node which creates it
+} Lexical_Address;
+typedef struct _z_chunk Chunk; // see vm.h
+typedef struct _z_hash_table Hash_Table; // see hash_table.h
 typedef struct _z_ast_node AST_Node;
 typedef struct _z_ast_node {
     AST_Node *parent;
@@ -45,20 +71,26 @@ typedef struct _z_ast_node {
         context: AST_Node *[] type: binding
         if contextable AST_Node, it will have this, if not contextable, set this to null
         initially, the AST_Node with type Program will have context, and other cases will be generated in generate_context() function
-        such as let's body_exprs will have context, even Number_Literal
+        the context is the layout of the environment the node creates at runtime, such as lambda's params or let's bindings
+        Program's context is the global environment: built-in bindings, addon bindings, then top level defines
+        a define reuses the slot of the binding with the same name in its context
     */ 
     AST_Node_Tag tag;
+    AST_Node_Storage storage; // where the node comes from, decides who frees it
     union {
         struct {
             /*  
               value filed:
                unsigned char * - normally literal value, such as "123.999", and set the c_native_value to 123.999(double) 
+               NULL - a number made at runtime from c_native_value, it has no text, see output_result()
                Boolean_Type * - such as #f or #t, set c_native_value to null
-               Vector * - list or pair literal, store the contents into elements(AST_Node *[]), and c_native_value set to null
+               Vector * - list, pair or vector literal, store the contents into elements(AST_Node *[]), and c_native_value set to null
             */
             void *value; 
-            // convert normally literal value to c_native_value, such as double: 123.999 or long long int: 87178291200, when list, pair, boolean, character, string set this field to null
+            // convert normally literal value to c_native_value, such as double: 123.999 or Bignum *: 87178291200, when list, pair, boolean, character, string set this field to null
             void *c_native_value; 
+            Exactness_Type exactness; // of a Number_Literal, decided once when it is made
+            AST_Node *constant; // the runtime value shared by every evaluation, built once by value_from_constant()
         } literal;
         struct { // local binding form: define, let, let*, letrec
             Local_Binding_Form_Type type;
@@ -106,32 +138,68 @@ typedef struct _z_ast_node {
             AST_Node *proc_expr; // when TEST_EXPR_WITH_PROC
         } cond_clause;
         struct { // case: let ... [a 1] 'value' field will have a value, case: a (single variable identifier) 'value' field set to null
-            unsigned char *name; // binding's name
+            const unsigned char *name; // binding's name, interned by symbol_intern(), compare by pointer
             AST_Node *value; // binding's value, pointes to a AST_Node
+            Lexical_Address address; // where the value lives at runtime, set by resolve_addresses()
         } binding;
         struct { // call_expression: (+ 1 2) etc, excludes loacl bingding form or other special form such as let define if etc, just simple function call
             // if a procedure has name, set anonymous_procedure to NULL
             // if a procedure has no name, set name to NULL
-            unsigned char *name; // search procedure by name
+            const unsigned char *name; // search procedure by name, interned by symbol_intern()
             AST_Node *anonymous_procedure; // anonymous function call, can not found fn by name, actually its a lambda expr
             Vector *params; // params is AST_Node *[]
+            Lexical_Address address; // where the procedure named name lives at runtime
         } call_expression; // call expression
         struct  {
             unsigned char *name; // copy from initial binding's name
             size_t required_params_count; // only impl required-args right now
-            Vector *params; // AST_Node *[] type: binding, set binding.value to null when define a function, just record the variable's name
-            Vector *body_exprs; // AST_Node *[]
-            Function c_native_function;
+            Vector *params; // AST_Node *[] type: binding, borrowed from the Lambda_Form, just record the variable's name
+            Vector *body_exprs; // AST_Node *[], borrowed from the Lambda_Form, shared by every call
+            Function c_native_function; // AST_Node *(*)(AST_Node *procedure, Vector *operands), the general entry point of a built-in
+            Function c_native_binary_function; // AST_Node *(*)(AST_Node *procedure, AST_Node *a, AST_Node *b), taken by calls of two operands, or NULL
+            Environment *environment; // closure, the environment where the Lambda_Form was evaluated, NULL for built-in
+            Chunk *code; // borrowed from the Lambda_Form, NULL for built-in or when evaluated by eval()
+            size_t frame_length; // slots of the environment of a call: params, then the defines in body_exprs
         } procedure; // any procedure must be in-ast, means in the tree, includes BUILT_IN_PROCEDURE etc.
         struct {
             Vector *params; // AST_Node *[] type: binding, set binding.value to null when define a function, just record the variable's name
             Vector *body_exprs; // AST_Node *[]
-        } lambda_form; // any lambda_form must be in-ast, and freed when it evaled out a procedure
+            Chunk *code; // bytecode of body_exprs, compiled on demand by compile()
+        } lambda_form; // any lambda_form must be in-ast, procedures evaled out from it borrow its params and body_exprs
         struct {
             Vector *body; // program's body is AST_Node *[]
             Vector *built_in_bindings; // like context in AST_Node, store the built-in bindings
             Vector *addon_bindings; // like context in AST_Node, store the addon bindings
+            Environment *environment; // the global environment, created in calculator()
+            Symbol_Table *global_table; // symbol -> index in context, so top level names are found without scanning context
+            Arena *arena; // nodes created by parser(), NULL for a copy
         } program;
+        struct {
+            AST_Node *car;
+            AST_Node *cdr; // shared by every list built on it by cons
+        } pair;
+        struct {
+            AST_Node *numerator; // exact integers in lowest terms
+            AST_Node *denominator; // > 1, a ratio over 1 is the integer itself
+        } rational;
+        struct {
+            size_t length;
+            double *elements; // owned, it holds no values so the collector ignores it
+        } flvector;
+        struct {
+            size_t length;
+            AST_Node **elements; // owned, changed only through gc_write_barrier(), see gc.h
+        } racket_vector;
+        struct {
+            Hash_Table *table; // owned, changed only through gc_write_barrier(), see gc.h, NULL for an immutable hash
+            AST_Node *root; // Hash_Node of an immutable hash, NULL when it is empty or mutable
+            size_t length; // keys of an immutable hash
+        } racket_hash;
+        struct {
+            uint32_t bitmap; // which of the 32 branches are taken, 0 for a node of keys whose hashes are all the same
+            size_t length; // entries, one per bit of bitmap
+            AST_Node **slots; // owned, a key and its value per entry, ordered by branch, a Hash_Node as key is a sub-node
+        } hash_node;
         struct {
             AST_Node *value; // '()
         } null_expression;
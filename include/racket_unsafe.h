@@ -0,0 +1,16 @@
+#ifndef RACKET_UNSAFE
+#define RACKET_UNSAFE
+
+#include "vector.h"
+
+// unsafe parts
+/*
+    racket/unsafe/ops: unsafe-fx+, unsafe-fl*, unsafe-car, unsafe-flvector-ref, unsafe-vector-ref and friends, for loops which have checked their data already
+    they go straight to the native operation: no arity check, no type check, no promotion to bignum or index check,
+    a wrong operand is undefined behavior, just like racket, a fixnum result out of range wraps around
+    the binary ones are called through c_native_binary_function, so a call of two operands builds no operand vector
+*/
+// return: AST_Node *[] type: binding, appended to the built-in bindings by generate_built_in_bindings()
+Vector *generate_unsafe_bindings(void);
+
+#endif
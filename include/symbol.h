@@ -0,0 +1,29 @@
+#ifndef SYMBOL
+#define SYMBOL
+
+#include <stddef.h>
+
+// symbol parts
+/*
+    every identifier is interned once by the parser, the same name is always the same pointer
+    so names are compared by pointer and hashed by address after parsing
+*/
+const unsigned char *symbol_intern(const unsigned char *name);
+int symbols_free(void);
+
+typedef struct _z_symbol_table_entry {
+    const unsigned char *symbol; // interned, NULL for an empty entry
+    size_t value;
+} Symbol_Table_Entry;
+typedef struct _z_symbol_table {
+    // open addressing with linear probing, keyed by the address of interned symbols
+    Symbol_Table_Entry *entries;
+    size_t length;
+    size_t allocated_length; // power of 2
+} Symbol_Table;
+Symbol_Table *symbol_table_new(void);
+int symbol_table_free(Symbol_Table *table);
+void symbol_table_set(Symbol_Table *table, const unsigned char *symbol, size_t value);
+Symbol_Table_Entry *symbol_table_get(Symbol_Table *table, const unsigned char *symbol);
+
+#endif
@@ -41,6 +41,7 @@ typedef enum _z_token_type {
         PAREN: ( )
         SQUARE_BRACKET: [ ]
         APOSTROPHE: ' such as '(1 2 3) list, or pair '(1 . 2) 
+        POUND: #( such as #(1 2 3) vector
         DOT: . such as '(1 . 2) pair, or decimal fraction such as: 1.456
     */
     NUMBER,
@@ -0,0 +1,211 @@
+#ifndef VALUE
+#define VALUE
+
+#include "global.h"
+#include "parser.h"
+#include "vector.h"
+#include "bignum.h"
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+
+/*
+    value parts
+    a runtime value is an AST_Node * word, small values are NaN-boxed into the word itself and need no heap allocation
+    the top 16 bits of the word decide what it is:
+        0x0000: a heap AST_Node *, or NULL for no value (define, set!)
+        0xFFFF: fixnum, 48-bit signed integer in the low bits
+        0xFFFE: other immediates, kind << 32 | payload: #t, #f, '() and characters
+        others: flonum, the bits of the double plus 2^48, NaN is canonicalized first
+    integers out of the fixnum range are bignums, they and everything else, such as strings, pairs and procedures, stay on the heap
+    a list is a chain of Pair cells ending with '(), every cons shares the tail it is given
+    immediates are never freed, copied or tagged, ast_node_free() and friends ignore them
+*/
+#define VALUE_TAG_SHIFT 48
+#define VALUE_FIXNUM_TAG ((uint64_t)0xFFFF << VALUE_TAG_SHIFT)
+#define VALUE_IMMEDIATE_TAG ((uint64_t)0xFFFE << VALUE_TAG_SHIFT)
+#define VALUE_DOUBLE_OFFSET ((uint64_t)1 << VALUE_TAG_SHIFT)
+#define VALUE_PAYLOAD_MASK (VALUE_DOUBLE_OFFSET - 1)
+#define VALUE_FIXNUM_MIN (-((long long int)1 << (VALUE_TAG_SHIFT - 1)))
+#define VALUE_FIXNUM_MAX (((long long int)1 << (VALUE_TAG_SHIFT - 1)) - 1)
+#define VALUE_CANONICAL_NAN ((uint64_t)0x7FF8000000000000)
+typedef enum _z_immediate_kind {
+    IMMEDIATE_BOOLEAN = 1, IMMEDIATE_EMPTY_LIST, IMMEDIATE_CHARACTER
+} Immediate_Kind;
+
+static inline uint64_t value_bits(AST_Node *value)
+{
+    return (uint64_t)(uintptr_t)value;
+}
+
+static inline AST_Node *value_from_bits(uint64_t bits)
+{
+    return (AST_Node *)(uintptr_t)bits;
+}
+
+// NULL and heap AST_Node *, fields can be read by ->
+static inline bool value_is_pointer(AST_Node *value)
+{
+    return (value_bits(value) >> VALUE_TAG_SHIFT) == 0;
+}
+
+static inline bool value_is_immediate(AST_Node *value)
+{
+    return !value_is_pointer(value);
+}
+
+static inline bool value_is_fixnum(AST_Node *value)
+{
+    return (value_bits(value) & VALUE_FIXNUM_TAG) == VALUE_FIXNUM_TAG;
+}
+
+static inline bool value_is_flonum(AST_Node *value)
+{
+    uint64_t tag = value_bits(value) >> VALUE_TAG_SHIFT;
+    return tag != 0 && tag < 0xFFFE;
+}
+
+static inline bool value_is_other_immediate(AST_Node *value, Immediate_Kind kind)
+{
+    return (value_bits(value) >> 32) == ((VALUE_IMMEDIATE_TAG >> 32) | kind);
+}
+
+static inline AST_Node *value_from_other_immediate(Immediate_Kind kind, uint32_t payload)
+{
+    return value_from_bits(VALUE_IMMEDIATE_TAG | ((uint64_t)kind << 32) | payload);
+}
+
+// n must be in [VALUE_FIXNUM_MIN, VALUE_FIXNUM_MAX], see value_from_integer()
+static inline AST_Node *value_from_fixnum(long long int n)
+{
+    return value_from_bits(VALUE_FIXNUM_TAG | ((uint64_t)n & VALUE_PAYLOAD_MASK));
+}
+
+static inline long long int value_to_fixnum(AST_Node *value)
+{
+    // shift the 48-bit payload up and back to extend its sign
+    return (long long int)(value_bits(value) << (64 - VALUE_TAG_SHIFT)) >> (64 - VALUE_TAG_SHIFT);
+}
+
+static inline bool value_fixnum_fits(long long int n)
+{
+    return n >= VALUE_FIXNUM_MIN && n <= VALUE_FIXNUM_MAX;
+}
+
+static inline AST_Node *value_from_double(double d)
+{
+    uint64_t bits = 0;
+    if (d != d) bits = VALUE_CANONICAL_NAN; // NaN
+    else memcpy(&bits, &d, sizeof(double));
+    return value_from_bits(bits + VALUE_DOUBLE_OFFSET);
+}
+
+static inline double value_to_flonum(AST_Node *value)
+{
+    uint64_t bits = value_bits(value) - VALUE_DOUBLE_OFFSET;
+    double d = 0.0;
+    memcpy(&d, &bits, sizeof(double));
+    return d;
+}
+
+static inline AST_Node *value_from_boolean(Boolean_Type boolean)
+{
+    return value_from_other_immediate(IMMEDIATE_BOOLEAN, boolean);
+}
+
+static inline Boolean_Type value_to_boolean(AST_Node *value)
+{
+    return (Boolean_Type)(value_bits(value) & 0xFFFFFFFF);
+}
+
+static inline AST_Node *value_from_character(unsigned char character)
+{
+    return value_from_other_immediate(IMMEDIATE_CHARACTER, character);
+}
+
+static inline unsigned char value_to_character(AST_Node *value)
+{
+    return (unsigned char)(value_bits(value) & 0xFF);
+}
+
+static inline AST_Node *value_empty_list(void)
+{
+    return value_from_other_immediate(IMMEDIATE_EMPTY_LIST, 0);
+}
+
+// the AST_Node_Type a value stands for, immediates answer Number_Literal, Boolean_Literal, Character_Literal or List_Literal
+// a Rational answers Number_Literal too, every number is one type to the built-ins
+static inline AST_Node_Type value_type(AST_Node *value)
+{
+    if (value_is_pointer(value)) return value != NULL && value->type == Rational ? Number_Literal : value->type;
+    if (value_is_fixnum(value) || value_is_flonum(value)) return Number_Literal;
+    if (value_is_other_immediate(value, IMMEDIATE_BOOLEAN)) return Boolean_Literal;
+    if (value_is_other_immediate(value, IMMEDIATE_CHARACTER)) return Character_Literal;
+    return List_Literal;
+}
+
+static inline bool value_is_pair(AST_Node *value)
+{
+    return value_is_pointer(value) && value != NULL && value->type == Pair;
+}
+
+// value must be a pair
+static inline AST_Node *value_car(AST_Node *value)
+{
+    return value->contents.pair.car;
+}
+
+// value must be a pair
+static inline AST_Node *value_cdr(AST_Node *value)
+{
+    return value->contents.pair.cdr;
+}
+
+// value must be a number, exact integers are fixnums or bignums, heap Number_Literal tagged EXACT, or a rational
+static inline bool value_is_exact(AST_Node *value)
+{
+    if (value_is_fixnum(value)) return true;
+    if (value_is_flonum(value)) return false;
+    return value->type == Rational || value->contents.literal.exactness == EXACT;
+}
+
+static inline bool value_is_rational(AST_Node *value)
+{
+    return value_is_pointer(value) && value != NULL && value->type == Rational;
+}
+
+// a bignum is never in the fixnum range, see value_from_bignum()
+static inline bool value_is_bignum(AST_Node *value)
+{
+    return value_is_pointer(value) && value != NULL && value->type == Number_Literal && value->contents.literal.exactness == EXACT;
+}
+
+// value must be a bignum, owned by the value
+static inline Bignum *value_to_bignum(AST_Node *value)
+{
+    return TYPECAST(Bignum *, value->contents.literal.c_native_value);
+}
+
+// value must be a number
+static inline double value_to_double(AST_Node *value)
+{
+    if (value_is_fixnum(value)) return TYPECAST(double, value_to_fixnum(value));
+    if (value_is_flonum(value)) return value_to_flonum(value);
+    if (value_is_rational(value))
+        return value_to_double(value->contents.rational.numerator) / value_to_double(value->contents.rational.denominator);
+    if (value_is_exact(value)) return bignum_to_double(value_to_bignum(value));
+    return *(double *)(value->contents.literal.c_native_value);
+}
+
+AST_Node *value_from_integer(long long int n);
+AST_Node *value_from_bignum(Bignum *n);
+AST_Node *value_from_literal(AST_Node *literal);
+AST_Node *value_from_constant(AST_Node *literal);
+AST_Node *value_cons(AST_Node *car, AST_Node *cdr);
+AST_Node *value_list_from_array(AST_Node **elements, size_t length, AST_Node *tail);
+bool value_is_list(AST_Node *value);
+size_t value_list_length(AST_Node *list);
+bool value_equal(AST_Node *a, AST_Node *b);
+size_t value_hash(AST_Node *value);
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef VM
+#define VM
+
+#include "parser.h"
+#include "environment.h"
+#include <stddef.h>
+
+// vm parts
+typedef enum _z_opcode {
+    OP_CONSTANT, // push constants[operand], the value of a literal or borrowed from the ast
+    OP_EMPTY_LIST, // push '()
+    OP_TRUE, // push #t
+    OP_FALSE, // push #f
+    OP_VOID, // push NULL, define and set! work out no value
+    OP_LOAD, // push the value at addresses[operand]
+    OP_DEFINE, // pop, store into addresses[operand], define and let bindings
+    OP_SET, // pop, assign to addresses[operand]
+    OP_POP, // pop, the value is left to the collector
+    OP_CLOSURE, // push a closure of the Lambda_Form constants[operand]
+    OP_JUMP, // jump to operand
+    OP_JUMP_IF_FALSE, // pop, jump to operand if it is #f
+    OP_JUMP_IF_FALSE_KEEP, // and: jump to operand keeping #f as the result, otherwise pop
+    OP_JUMP_IF_TRUE_KEEP, // or: jump to operand keeping the value as the result if it is not #f, otherwise pop
+    OP_NOT, // pop, push its negation
+    OP_ENTER, // enter a new environment of operand slots whose parent is the current one
+    OP_LEAVE, // leave operand environments, back to the enclosing one
+    OP_CALL, // stack: procedure operand_1 ... operand_n, operand is n
+    OP_TAIL_CALL, // same as OP_CALL, the callee replaces the current call frame
+    OP_RETURN // pop the result, leave the current call frame
+} Opcode;
+typedef struct _z_instruction {
+    Opcode opcode;
+    size_t operand; // index of constants or names, jump target, or count
+} Instruction;
+typedef struct _z_chunk Chunk;
+typedef struct _z_chunk {
+    /*
+        compact linear bytecode of one top level form or one Lambda_Form's body_exprs
+        top level chunks are freed after running, the Lambda_Form owns its chunk
+    */
+    Instruction *code;
+    size_t length;
+    size_t allocated_length;
+    AST_Node **constants; // values of literals, or borrowed from the ast: Procedure, Lambda_Form
+    size_t constants_length;
+    size_t constants_allocated_length;
+    const unsigned char **names; // borrowed from the ast: identifiers of bindings, only for errors
+    Lexical_Address *addresses; // addresses[i] is where names[i] lives, from resolve_addresses()
+    size_t names_length;
+    size_t names_allocated_length;
+} Chunk;
+Chunk *compile(AST_Node *ast_node, void *aux_data);
+int chunk_free(Chunk *chunk);
+AST_Node *vm_run(Chunk *chunk, Environment *env, void *aux_data);
+
+#endif
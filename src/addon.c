@@ -1,6 +1,7 @@
 #include "../include/global.h"
 #include "../include/addon.h"
 #include "../include/parser.h"
+#include "../include/value.h"
 #include "../include/vector.h"
 #include <sodium.h>
 #include <string.h>
@@ -21,9 +22,9 @@ AST_Node *racket_addon_string_sha256(AST_Node *procedure, Vector *operands)
         exit(EXIT_FAILURE); 
     }
 
-    const AST_Node *operand = *(AST_Node **)VectorNth(operands, 0);
+    AST_Node *operand = *(AST_Node **)VectorNth(operands, 0);
 
-    if (operand->type != String_Literal)
+    if (value_type(operand) != String_Literal)
     {
         fprintf(stderr, "#<procedure:%s>: operands must be string\n", procedure->contents.procedure.name);
         exit(EXIT_FAILURE);  
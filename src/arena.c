@@ -0,0 +1,100 @@
+#include "../include/global.h"
+#include "../include/arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ARENA_BLOCK_LENGTH ((size_t)64 * 1024)
+#define ARENA_ALIGNMENT ((size_t)16)
+
+static Arena_Block *arena_block_new(size_t length);
+
+Arena *arena_new(void)
+{
+    Arena *arena = malloc(sizeof(Arena));
+    if (arena == NULL)
+    {
+        perror("arena_new(): malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    arena->first = arena_block_new(ARENA_BLOCK_LENGTH);
+    arena->current = arena->first;
+
+    return arena;
+}
+
+// everything allocated from arena is released
+int arena_free(Arena *arena)
+{
+    if (arena == NULL) return 1;
+
+    Arena_Block *block = arena->first;
+    while (block != NULL)
+    {
+        Arena_Block *next = block->next;
+        free(block);
+        block = next;
+    }
+    free(arena);
+
+    return 0;
+}
+
+// return: size bytes aligned to ARENA_ALIGNMENT, uninitialized
+void *arena_alloc(Arena *arena, size_t size)
+{
+    size = (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+
+    Arena_Block *block = arena->current;
+    while (block->used + size > block->length)
+    {
+        // kept blocks which are too small for a large object are skipped
+        if (block->next == NULL)
+        {
+            block->next = arena_block_new(size > ARENA_BLOCK_LENGTH ? size : ARENA_BLOCK_LENGTH);
+        }
+        block = block->next;
+        block->used = 0;
+    }
+    arena->current = block;
+
+    void *memory = block->data + block->used;
+    block->used += size;
+
+    return memory;
+}
+
+// allocations after the mark are released by arena_release(), it works like a stack
+Arena_Mark arena_mark(Arena *arena)
+{
+    return (Arena_Mark){ arena->current, arena->current->used };
+}
+
+void arena_release(Arena *arena, Arena_Mark mark)
+{
+    arena->current = mark.block;
+    arena->current->used = mark.used;
+}
+
+// O(1), the blocks are kept for the next round
+void arena_reset(Arena *arena)
+{
+    arena->current = arena->first;
+    arena->current->used = 0;
+}
+
+static Arena_Block *arena_block_new(size_t length)
+{
+    Arena_Block *block = malloc(sizeof(Arena_Block) + length);
+    if (block == NULL)
+    {
+        perror("arena_block_new(): malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    block->next = NULL;
+    block->length = length;
+    block->used = 0;
+
+    return block;
+}
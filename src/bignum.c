@@ -0,0 +1,686 @@
+#include "../include/global.h"
+#include "../include/bignum.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#define LIMB_BITS 32
+#define LIMB_BASE ((uint64_t)1 << LIMB_BITS)
+#define DECIMAL_CHUNK ((Bignum_Limb)1000000000) // 10^9, the most decimal digits which fit in one limb
+#define DECIMAL_CHUNK_DIGITS 9
+
+static Bignum *bignum_alloc(size_t length);
+static Bignum *bignum_normalize(Bignum *n);
+static Bignum *bignum_add_signed(const Bignum *a, const Bignum *b, bool b_negative);
+static int magnitude_compare(const Bignum_Limb *a, size_t a_length, const Bignum_Limb *b, size_t b_length);
+static Bignum_Limb magnitude_add_into(Bignum_Limb *dest, size_t dest_length, const Bignum_Limb *src, size_t src_length);
+static Bignum_Limb magnitude_subtract_into(Bignum_Limb *dest, size_t dest_length, const Bignum_Limb *src, size_t src_length);
+static void magnitude_multiply(const Bignum_Limb *a, size_t a_length, const Bignum_Limb *b, size_t b_length, Bignum_Limb *product);
+static void magnitude_multiply_schoolbook(const Bignum_Limb *a, size_t a_length, const Bignum_Limb *b, size_t b_length, Bignum_Limb *product);
+static Bignum_Limb magnitude_divide_limb(const Bignum_Limb *a, size_t a_length, Bignum_Limb divisor, Bignum_Limb *quotient);
+static void magnitude_divide(const Bignum_Limb *a, size_t a_length, const Bignum_Limb *b, size_t b_length, Bignum_Limb *quotient, Bignum_Limb *remainder);
+static Bignum_Limb *limbs_alloc(size_t length);
+static void twos_complement(const Bignum *n, Bignum_Limb *limbs, size_t length);
+static size_t limb_bit_length(Bignum_Limb limb);
+
+Bignum *bignum_from_integer(long long int n)
+{
+    // the magnitude of LLONG_MIN does not fit in long long int, unsigned arithmetic wraps to it
+    unsigned long long int magnitude = n < 0 ? 0ULL - (unsigned long long int)n : (unsigned long long int)n;
+
+    Bignum *bignum = bignum_alloc(2);
+    bignum->limbs[0] = (Bignum_Limb)magnitude;
+    bignum->limbs[1] = (Bignum_Limb)(magnitude >> LIMB_BITS);
+    bignum->negative = n < 0;
+
+    return bignum_normalize(bignum);
+}
+
+// text: [+-]digits, as the tokenizer makes them
+Bignum *bignum_from_string(const char *text)
+{
+    bool negative = false;
+    if (*text == '-' || *text == '+')
+    {
+        negative = *text == '-';
+        text++;
+    }
+
+    // 10^9 < 2^32, so every 9 digits need at most one limb
+    size_t digits = strlen(text);
+    Bignum *bignum = bignum_alloc(digits / DECIMAL_CHUNK_DIGITS + 1);
+    bignum->length = 0;
+
+    // the first chunk takes the odd digits, then n = n * 10^9 + chunk
+    size_t chunk_digits = digits % DECIMAL_CHUNK_DIGITS == 0 ? DECIMAL_CHUNK_DIGITS : digits % DECIMAL_CHUNK_DIGITS;
+    while (*text != '\0')
+    {
+        Bignum_Limb chunk = 0;
+        Bignum_Limb factor = 1;
+        for (size_t i = 0; i < chunk_digits; i++)
+        {
+            chunk = chunk * 10 + (Bignum_Limb)(*text++ - '0');
+            factor *= 10;
+        }
+        chunk_digits = DECIMAL_CHUNK_DIGITS;
+
+        uint64_t carry = chunk;
+        for (size_t i = 0; i < bignum->length; i++)
+        {
+            uint64_t t = (uint64_t)bignum->limbs[i] * factor + carry;
+            bignum->limbs[i] = (Bignum_Limb)t;
+            carry = t >> LIMB_BITS;
+        }
+        if (carry != 0) bignum->limbs[bignum->length++] = (Bignum_Limb)carry;
+    }
+
+    bignum->negative = negative;
+    return bignum_normalize(bignum);
+}
+
+Bignum *bignum_copy(const Bignum *n)
+{
+    Bignum *copy = bignum_alloc(n->length);
+    memcpy(copy, n, bignum_size(n));
+    return copy;
+}
+
+// bytes of n, a copy of them is a valid bignum
+size_t bignum_size(const Bignum *n)
+{
+    return sizeof(Bignum) + sizeof(Bignum_Limb) * n->length;
+}
+
+// return: false when n does not fit in long long int
+bool bignum_to_integer(const Bignum *n, long long int *integer)
+{
+    if (n->length > 2) return false;
+
+    unsigned long long int magnitude = 0;
+    if (n->length > 0) magnitude = n->limbs[0];
+    if (n->length > 1) magnitude |= (unsigned long long int)n->limbs[1] << LIMB_BITS;
+
+    if (n->negative == true)
+    {
+        if (magnitude > (unsigned long long int)LLONG_MAX + 1) return false;
+        *integer = magnitude == (unsigned long long int)LLONG_MAX + 1 ? LLONG_MIN : -(long long int)magnitude;
+    }
+    else
+    {
+        if (magnitude > (unsigned long long int)LLONG_MAX) return false;
+        *integer = (long long int)magnitude;
+    }
+
+    return true;
+}
+
+// the nearest double when n has at most 53 significant bits, otherwise within a few ulps, too large ones are inf
+double bignum_to_double(const Bignum *n)
+{
+    double d = 0.0;
+    for (size_t i = n->length; i > 0; i--)
+    {
+        d = d * (double)LIMB_BASE + (double)n->limbs[i - 1];
+    }
+    return n->negative == true ? -d : d;
+}
+
+// return: the decimal text of n, free() it after use
+char *bignum_to_string(const Bignum *n)
+{
+    // a limb holds less than 10 decimal digits, so 10 per limb with sign and '\0' is always enough
+    char *text = (char *)malloc(n->length * 10 + 2);
+    if (text == NULL)
+    {
+        perror("bignum_to_string(): malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    if (n->length == 0)
+    {
+        strcpy(text, "0");
+        return text;
+    }
+
+    // chunks of 9 digits, least significant first, from repeated division by 10^9
+    Bignum_Limb *magnitude = limbs_alloc(n->length);
+    Bignum_Limb *chunks = limbs_alloc(n->length * 2);
+    memcpy(magnitude, n->limbs, sizeof(Bignum_Limb) * n->length);
+
+    size_t length = n->length;
+    size_t chunks_length = 0;
+    while (length > 0)
+    {
+        chunks[chunks_length++] = magnitude_divide_limb(magnitude, length, DECIMAL_CHUNK, magnitude);
+        while (length > 0 && magnitude[length - 1] == 0) length--;
+    }
+
+    char *cursor = text;
+    if (n->negative == true) *cursor++ = '-';
+    cursor += sprintf(cursor, "%u", (unsigned int)chunks[chunks_length - 1]);
+    for (size_t i = chunks_length - 1; i > 0; i--)
+    {
+        cursor += sprintf(cursor, "%09u", (unsigned int)chunks[i - 1]);
+    }
+
+    free(magnitude);
+    free(chunks);
+    return text;
+}
+
+// return: negative, 0 or positive as a < b, a = b or a > b
+int bignum_compare(const Bignum *a, const Bignum *b)
+{
+    if (a->negative != b->negative) return a->negative == true ? -1 : 1;
+
+    int order = magnitude_compare(a->limbs, a->length, b->limbs, b->length);
+    return a->negative == true ? -order : order;
+}
+
+Bignum *bignum_negate(const Bignum *n)
+{
+    Bignum *negation = bignum_copy(n);
+    if (negation->length != 0) negation->negative = !n->negative;
+    return negation;
+}
+
+Bignum *bignum_add(const Bignum *a, const Bignum *b)
+{
+    return bignum_add_signed(a, b, b->negative);
+}
+
+Bignum *bignum_subtract(const Bignum *a, const Bignum *b)
+{
+    return bignum_add_signed(a, b, !b->negative);
+}
+
+Bignum *bignum_multiply(const Bignum *a, const Bignum *b)
+{
+    if (a->length == 0 || b->length == 0) return bignum_alloc(0);
+
+    Bignum *product = bignum_alloc(a->length + b->length);
+    magnitude_multiply(a->limbs, a->length, b->limbs, b->length, product->limbs);
+    product->negative = a->negative != b->negative;
+
+    return bignum_normalize(product);
+}
+
+/*
+    truncating division: a = quotient * b + remainder, the remainder takes the sign of a, like quotient and remainder in racket
+    b must not be 0, quotient or remainder may be NULL when it is not needed
+*/
+void bignum_divide(const Bignum *a, const Bignum *b, Bignum **quotient, Bignum **remainder)
+{
+    Bignum *q = NULL;
+    Bignum *r = NULL;
+
+    if (magnitude_compare(a->limbs, a->length, b->limbs, b->length) < 0)
+    {
+        q = bignum_alloc(0);
+        r = bignum_copy(a);
+    }
+    else if (b->length == 1)
+    {
+        q = bignum_alloc(a->length);
+        r = bignum_alloc(1);
+        r->limbs[0] = magnitude_divide_limb(a->limbs, a->length, b->limbs[0], q->limbs);
+    }
+    else
+    {
+        q = bignum_alloc(a->length - b->length + 1);
+        r = bignum_alloc(b->length);
+        magnitude_divide(a->limbs, a->length, b->limbs, b->length, q->limbs, r->limbs);
+    }
+
+    q->negative = a->negative != b->negative;
+    r->negative = a->negative;
+    bignum_normalize(q);
+    bignum_normalize(r);
+
+    if (quotient != NULL) *quotient = q;
+    else free(q);
+    if (remainder != NULL) *remainder = r;
+    else free(r);
+}
+
+// each operand is widened by one limb, so its top limb is all sign bits, and so is the top limb of the result
+Bignum *bignum_bitwise(const Bignum *a, const Bignum *b, Bignum_Bitwise operation)
+{
+    size_t length = (a->length > b->length ? a->length : b->length) + 1;
+    Bignum_Limb *x = limbs_alloc(length);
+    Bignum_Limb *y = limbs_alloc(length);
+    twos_complement(a, x, length);
+    twos_complement(b, y, length);
+
+    Bignum *result = bignum_alloc(length);
+    for (size_t i = 0; i < length; i++)
+    {
+        if (operation == BIGNUM_AND) result->limbs[i] = x[i] & y[i];
+        if (operation == BIGNUM_IOR) result->limbs[i] = x[i] | y[i];
+        if (operation == BIGNUM_XOR) result->limbs[i] = x[i] ^ y[i];
+    }
+    free(x);
+    free(y);
+
+    // back to sign and magnitude, twos_complement() of a negative reads its magnitude
+    result->negative = (result->limbs[length - 1] >> (LIMB_BITS - 1)) != 0;
+    if (result->negative == true) twos_complement(result, result->limbs, length);
+
+    return bignum_normalize(result);
+}
+
+Bignum *bignum_shift(const Bignum *n, long long int shift)
+{
+    if (n->length == 0) return bignum_alloc(0);
+
+    if (shift >= 0)
+    {
+        size_t limbs = (size_t)shift / LIMB_BITS;
+        unsigned int bits = (unsigned int)((size_t)shift % LIMB_BITS);
+        Bignum *result = bignum_alloc(n->length + limbs + 1);
+        memset(result->limbs, 0, sizeof(Bignum_Limb) * limbs);
+        Bignum_Limb carry = 0;
+        for (size_t i = 0; i < n->length; i++)
+        {
+            result->limbs[i + limbs] = (Bignum_Limb)(n->limbs[i] << bits) | carry;
+            carry = bits == 0 ? 0 : n->limbs[i] >> (LIMB_BITS - bits);
+        }
+        result->limbs[n->length + limbs] = carry;
+        result->negative = n->negative;
+        return bignum_normalize(result);
+    }
+
+    // to the right the magnitude is truncated, a negative number whose lost bits are not all 0 is one further down
+    unsigned long long int distance = 0ULL - (unsigned long long int)shift;
+    if (distance / LIMB_BITS >= n->length) return bignum_from_integer(n->negative == true ? -1 : 0);
+
+    size_t limbs = (size_t)(distance / LIMB_BITS);
+    unsigned int bits = (unsigned int)(distance % LIMB_BITS);
+    bool lost = bits != 0 && (n->limbs[limbs] & (((Bignum_Limb)1 << bits) - 1)) != 0;
+    for (size_t i = 0; i < limbs && lost == false; i++) lost = n->limbs[i] != 0;
+
+    size_t length = n->length - limbs;
+    Bignum *result = bignum_alloc(length + 1);
+    for (size_t i = 0; i < length; i++)
+    {
+        Bignum_Limb high = i + 1 < length && bits != 0 ? (Bignum_Limb)(n->limbs[limbs + i + 1] << (LIMB_BITS - bits)) : 0;
+        result->limbs[i] = (n->limbs[limbs + i] >> bits) | high;
+    }
+    result->limbs[length] = 0;
+    if (n->negative == true && lost == true)
+    {
+        Bignum_Limb one = 1;
+        magnitude_add_into(result->limbs, length + 1, &one, 1);
+    }
+    result->negative = n->negative;
+    return bignum_normalize(result);
+}
+
+// a negative -m has as many bits as m - 1, so -2^k takes k bits
+size_t bignum_bit_length(const Bignum *n)
+{
+    if (n->length == 0) return 0;
+
+    size_t length = (n->length - 1) * LIMB_BITS + limb_bit_length(n->limbs[n->length - 1]);
+    if (n->negative == false) return length;
+
+    Bignum_Limb top = n->limbs[n->length - 1];
+    bool power_of_two = (top & (top - 1)) == 0;
+    for (size_t i = 0; i + 1 < n->length && power_of_two == true; i++) power_of_two = n->limbs[i] == 0;
+    return power_of_two == true ? length - 1 : length;
+}
+
+static Bignum *bignum_alloc(size_t length)
+{
+    Bignum *n = (Bignum *)malloc(sizeof(Bignum) + sizeof(Bignum_Limb) * length);
+    if (n == NULL)
+    {
+        perror("bignum_alloc(): malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    n->negative = false;
+    n->length = length;
+
+    return n;
+}
+
+// drop leading zero limbs, 0 is never negative
+static Bignum *bignum_normalize(Bignum *n)
+{
+    while (n->length > 0 && n->limbs[n->length - 1] == 0) n->length--;
+    if (n->length == 0) n->negative = false;
+    return n;
+}
+
+// a + b when b has the sign b_negative, subtraction flips it
+static Bignum *bignum_add_signed(const Bignum *a, const Bignum *b, bool b_negative)
+{
+    Bignum *sum = NULL;
+
+    if (a->negative == b_negative)
+    {
+        const Bignum *longer = a->length >= b->length ? a : b;
+        const Bignum *shorter = longer == a ? b : a;
+
+        sum = bignum_alloc(longer->length + 1);
+        memcpy(sum->limbs, longer->limbs, sizeof(Bignum_Limb) * longer->length);
+        sum->limbs[longer->length] = magnitude_add_into(sum->limbs, longer->length, shorter->limbs, shorter->length);
+        sum->negative = a->negative;
+    }
+    else
+    {
+        int order = magnitude_compare(a->limbs, a->length, b->limbs, b->length);
+        if (order == 0) return bignum_alloc(0);
+
+        const Bignum *larger = order > 0 ? a : b;
+        const Bignum *smaller = order > 0 ? b : a;
+
+        sum = bignum_alloc(larger->length);
+        memcpy(sum->limbs, larger->limbs, sizeof(Bignum_Limb) * larger->length);
+        magnitude_subtract_into(sum->limbs, larger->length, smaller->limbs, smaller->length);
+        sum->negative = order > 0 ? a->negative : b_negative;
+    }
+
+    return bignum_normalize(sum);
+}
+
+// magnitudes without leading zero limbs
+static int magnitude_compare(const Bignum_Limb *a, size_t a_length, const Bignum_Limb *b, size_t b_length)
+{
+    if (a_length != b_length) return a_length < b_length ? -1 : 1;
+
+    for (size_t i = a_length; i > 0; i--)
+    {
+        if (a[i - 1] != b[i - 1]) return a[i - 1] < b[i - 1] ? -1 : 1;
+    }
+
+    return 0;
+}
+
+// dest += src, dest_length >= src_length, return: the carry out of dest
+static Bignum_Limb magnitude_add_into(Bignum_Limb *dest, size_t dest_length, const Bignum_Limb *src, size_t src_length)
+{
+    uint64_t carry = 0;
+    size_t i = 0;
+
+    for (; i < src_length; i++)
+    {
+        uint64_t t = (uint64_t)dest[i] + src[i] + carry;
+        dest[i] = (Bignum_Limb)t;
+        carry = t >> LIMB_BITS;
+    }
+    for (; carry != 0 && i < dest_length; i++)
+    {
+        uint64_t t = (uint64_t)dest[i] + carry;
+        dest[i] = (Bignum_Limb)t;
+        carry = t >> LIMB_BITS;
+    }
+
+    return (Bignum_Limb)carry;
+}
+
+// dest -= src, dest_length >= src_length, return: the borrow out of dest, 0 when dest >= src
+static Bignum_Limb magnitude_subtract_into(Bignum_Limb *dest, size_t dest_length, const Bignum_Limb *src, size_t src_length)
+{
+    uint64_t borrow = 0;
+    size_t i = 0;
+
+    for (; i < src_length; i++)
+    {
+        uint64_t t = (uint64_t)dest[i] - src[i] - borrow;
+        dest[i] = (Bignum_Limb)t;
+        borrow = (t >> LIMB_BITS) & 1; // a wrapped difference has its high bits set
+    }
+    for (; borrow != 0 && i < dest_length; i++)
+    {
+        uint64_t t = (uint64_t)dest[i] - borrow;
+        dest[i] = (Bignum_Limb)t;
+        borrow = (t >> LIMB_BITS) & 1;
+    }
+
+    return (Bignum_Limb)borrow;
+}
+
+/*
+    product = a * b, product has a_length + b_length limbs and is written completely
+    karatsuba: with a = a1 * B^h + a0 and b = b1 * B^h + b0,
+    a * b = z2 * B^2h + z1 * B^h + z0, z0 = a0 * b0, z2 = a1 * b1, z1 = (a0 + a1) * (b0 + b1) - z0 - z2
+    three half-size products instead of four, O(n^1.585) instead of O(n^2)
+*/
+static void magnitude_multiply(const Bignum_Limb *a, size_t a_length, const Bignum_Limb *b, size_t b_length, Bignum_Limb *product)
+{
+    if (a_length < b_length)
+    {
+        const Bignum_Limb *limbs = a;
+        a = b;
+        b = limbs;
+        size_t length = a_length;
+        a_length = b_length;
+        b_length = length;
+    }
+
+    if (b_length < BIGNUM_KARATSUBA_THRESHOLD)
+    {
+        magnitude_multiply_schoolbook(a, a_length, b, b_length, product);
+        return;
+    }
+
+    size_t product_length = a_length + b_length;
+
+    if (a_length >= 2 * b_length)
+    {
+        // unbalanced, a is cut into pieces as long as b, so each piece makes a balanced product
+        memset(product, 0, sizeof(Bignum_Limb) * product_length);
+        Bignum_Limb *piece = limbs_alloc(2 * b_length);
+        for (size_t offset = 0; offset < a_length; offset += b_length)
+        {
+            size_t length = a_length - offset < b_length ? a_length - offset : b_length;
+            magnitude_multiply(a + offset, length, b, b_length, piece);
+            magnitude_add_into(product + offset, product_length - offset, piece, length + b_length);
+        }
+        free(piece);
+        return;
+    }
+
+    // b_length > half since a_length < 2 * b_length, so every part below is non-empty
+    size_t half = a_length / 2;
+    size_t a1_length = a_length - half;
+    size_t b1_length = b_length - half;
+
+    // z0 and z2 go straight to their places in product, they do not overlap
+    magnitude_multiply(a, half, b, half, product);
+    magnitude_multiply(a + half, a1_length, b + half, b1_length, product + 2 * half);
+
+    // a0 + a1 and b0 + b1, one limb longer than their longer part for the carry
+    size_t sum_a_length = a1_length + 1;
+    size_t sum_b_length = (b1_length > half ? b1_length : half) + 1;
+    Bignum_Limb *sum_a = limbs_alloc(sum_a_length);
+    Bignum_Limb *sum_b = limbs_alloc(sum_b_length);
+
+    memset(sum_a, 0, sizeof(Bignum_Limb) * sum_a_length);
+    memcpy(sum_a, a + half, sizeof(Bignum_Limb) * a1_length);
+    magnitude_add_into(sum_a, sum_a_length, a, half);
+
+    memset(sum_b, 0, sizeof(Bignum_Limb) * sum_b_length);
+    if (b1_length > half)
+    {
+        memcpy(sum_b, b + half, sizeof(Bignum_Limb) * b1_length);
+        magnitude_add_into(sum_b, sum_b_length, b, half);
+    }
+    else
+    {
+        memcpy(sum_b, b, sizeof(Bignum_Limb) * half);
+        magnitude_add_into(sum_b, sum_b_length, b + half, b1_length);
+    }
+
+    size_t middle_length = sum_a_length + sum_b_length;
+    Bignum_Limb *middle = limbs_alloc(middle_length);
+    magnitude_multiply(sum_a, sum_a_length, sum_b, sum_b_length, middle);
+    magnitude_subtract_into(middle, middle_length, product, 2 * half);
+    magnitude_subtract_into(middle, middle_length, product + 2 * half, product_length - 2 * half);
+
+    // z1 < B^(product_length - half), its leading limbs beyond that are zero
+    while (middle_length > 0 && middle[middle_length - 1] == 0) middle_length--;
+    magnitude_add_into(product + half, product_length - half, middle, middle_length);
+
+    free(sum_a);
+    free(sum_b);
+    free(middle);
+}
+
+static void magnitude_multiply_schoolbook(const Bignum_Limb *a, size_t a_length, const Bignum_Limb *b, size_t b_length, Bignum_Limb *product)
+{
+    memset(product, 0, sizeof(Bignum_Limb) * (a_length + b_length));
+
+    for (size_t i = 0; i < a_length; i++)
+    {
+        // (2^32 - 1)^2 + 2 * (2^32 - 1) = 2^64 - 1, the sum never overflows
+        uint64_t carry = 0;
+        for (size_t j = 0; j < b_length; j++)
+        {
+            uint64_t t = (uint64_t)a[i] * b[j] + product[i + j] + carry;
+            product[i + j] = (Bignum_Limb)t;
+            carry = t >> LIMB_BITS;
+        }
+        product[i + b_length] = (Bignum_Limb)carry;
+    }
+}
+
+// quotient = a / divisor, quotient may be a itself, return: the remainder
+static Bignum_Limb magnitude_divide_limb(const Bignum_Limb *a, size_t a_length, Bignum_Limb divisor, Bignum_Limb *quotient)
+{
+    uint64_t remainder = 0;
+
+    for (size_t i = a_length; i > 0; i--)
+    {
+        uint64_t current = (remainder << LIMB_BITS) | a[i - 1];
+        quotient[i - 1] = (Bignum_Limb)(current / divisor);
+        remainder = current % divisor;
+    }
+
+    return (Bignum_Limb)remainder;
+}
+
+/*
+    knuth's algorithm d, a_length >= b_length >= 2, the top limb of b is not 0
+    quotient gets a_length - b_length + 1 limbs, remainder gets b_length limbs
+    b is shifted until its top bit is set, then each quotient limb is estimated from the top two limbs and corrected at most twice
+*/
+static void magnitude_divide(const Bignum_Limb *a, size_t a_length, const Bignum_Limb *b, size_t b_length, Bignum_Limb *quotient, Bignum_Limb *remainder)
+{
+    int shift = 0;
+    while ((b[b_length - 1] << shift & ((Bignum_Limb)1 << (LIMB_BITS - 1))) == 0) shift++;
+
+    // shifts go through uint64_t, so a shift of 0 moves nothing across limbs instead of shifting by 32
+    Bignum_Limb *bn = limbs_alloc(b_length);
+    Bignum_Limb *an = limbs_alloc(a_length + 1);
+    for (size_t i = b_length - 1; i > 0; i--)
+    {
+        bn[i] = (b[i] << shift) | (Bignum_Limb)((uint64_t)b[i - 1] >> (LIMB_BITS - shift));
+    }
+    bn[0] = b[0] << shift;
+    an[a_length] = (Bignum_Limb)((uint64_t)a[a_length - 1] >> (LIMB_BITS - shift));
+    for (size_t i = a_length - 1; i > 0; i--)
+    {
+        an[i] = (a[i] << shift) | (Bignum_Limb)((uint64_t)a[i - 1] >> (LIMB_BITS - shift));
+    }
+    an[0] = a[0] << shift;
+
+    for (size_t j = a_length - b_length + 1; j > 0; j--)
+    {
+        size_t k = j - 1;
+
+        uint64_t numerator = ((uint64_t)an[k + b_length] << LIMB_BITS) | an[k + b_length - 1];
+        uint64_t estimate = numerator / bn[b_length - 1];
+        uint64_t rest = numerator % bn[b_length - 1];
+        while (estimate >= LIMB_BASE ||
+               estimate * bn[b_length - 2] > ((rest << LIMB_BITS) | an[k + b_length - 2]))
+        {
+            estimate--;
+            rest += bn[b_length - 1];
+            if (rest >= LIMB_BASE) break;
+        }
+
+        // an -= estimate * bn, shifted by k limbs
+        int64_t borrow = 0;
+        int64_t t = 0;
+        for (size_t i = 0; i < b_length; i++)
+        {
+            uint64_t p = estimate * bn[i];
+            t = (int64_t)an[i + k] - borrow - (int64_t)(p & 0xFFFFFFFF);
+            an[i + k] = (Bignum_Limb)t;
+            borrow = (int64_t)(p >> LIMB_BITS) - (t >> LIMB_BITS);
+        }
+        t = (int64_t)an[k + b_length] - borrow;
+        an[k + b_length] = (Bignum_Limb)t;
+
+        quotient[k] = (Bignum_Limb)estimate;
+        if (t < 0)
+        {
+            // the estimate was one too large, add bn back
+            quotient[k]--;
+            uint64_t carry = 0;
+            for (size_t i = 0; i < b_length; i++)
+            {
+                uint64_t sum = (uint64_t)an[i + k] + bn[i] + carry;
+                an[i + k] = (Bignum_Limb)sum;
+                carry = sum >> LIMB_BITS;
+            }
+            an[k + b_length] += (Bignum_Limb)carry;
+        }
+    }
+
+    // the remainder is what is left in an, shifted back
+    for (size_t i = 0; i < b_length - 1; i++)
+    {
+        remainder[i] = (an[i] >> shift) | (Bignum_Limb)((uint64_t)an[i + 1] << (LIMB_BITS - shift));
+    }
+    remainder[b_length - 1] = an[b_length - 1] >> shift;
+
+    free(bn);
+    free(an);
+}
+
+static Bignum_Limb *limbs_alloc(size_t length)
+{
+    Bignum_Limb *limbs = (Bignum_Limb *)malloc(sizeof(Bignum_Limb) * (length == 0 ? 1 : length));
+    if (limbs == NULL)
+    {
+        perror("limbs_alloc(): malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    return limbs;
+}
+
+// length limbs of n in two's complement, -m is ~m + 1, limbs may be the limbs of n itself
+static void twos_complement(const Bignum *n, Bignum_Limb *limbs, size_t length)
+{
+    uint64_t carry = 1;
+    for (size_t i = 0; i < length; i++)
+    {
+        Bignum_Limb limb = i < n->length ? n->limbs[i] : 0;
+        if (n->negative == false)
+        {
+            limbs[i] = limb;
+        }
+        else
+        {
+            uint64_t t = (uint64_t)(Bignum_Limb)~limb + carry;
+            limbs[i] = (Bignum_Limb)t;
+            carry = t >> LIMB_BITS;
+        }
+    }
+}
+
+static size_t limb_bit_length(Bignum_Limb limb)
+{
+    size_t length = 0;
+    while (limb != 0)
+    {
+        length++;
+        limb >>= 1;
+    }
+    return length;
+}
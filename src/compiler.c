@@ -0,0 +1,437 @@
+#include "../include/global.h"
+#include "../include/vm.h"
+#include "../include/parser.h"
+#include "../include/value.h"
+#include "../include/vector.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+static Chunk *chunk_new(void);
+static size_t emit(Chunk *chunk, Opcode opcode, size_t operand);
+static void patch(Chunk *chunk, size_t index, size_t target);
+static size_t add_constant(Chunk *chunk, AST_Node *constant);
+static size_t add_name(Chunk *chunk, const unsigned char *name, Lexical_Address address);
+static void compile_expression(Chunk *chunk, AST_Node *ast_node, bool tail);
+static void compile_body(Chunk *chunk, Vector *body_exprs, bool tail);
+static void compile_lambda(AST_Node *lambda_form);
+
+/*
+    lower one top level form (after generate_context) into a chunk for vm_run()
+    every Lambda_Form inside is compiled into its own chunk and stored in the Lambda_Form
+*/
+Chunk *compile(AST_Node *ast_node, void *aux_data)
+{
+    Chunk *chunk = chunk_new();
+    compile_expression(chunk, ast_node, true);
+    emit(chunk, OP_RETURN, 0);
+    return chunk;
+}
+
+int chunk_free(Chunk *chunk)
+{
+    if (chunk == NULL) return 1;
+
+    free(chunk->code);
+    free(chunk->constants);
+    free(chunk->names);
+    free(chunk->addresses);
+    free(chunk);
+
+    return 0;
+}
+
+static Chunk *chunk_new(void)
+{
+    Chunk *chunk = (Chunk *)malloc(sizeof(Chunk));
+    if (chunk == NULL)
+    {
+        perror("chunk_new(): malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    chunk->length = 0;
+    chunk->allocated_length = 16;
+    chunk->code = (Instruction *)malloc(sizeof(Instruction) * chunk->allocated_length);
+    chunk->constants_length = 0;
+    chunk->constants_allocated_length = 4;
+    chunk->constants = (AST_Node **)malloc(sizeof(AST_Node *) * chunk->constants_allocated_length);
+    chunk->names_length = 0;
+    chunk->names_allocated_length = 4;
+    chunk->names = (const unsigned char **)malloc(sizeof(const unsigned char *) * chunk->names_allocated_length);
+    chunk->addresses = (Lexical_Address *)malloc(sizeof(Lexical_Address) * chunk->names_allocated_length);
+
+    if (chunk->code == NULL || chunk->constants == NULL || chunk->names == NULL || chunk->addresses == NULL)
+    {
+        perror("chunk_new(): malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    return chunk;
+}
+
+// return: the index of the instruction, used by patch()
+static size_t emit(Chunk *chunk, Opcode opcode, size_t operand)
+{
+    if (chunk->length == chunk->allocated_length)
+    {
+        chunk->allocated_length *= 2;
+        chunk->code = (Instruction *)realloc(chunk->code, sizeof(Instruction) * chunk->allocated_length);
+        if (chunk->code == NULL)
+        {
+            perror("emit(): realloc failed");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    chunk->code[chunk->length].opcode = opcode;
+    chunk->code[chunk->length].operand = operand;
+
+    return chunk->length++;
+}
+
+// set the jump target of a jump instruction emitted before
+static void patch(Chunk *chunk, size_t index, size_t target)
+{
+    chunk->code[index].operand = target;
+}
+
+static size_t add_constant(Chunk *chunk, AST_Node *constant)
+{
+    if (chunk->constants_length == chunk->constants_allocated_length)
+    {
+        chunk->constants_allocated_length *= 2;
+        chunk->constants = (AST_Node **)realloc(chunk->constants, sizeof(AST_Node *) * chunk->constants_allocated_length);
+        if (chunk->constants == NULL)
+        {
+            perror("add_constant(): realloc failed");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    chunk->constants[chunk->constants_length] = constant;
+
+    return chunk->constants_length++;
+}
+
+static size_t add_name(Chunk *chunk, const unsigned char *name, Lexical_Address address)
+{
+    if (chunk->names_length == chunk->names_allocated_length)
+    {
+        chunk->names_allocated_length *= 2;
+        chunk->names = (const unsigned char **)realloc(chunk->names, sizeof(const unsigned char *) * chunk->names_allocated_length);
+        chunk->addresses = (Lexical_Address *)realloc(chunk->addresses, sizeof(Lexical_Address) * chunk->names_allocated_length);
+        if (chunk->names == NULL || chunk->addresses == NULL)
+        {
+            perror("add_name(): realloc failed");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    chunk->names[chunk->names_length] = name;
+    chunk->addresses[chunk->names_length] = address;
+
+    return chunk->names_length++;
+}
+
+// tail: ast_node is in a tail position, calls there replace the current call frame
+static void compile_expression(Chunk *chunk, AST_Node *ast_node, bool tail)
+{
+    bool matched = false;
+
+    if (ast_node->type == Call_Expression)
+    {
+        matched = true;
+        const unsigned char *name = ast_node->contents.call_expression.name;
+        AST_Node *anonymous_procedure = ast_node->contents.call_expression.anonymous_procedure;
+        Vector *params = ast_node->contents.call_expression.params;
+
+        if (name != NULL)
+        {
+            emit(chunk, OP_LOAD, add_name(chunk, name, ast_node->contents.call_expression.address));
+        }
+        else if (anonymous_procedure != NULL && anonymous_procedure->type == Lambda_Form)
+        {
+            // ((lambda (x) x) 1), no closure is needed, the Lambda_Form itself is called
+            compile_lambda(anonymous_procedure);
+            emit(chunk, OP_CONSTANT, add_constant(chunk, anonymous_procedure));
+        }
+        else if (anonymous_procedure != NULL && anonymous_procedure->type == Procedure)
+        {
+            emit(chunk, OP_CONSTANT, add_constant(chunk, anonymous_procedure));
+        }
+        else
+        {
+            fprintf(stderr, "compile(): call expression error\n");
+            exit(EXIT_FAILURE);
+        }
+
+        for (size_t i = 0; i < VectorLength(params); i++)
+        {
+            AST_Node *param = *(AST_Node **)VectorNth(params, i);
+            compile_expression(chunk, param, false);
+        }
+
+        emit(chunk, tail ? OP_TAIL_CALL : OP_CALL, VectorLength(params));
+    }
+
+    if (ast_node->type == Local_Binding_Form)
+    {
+        Local_Binding_Form_Type local_binding_form_type = ast_node->contents.local_binding_form.type;
+
+        if (local_binding_form_type == DEFINE)
+        {
+            matched = true;
+            AST_Node *binding = ast_node->contents.local_binding_form.contents.define.binding;
+            compile_expression(chunk, binding->contents.binding.value, false);
+            emit(chunk, OP_DEFINE, add_name(chunk, binding->contents.binding.name, binding->contents.binding.address));
+            emit(chunk, OP_VOID, 0);
+        }
+
+        if (local_binding_form_type == LET)
+        {
+            matched = true;
+            Vector *bindings = ast_node->contents.local_binding_form.contents.lets.bindings;
+            Vector *body_exprs = ast_node->contents.local_binding_form.contents.lets.body_exprs;
+
+            // init values are evaled in the outer environment, then bound from the top of the stack
+            for (size_t i = 0; i < VectorLength(bindings); i++)
+            {
+                AST_Node *binding = *(AST_Node **)VectorNth(bindings, i);
+                compile_expression(chunk, binding->contents.binding.value, false);
+            }
+            emit(chunk, OP_ENTER, VectorLength(ast_node->context));
+            for (size_t i = VectorLength(bindings); i > 0; i--)
+            {
+                AST_Node *binding = *(AST_Node **)VectorNth(bindings, i - 1);
+                emit(chunk, OP_DEFINE, add_name(chunk, binding->contents.binding.name, binding->contents.binding.address));
+            }
+
+            compile_body(chunk, body_exprs, tail);
+            emit(chunk, OP_LEAVE, 1);
+        }
+
+        if (local_binding_form_type == LET_STAR ||
+            local_binding_form_type == LETREC)
+        {
+            matched = true;
+            Vector *bindings = ast_node->contents.local_binding_form.contents.lets.bindings;
+            Vector *body_exprs = ast_node->contents.local_binding_form.contents.lets.body_exprs;
+
+            // init values are evaled in the new environment, in order, slots are NULL until initialized
+            emit(chunk, OP_ENTER, VectorLength(ast_node->context));
+            for (size_t i = 0; i < VectorLength(bindings); i++)
+            {
+                AST_Node *binding = *(AST_Node **)VectorNth(bindings, i);
+                compile_expression(chunk, binding->contents.binding.value, false);
+                emit(chunk, OP_DEFINE, add_name(chunk, binding->contents.binding.name, binding->contents.binding.address));
+            }
+
+            compile_body(chunk, body_exprs, tail);
+            emit(chunk, OP_LEAVE, 1);
+        }
+    }
+
+    if (ast_node->type == Set_Form)
+    {
+        matched = true;
+        AST_Node *id = ast_node->contents.set_form.id;
+        AST_Node *expr = ast_node->contents.set_form.expr;
+        compile_expression(chunk, expr, false);
+        emit(chunk, OP_SET, add_name(chunk, id->contents.binding.name, id->contents.binding.address));
+        emit(chunk, OP_VOID, 0);
+    }
+
+    if (ast_node->type == Conditional_Form)
+    {
+        Conditional_Form_Type conditional_form_type = ast_node->contents.conditional_form.type;
+
+        if (conditional_form_type == IF)
+        {
+            matched = true;
+            AST_Node *test_expr = ast_node->contents.conditional_form.contents.if_expression.test_expr;
+            AST_Node *then_expr = ast_node->contents.conditional_form.contents.if_expression.then_expr;
+            AST_Node *else_expr = ast_node->contents.conditional_form.contents.if_expression.else_expr;
+
+            compile_expression(chunk, test_expr, false);
+            size_t jump_to_else = emit(chunk, OP_JUMP_IF_FALSE, 0);
+            compile_expression(chunk, then_expr, tail);
+            size_t jump_to_end = emit(chunk, OP_JUMP, 0);
+            patch(chunk, jump_to_else, chunk->length);
+            compile_expression(chunk, else_expr, tail);
+            patch(chunk, jump_to_end, chunk->length);
+        }
+
+        if (conditional_form_type == COND)
+        {
+            matched = true;
+            Vector *cond_clauses = ast_node->contents.conditional_form.contents.cond_expression.cond_clauses;
+            Vector *jumps_to_end = VectorNew(sizeof(size_t));
+            bool has_else = false;
+
+            for (size_t i = 0; i < VectorLength(cond_clauses) && has_else == false; i++)
+            {
+                AST_Node *cond_clause = *(AST_Node **)VectorNth(cond_clauses, i);
+                Vector *then_bodies = cond_clause->contents.cond_clause.then_bodies;
+
+                if (cond_clause->contents.cond_clause.type == TEST_EXPR_WITH_THENBODY)
+                {
+                    // [test-expr then-body ...+]
+                    compile_expression(chunk, cond_clause->contents.cond_clause.test_expr, false);
+                    size_t jump_to_next = emit(chunk, OP_JUMP_IF_FALSE, 0);
+                    compile_body(chunk, then_bodies, tail);
+                    size_t jump_to_end = emit(chunk, OP_JUMP, 0);
+                    VectorAppend(jumps_to_end, &jump_to_end);
+                    patch(chunk, jump_to_next, chunk->length);
+                }
+                else if (cond_clause->contents.cond_clause.type == ELSE_STATEMENT)
+                {
+                    // [else then-body ...+]
+                    compile_body(chunk, then_bodies, tail);
+                    has_else = true;
+                }
+                else if (cond_clause->contents.cond_clause.type == TEST_EXPR_WITH_PROC)
+                {
+                }
+                else if (cond_clause->contents.cond_clause.type == SINGLE_TEST_EXPR)
+                {
+                }
+                else
+                {
+                    // something wrong here
+                    fprintf(stderr, "compile(): can not handle Cond_Clause_Type: %d\n", cond_clause->contents.cond_clause.type);
+                    exit(EXIT_FAILURE);
+                }
+            }
+
+            // no clause matched
+            if (has_else == false) emit(chunk, OP_VOID, 0);
+
+            for (size_t i = 0; i < VectorLength(jumps_to_end); i++)
+            {
+                patch(chunk, *(size_t *)VectorNth(jumps_to_end, i), chunk->length);
+            }
+            VectorFree(jumps_to_end, NULL, NULL);
+        }
+
+        if (conditional_form_type == AND || conditional_form_type == OR)
+        {
+            matched = true;
+            Vector *exprs = NULL;
+            if (conditional_form_type == AND) exprs = ast_node->contents.conditional_form.contents.and_expression.exprs;
+            if (conditional_form_type == OR) exprs = ast_node->contents.conditional_form.contents.or_expression.exprs;
+            size_t length = VectorLength(exprs);
+
+            if (length == 0)
+            {
+                emit(chunk, conditional_form_type == AND ? OP_TRUE : OP_FALSE, 0);
+            }
+            else
+            {
+                // the last expr is a tail position, the others may end the form early
+                Vector *jumps_to_end = VectorNew(sizeof(size_t));
+                for (size_t i = 0; i + 1 < length; i++)
+                {
+                    AST_Node *expr = *(AST_Node **)VectorNth(exprs, i);
+                    compile_expression(chunk, expr, false);
+                    size_t jump_to_end = emit(chunk, conditional_form_type == AND ? OP_JUMP_IF_FALSE_KEEP : OP_JUMP_IF_TRUE_KEEP, 0);
+                    VectorAppend(jumps_to_end, &jump_to_end);
+                }
+                compile_expression(chunk, *(AST_Node **)VectorNth(exprs, length - 1), tail);
+
+                for (size_t i = 0; i < VectorLength(jumps_to_end); i++)
+                {
+                    patch(chunk, *(size_t *)VectorNth(jumps_to_end, i), chunk->length);
+                }
+                VectorFree(jumps_to_end, NULL, NULL);
+            }
+        }
+
+        if (conditional_form_type == NOT)
+        {
+            matched = true;
+            compile_expression(chunk, ast_node->contents.conditional_form.contents.not_expression.expr, false);
+            emit(chunk, OP_NOT, 0);
+        }
+    }
+
+    if (ast_node->type == Binding)
+    {
+        matched = true;
+        AST_Node *value = ast_node->contents.binding.value;
+        if (value != NULL)
+            compile_expression(chunk, value, tail);
+        else
+            emit(chunk, OP_LOAD, add_name(chunk, ast_node->contents.binding.name, ast_node->contents.binding.address));
+    }
+
+    // literals are folded into their values here, immediates or constants kept alive by the collector
+    if (ast_node->type == Number_Literal ||
+        ast_node->type == String_Literal ||
+        ast_node->type == Character_Literal ||
+        ast_node->type == Boolean_Literal ||
+        ast_node->type == List_Literal ||
+        ast_node->type == Pair_Literal ||
+        ast_node->type == Vector_Literal)
+    {
+        matched = true;
+        emit(chunk, OP_CONSTANT, add_constant(chunk, value_from_constant(ast_node)));
+    }
+
+    if (ast_node->type == Procedure)
+    {
+        matched = true;
+        emit(chunk, OP_CONSTANT, add_constant(chunk, ast_node));
+    }
+
+    if (ast_node->type == NULL_Expression ||
+        ast_node->type == EMPTY_Expression)
+    {
+        matched = true;
+        emit(chunk, OP_EMPTY_LIST, 0);
+    }
+
+    if (ast_node->type == Lambda_Form)
+    {
+        matched = true;
+        compile_lambda(ast_node);
+        emit(chunk, OP_CLOSURE, add_constant(chunk, ast_node));
+    }
+
+    if (matched == false)
+    {
+        // when no matches any AST_Node_Type
+        fprintf(stderr, "compile(): can not compile AST_Node_Type: %d\n", ast_node->type);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// every body_expr leaves one value on the stack, only the last one is kept
+static void compile_body(Chunk *chunk, Vector *body_exprs, bool tail)
+{
+    size_t length = VectorLength(body_exprs);
+
+    if (length == 0)
+    {
+        emit(chunk, OP_VOID, 0);
+        return;
+    }
+
+    for (size_t i = 0; i < length; i++)
+    {
+        AST_Node *body_expr = *(AST_Node **)VectorNth(body_exprs, i);
+        bool last = i + 1 == length;
+        compile_expression(chunk, body_expr, last && tail);
+        if (last == false) emit(chunk, OP_POP, 0);
+    }
+}
+
+static void compile_lambda(AST_Node *lambda_form)
+{
+    if (lambda_form->contents.lambda_form.code != NULL) return;
+
+    Chunk *chunk = chunk_new();
+    lambda_form->contents.lambda_form.code = chunk; // set first, the body may refer to itself
+    compile_body(chunk, lambda_form->contents.lambda_form.body_exprs, true);
+    emit(chunk, OP_RETURN, 0);
+}
@@ -2,6 +2,9 @@
 #include "../include/debug.h"
 #include "../include/tokenizer.h"
 #include "../include/parser.h"
+#include "../include/bignum.h"
+#include "../include/format.h"
+#include <stdlib.h>
 
 void print_raw_code(const unsigned char *line, void *aux_data)
 {
@@ -60,9 +63,35 @@ static void pair_exit(AST_Node *node, AST_Node *parent, void *aux_data)
     printf(") ");
 }
 
+static void vector_enter(AST_Node *node, AST_Node *parent, void *aux_data)
+{
+    printf(" #(");
+}
+
+static void vector_exit(AST_Node *node, AST_Node *parent, void *aux_data)
+{
+    printf(") ");
+}
+
+// a number built after parsing, such as a folded one, has no text, it is printed from its native value
 static void number_enter(AST_Node *node, AST_Node *parent, void *aux_data)
 {
-    printf(" %s ", TYPECAST(unsigned char *, node->contents.literal.value));
+    if (node->contents.literal.value != NULL)
+    {
+        printf(" %s ", TYPECAST(unsigned char *, node->contents.literal.value));
+    }
+    else if (node->contents.literal.exactness == EXACT)
+    {
+        char *digits = bignum_to_string(TYPECAST(Bignum *, node->contents.literal.c_native_value));
+        printf(" %s ", digits);
+        free(digits);
+    }
+    else
+    {
+        char digits[FORMAT_DOUBLE_LENGTH];
+        format_double(*TYPECAST(double *, node->contents.literal.c_native_value), digits);
+        printf(" %s ", digits);
+    }
     if (parent != NULL && parent->type == Pair_Literal)
     {
         AST_Node *car = *(AST_Node **)VectorNth(TYPECAST(Vector *, parent->contents.literal.value), 0);    
@@ -362,6 +391,9 @@ Visitor get_custom_visitor(void)
     handler = ast_node_handler_new(Pair_Literal, pair_enter, pair_exit);
     ast_node_handler_append(visitor, handler);
 
+    handler = ast_node_handler_new(Vector_Literal, vector_enter, vector_exit);
+    ast_node_handler_append(visitor, handler);
+
     handler = ast_node_handler_new(Number_Literal, number_enter, NULL);
     ast_node_handler_append(visitor, handler);
 
@@ -0,0 +1,70 @@
+#include "../include/global.h"
+#include "../include/environment.h"
+#include "../include/parser.h"
+#include "../include/gc.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// every slot starts as NULL, length comes from the context of the node which creates the environment
+Environment *environment_new(Environment *parent, size_t length)
+{
+    Environment *env = (Environment *)malloc(sizeof(Environment));
+    if (env == NULL)
+    {
+        perror("environment_new(): malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    env->parent = parent;
+    if (parent != NULL) environment_retain(parent);
+    env->slots = NULL;
+    env->length = length;
+    if (length > 0)
+    {
+        env->slots = (AST_Node **)calloc(length, sizeof(AST_Node *));
+        if (env->slots == NULL)
+        {
+            perror("environment_new(): calloc failed");
+            exit(EXIT_FAILURE);
+        }
+    }
+    env->reference_count = 1;
+    gc_track_environment(env);
+
+    return env;
+}
+
+Environment *environment_retain(Environment *env)
+{
+    if (env != NULL) env->reference_count++;
+    return env;
+}
+
+int environment_release(Environment *env)
+{
+    if (env == NULL) return 1;
+
+    env->reference_count--;
+    if (env->reference_count > 0) return 0;
+
+    // the values in slots are left to the collector
+    gc_untrack_environment(env);
+    free(env->slots);
+
+    Environment *parent = env->parent;
+    free(env);
+    environment_release(parent);
+
+    return 0;
+}
+
+// go up address.depth environments, no name is compared
+AST_Node **environment_slot(Environment *env, Lexical_Address address)
+{
+    for (size_t i = 0; i < address.depth; i++)
+    {
+        env = env->parent;
+    }
+
+    return &env->slots[address.index];
+}
@@ -0,0 +1,319 @@
+#include "../include/global.h"
+#include "../include/flvector.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define FLVECTOR_X86_64
+#include <immintrin.h>
+#endif
+
+typedef struct _z_flvector_kernels {
+    void (*add)(double *result, const double *a, const double *b, size_t length);
+    void (*multiply)(double *result, const double *a, const double *b, size_t length);
+    double (*sum)(const double *a, size_t length);
+    double (*dot)(const double *a, const double *b, size_t length);
+    void (*sqrt)(double *result, const double *a, size_t length);
+    void (*abs)(double *result, const double *a, size_t length);
+} Flvector_Kernels;
+
+static Flvector_Kernels kernels;
+static bool kernels_selected = false;
+
+static void kernels_select(void);
+static void scalar_add(double *result, const double *a, const double *b, size_t length);
+static void scalar_multiply(double *result, const double *a, const double *b, size_t length);
+static double scalar_sum(const double *a, size_t length);
+static double scalar_dot(const double *a, const double *b, size_t length);
+static void scalar_sqrt(double *result, const double *a, size_t length);
+static void scalar_abs(double *result, const double *a, size_t length);
+#ifdef FLVECTOR_X86_64
+static void sse2_add(double *result, const double *a, const double *b, size_t length);
+static void sse2_multiply(double *result, const double *a, const double *b, size_t length);
+static double sse2_sum(const double *a, size_t length);
+static double sse2_dot(const double *a, const double *b, size_t length);
+static void sse2_sqrt(double *result, const double *a, size_t length);
+static void sse2_abs(double *result, const double *a, size_t length);
+static void avx_add(double *result, const double *a, const double *b, size_t length);
+static void avx_multiply(double *result, const double *a, const double *b, size_t length);
+static double avx_sum(const double *a, size_t length);
+static double avx_dot(const double *a, const double *b, size_t length);
+static void avx_sqrt(double *result, const double *a, size_t length);
+static void avx_abs(double *result, const double *a, size_t length);
+#endif
+
+double *flvector_elements_new(size_t length)
+{
+    // aligned_alloc() wants a multiple of the alignment, and at least one byte
+    size_t size = (length * sizeof(double) + FLVECTOR_ALIGNMENT - 1) / FLVECTOR_ALIGNMENT * FLVECTOR_ALIGNMENT;
+    if (size == 0) size = FLVECTOR_ALIGNMENT;
+
+    double *elements = (double *)aligned_alloc(FLVECTOR_ALIGNMENT, size);
+    if (elements == NULL)
+    {
+        perror("flvector_elements_new(): aligned_alloc failed");
+        exit(EXIT_FAILURE);
+    }
+    memset(elements, 0, size);
+    return elements;
+}
+
+void flvector_elements_free(double *elements)
+{
+    free(elements);
+}
+
+void flvector_add(double *result, const double *a, const double *b, size_t length)
+{
+    if (kernels_selected == false) kernels_select();
+    kernels.add(result, a, b, length);
+}
+
+void flvector_multiply(double *result, const double *a, const double *b, size_t length)
+{
+    if (kernels_selected == false) kernels_select();
+    kernels.multiply(result, a, b, length);
+}
+
+double flvector_sum(const double *a, size_t length)
+{
+    if (kernels_selected == false) kernels_select();
+    return kernels.sum(a, length);
+}
+
+double flvector_dot(const double *a, const double *b, size_t length)
+{
+    if (kernels_selected == false) kernels_select();
+    return kernels.dot(a, b, length);
+}
+
+void flvector_sqrt(double *result, const double *a, size_t length)
+{
+    if (kernels_selected == false) kernels_select();
+    kernels.sqrt(result, a, length);
+}
+
+void flvector_abs(double *result, const double *a, size_t length)
+{
+    if (kernels_selected == false) kernels_select();
+    kernels.abs(result, a, length);
+}
+
+// one native loop, function is a libm one such as exp() or floor()
+void flvector_map(double *result, const double *a, size_t length, double (*function)(double x))
+{
+    for (size_t i = 0; i < length; i++) result[i] = function(a[i]);
+}
+
+// runtime dispatch, the binary runs on any x86-64 and still uses avx where it exists
+static void kernels_select(void)
+{
+    kernels.add = scalar_add;
+    kernels.multiply = scalar_multiply;
+    kernels.sum = scalar_sum;
+    kernels.dot = scalar_dot;
+    kernels.sqrt = scalar_sqrt;
+    kernels.abs = scalar_abs;
+
+#ifdef FLVECTOR_X86_64
+    // sse2 is part of x86-64
+    kernels.add = sse2_add;
+    kernels.multiply = sse2_multiply;
+    kernels.sum = sse2_sum;
+    kernels.dot = sse2_dot;
+    kernels.sqrt = sse2_sqrt;
+    kernels.abs = sse2_abs;
+
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx"))
+    {
+        kernels.add = avx_add;
+        kernels.multiply = avx_multiply;
+        kernels.sum = avx_sum;
+        kernels.dot = avx_dot;
+        kernels.sqrt = avx_sqrt;
+        kernels.abs = avx_abs;
+    }
+#endif
+
+    kernels_selected = true;
+}
+
+static void scalar_add(double *result, const double *a, const double *b, size_t length)
+{
+    for (size_t i = 0; i < length; i++) result[i] = a[i] + b[i];
+}
+
+static void scalar_multiply(double *result, const double *a, const double *b, size_t length)
+{
+    for (size_t i = 0; i < length; i++) result[i] = a[i] * b[i];
+}
+
+static double scalar_sum(const double *a, size_t length)
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < length; i++) sum += a[i];
+    return sum;
+}
+
+static double scalar_dot(const double *a, const double *b, size_t length)
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < length; i++) sum += a[i] * b[i];
+    return sum;
+}
+
+static void scalar_sqrt(double *result, const double *a, size_t length)
+{
+    for (size_t i = 0; i < length; i++) result[i] = sqrt(a[i]);
+}
+
+static void scalar_abs(double *result, const double *a, size_t length)
+{
+    for (size_t i = 0; i < length; i++) result[i] = fabs(a[i]);
+}
+
+#ifdef FLVECTOR_X86_64
+// every block comes from flvector_elements_new(), so aligned loads and stores are safe
+
+static void sse2_add(double *result, const double *a, const double *b, size_t length)
+{
+    size_t i = 0;
+    for (; i + 2 <= length; i += 2) _mm_store_pd(result + i, _mm_add_pd(_mm_load_pd(a + i), _mm_load_pd(b + i)));
+    for (; i < length; i++) result[i] = a[i] + b[i];
+}
+
+static void sse2_multiply(double *result, const double *a, const double *b, size_t length)
+{
+    size_t i = 0;
+    for (; i + 2 <= length; i += 2) _mm_store_pd(result + i, _mm_mul_pd(_mm_load_pd(a + i), _mm_load_pd(b + i)));
+    for (; i < length; i++) result[i] = a[i] * b[i];
+}
+
+// two accumulators hide the latency of the adds
+static double sse2_sum(const double *a, size_t length)
+{
+    __m128d sum0 = _mm_setzero_pd();
+    __m128d sum1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= length; i += 4)
+    {
+        sum0 = _mm_add_pd(sum0, _mm_load_pd(a + i));
+        sum1 = _mm_add_pd(sum1, _mm_load_pd(a + i + 2));
+    }
+
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(sum0, sum1));
+    double sum = lanes[0] + lanes[1];
+    for (; i < length; i++) sum += a[i];
+    return sum;
+}
+
+static double sse2_dot(const double *a, const double *b, size_t length)
+{
+    __m128d sum0 = _mm_setzero_pd();
+    __m128d sum1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= length; i += 4)
+    {
+        sum0 = _mm_add_pd(sum0, _mm_mul_pd(_mm_load_pd(a + i), _mm_load_pd(b + i)));
+        sum1 = _mm_add_pd(sum1, _mm_mul_pd(_mm_load_pd(a + i + 2), _mm_load_pd(b + i + 2)));
+    }
+
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(sum0, sum1));
+    double sum = lanes[0] + lanes[1];
+    for (; i < length; i++) sum += a[i] * b[i];
+    return sum;
+}
+
+static void sse2_sqrt(double *result, const double *a, size_t length)
+{
+    size_t i = 0;
+    for (; i + 2 <= length; i += 2) _mm_store_pd(result + i, _mm_sqrt_pd(_mm_load_pd(a + i)));
+    for (; i < length; i++) result[i] = sqrt(a[i]);
+}
+
+// clears the sign bits
+static void sse2_abs(double *result, const double *a, size_t length)
+{
+    __m128d sign = _mm_set1_pd(-0.0);
+    size_t i = 0;
+    for (; i + 2 <= length; i += 2) _mm_store_pd(result + i, _mm_andnot_pd(sign, _mm_load_pd(a + i)));
+    for (; i < length; i++) result[i] = fabs(a[i]);
+}
+
+__attribute__((target("avx")))
+static void avx_add(double *result, const double *a, const double *b, size_t length)
+{
+    size_t i = 0;
+    for (; i + 4 <= length; i += 4) _mm256_store_pd(result + i, _mm256_add_pd(_mm256_load_pd(a + i), _mm256_load_pd(b + i)));
+    for (; i < length; i++) result[i] = a[i] + b[i];
+}
+
+__attribute__((target("avx")))
+static void avx_multiply(double *result, const double *a, const double *b, size_t length)
+{
+    size_t i = 0;
+    for (; i + 4 <= length; i += 4) _mm256_store_pd(result + i, _mm256_mul_pd(_mm256_load_pd(a + i), _mm256_load_pd(b + i)));
+    for (; i < length; i++) result[i] = a[i] * b[i];
+}
+
+__attribute__((target("avx")))
+static double avx_sum(const double *a, size_t length)
+{
+    __m256d sum0 = _mm256_setzero_pd();
+    __m256d sum1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8)
+    {
+        sum0 = _mm256_add_pd(sum0, _mm256_load_pd(a + i));
+        sum1 = _mm256_add_pd(sum1, _mm256_load_pd(a + i + 4));
+    }
+
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_add_pd(sum0, sum1));
+    double sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < length; i++) sum += a[i];
+    return sum;
+}
+
+__attribute__((target("avx")))
+static double avx_dot(const double *a, const double *b, size_t length)
+{
+    __m256d sum0 = _mm256_setzero_pd();
+    __m256d sum1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8)
+    {
+        sum0 = _mm256_add_pd(sum0, _mm256_mul_pd(_mm256_load_pd(a + i), _mm256_load_pd(b + i)));
+        sum1 = _mm256_add_pd(sum1, _mm256_mul_pd(_mm256_load_pd(a + i + 4), _mm256_load_pd(b + i + 4)));
+    }
+
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_add_pd(sum0, sum1));
+    double sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < length; i++) sum += a[i] * b[i];
+    return sum;
+}
+
+__attribute__((target("avx")))
+static void avx_sqrt(double *result, const double *a, size_t length)
+{
+    size_t i = 0;
+    for (; i + 4 <= length; i += 4) _mm256_store_pd(result + i, _mm256_sqrt_pd(_mm256_load_pd(a + i)));
+    for (; i < length; i++) result[i] = sqrt(a[i]);
+}
+
+__attribute__((target("avx")))
+static void avx_abs(double *result, const double *a, size_t length)
+{
+    __m256d sign = _mm256_set1_pd(-0.0);
+    size_t i = 0;
+    for (; i + 4 <= length; i += 4) _mm256_store_pd(result + i, _mm256_andnot_pd(sign, _mm256_load_pd(a + i)));
+    for (; i < length; i++) result[i] = fabs(a[i]);
+}
+#endif
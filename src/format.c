@@ -0,0 +1,455 @@
+#include "../include/global.h"
+#include "../include/format.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+    grisu3 from Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers" (PLDI 2010)
+    the double and the bounds of its rounding interval are scaled by a cached power of ten into a 64-bit window,
+    then digits are generated until they fall inside the interval, the scaling is off by at most one unit,
+    so the rare result that cannot be proven shortest (about 0.5%) is redone exactly with printf and strtod
+*/
+#define GRISU_ALPHA (-60) // the scaled binary exponent is kept in [GRISU_ALPHA, GRISU_GAMMA]
+#define GRISU_GAMMA (-32)
+#define CACHED_POWERS_MIN_DECIMAL_EXPONENT (-300)
+#define CACHED_POWERS_DECIMAL_STEP 8
+
+typedef struct _diy_fp {
+    uint64_t f; // significand
+    int e; // binary exponent, the value is f * 2^e
+} Diy_Fp;
+
+typedef struct _cached_power {
+    uint64_t f;
+    int e;
+    int k; // f * 2^e is about 10^k
+} Cached_Power;
+
+// 10^k for k = -300, -292, ..., 324, normalized and rounded to 64 bits
+static const Cached_Power cached_powers[] = {
+    { 0xAB70FE17C79AC6CAULL, -1060,  -300 },
+    { 0xFF77B1FCBEBCDC4FULL, -1034,  -292 },
+    { 0xBE5691EF416BD60CULL, -1007,  -284 },
+    { 0x8DD01FAD907FFC3CULL,  -980,  -276 },
+    { 0xD3515C2831559A83ULL,  -954,  -268 },
+    { 0x9D71AC8FADA6C9B5ULL,  -927,  -260 },
+    { 0xEA9C227723EE8BCBULL,  -901,  -252 },
+    { 0xAECC49914078536DULL,  -874,  -244 },
+    { 0x823C12795DB6CE57ULL,  -847,  -236 },
+    { 0xC21094364DFB5637ULL,  -821,  -228 },
+    { 0x9096EA6F3848984FULL,  -794,  -220 },
+    { 0xD77485CB25823AC7ULL,  -768,  -212 },
+    { 0xA086CFCD97BF97F4ULL,  -741,  -204 },
+    { 0xEF340A98172AACE5ULL,  -715,  -196 },
+    { 0xB23867FB2A35B28EULL,  -688,  -188 },
+    { 0x84C8D4DFD2C63F3BULL,  -661,  -180 },
+    { 0xC5DD44271AD3CDBAULL,  -635,  -172 },
+    { 0x936B9FCEBB25C996ULL,  -608,  -164 },
+    { 0xDBAC6C247D62A584ULL,  -582,  -156 },
+    { 0xA3AB66580D5FDAF6ULL,  -555,  -148 },
+    { 0xF3E2F893DEC3F126ULL,  -529,  -140 },
+    { 0xB5B5ADA8AAFF80B8ULL,  -502,  -132 },
+    { 0x87625F056C7C4A8BULL,  -475,  -124 },
+    { 0xC9BCFF6034C13053ULL,  -449,  -116 },
+    { 0x964E858C91BA2655ULL,  -422,  -108 },
+    { 0xDFF9772470297EBDULL,  -396,  -100 },
+    { 0xA6DFBD9FB8E5B88FULL,  -369,   -92 },
+    { 0xF8A95FCF88747D94ULL,  -343,   -84 },
+    { 0xB94470938FA89BCFULL,  -316,   -76 },
+    { 0x8A08F0F8BF0F156BULL,  -289,   -68 },
+    { 0xCDB02555653131B6ULL,  -263,   -60 },
+    { 0x993FE2C6D07B7FACULL,  -236,   -52 },
+    { 0xE45C10C42A2B3B06ULL,  -210,   -44 },
+    { 0xAA242499697392D3ULL,  -183,   -36 },
+    { 0xFD87B5F28300CA0EULL,  -157,   -28 },
+    { 0xBCE5086492111AEBULL,  -130,   -20 },
+    { 0x8CBCCC096F5088CCULL,  -103,   -12 },
+    { 0xD1B71758E219652CULL,   -77,    -4 },
+    { 0x9C40000000000000ULL,   -50,     4 },
+    { 0xE8D4A51000000000ULL,   -24,    12 },
+    { 0xAD78EBC5AC620000ULL,     3,    20 },
+    { 0x813F3978F8940984ULL,    30,    28 },
+    { 0xC097CE7BC90715B3ULL,    56,    36 },
+    { 0x8F7E32CE7BEA5C70ULL,    83,    44 },
+    { 0xD5D238A4ABE98068ULL,   109,    52 },
+    { 0x9F4F2726179A2245ULL,   136,    60 },
+    { 0xED63A231D4C4FB27ULL,   162,    68 },
+    { 0xB0DE65388CC8ADA8ULL,   189,    76 },
+    { 0x83C7088E1AAB65DBULL,   216,    84 },
+    { 0xC45D1DF942711D9AULL,   242,    92 },
+    { 0x924D692CA61BE758ULL,   269,   100 },
+    { 0xDA01EE641A708DEAULL,   295,   108 },
+    { 0xA26DA3999AEF774AULL,   322,   116 },
+    { 0xF209787BB47D6B85ULL,   348,   124 },
+    { 0xB454E4A179DD1877ULL,   375,   132 },
+    { 0x865B86925B9BC5C2ULL,   402,   140 },
+    { 0xC83553C5C8965D3DULL,   428,   148 },
+    { 0x952AB45CFA97A0B3ULL,   455,   156 },
+    { 0xDE469FBD99A05FE3ULL,   481,   164 },
+    { 0xA59BC234DB398C25ULL,   508,   172 },
+    { 0xF6C69A72A3989F5CULL,   534,   180 },
+    { 0xB7DCBF5354E9BECEULL,   561,   188 },
+    { 0x88FCF317F22241E2ULL,   588,   196 },
+    { 0xCC20CE9BD35C78A5ULL,   614,   204 },
+    { 0x98165AF37B2153DFULL,   641,   212 },
+    { 0xE2A0B5DC971F303AULL,   667,   220 },
+    { 0xA8D9D1535CE3B396ULL,   694,   228 },
+    { 0xFB9B7CD9A4A7443CULL,   720,   236 },
+    { 0xBB764C4CA7A44410ULL,   747,   244 },
+    { 0x8BAB8EEFB6409C1AULL,   774,   252 },
+    { 0xD01FEF10A657842CULL,   800,   260 },
+    { 0x9B10A4E5E9913129ULL,   827,   268 },
+    { 0xE7109BFBA19C0C9DULL,   853,   276 },
+    { 0xAC2820D9623BF429ULL,   880,   284 },
+    { 0x80444B5E7AA7CF85ULL,   907,   292 },
+    { 0xBF21E44003ACDD2DULL,   933,   300 },
+    { 0x8E679C2F5E44FF8FULL,   960,   308 },
+    { 0xD433179D9C8CB841ULL,   986,   316 },
+    { 0x9E19DB92B4E31BA9ULL,  1013,   324 }
+};
+
+static const char digit_pairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static char *write_digits(unsigned long long int n, char *end);
+static Diy_Fp diy_fp_multiply(Diy_Fp x, Diy_Fp y);
+static Diy_Fp diy_fp_normalize(Diy_Fp x);
+static Cached_Power cached_power_for(int e);
+static bool grisu3(double x, char *digits, int *length, int *decimal_exponent);
+static bool grisu3_digit_generate(char *digits, int *length, int *kappa, Diy_Fp low, Diy_Fp w, Diy_Fp high);
+static bool grisu3_round_weed(char *digits, int length, uint64_t distance_too_high_w, uint64_t unsafe_interval,
+                              uint64_t rest, uint64_t ten_kappa, uint64_t unit);
+static void shortest_by_printf(double x, char *digits, int *length, int *decimal_exponent);
+static size_t format_digits(char *buffer, const char *digits, int length, int decimal_exponent);
+
+size_t format_integer(long long int n, char *buffer)
+{
+    char digits[FORMAT_INTEGER_LENGTH];
+    char *end = digits + sizeof(digits);
+    // negating in unsigned keeps LLONG_MIN exact
+    char *start = write_digits(n < 0 ? 0ULL - (unsigned long long int)n : (unsigned long long int)n, end);
+    if (n < 0) *--start = '-';
+
+    size_t length = TYPECAST(size_t, end - start);
+    memcpy(buffer, start, length);
+    buffer[length] = '\0';
+    return length;
+}
+
+size_t format_double(double x, char *buffer)
+{
+    uint64_t bits = 0;
+    memcpy(&bits, &x, sizeof(bits));
+    bool negative = (bits >> 63) != 0;
+    uint64_t exponent_bits = (bits >> 52) & 0x7FF;
+    uint64_t fraction_bits = bits & (((uint64_t)1 << 52) - 1);
+
+    if (exponent_bits == 0x7FF)
+    {
+        const char *text = fraction_bits != 0 ? "+nan.0" : (negative ? "-inf.0" : "+inf.0");
+        strcpy(buffer, text);
+        return strlen(text);
+    }
+
+    char *p = buffer;
+    if (negative) *p++ = '-';
+
+    if (exponent_bits == 0 && fraction_bits == 0)
+    {
+        strcpy(p, "0.0");
+        return TYPECAST(size_t, p - buffer) + 3;
+    }
+
+    char digits[18];
+    int length = 0;
+    int decimal_exponent = 0;
+    if (grisu3(negative ? -x : x, digits, &length, &decimal_exponent) == false)
+        shortest_by_printf(negative ? -x : x, digits, &length, &decimal_exponent);
+
+    return TYPECAST(size_t, p - buffer) + format_digits(p, digits, length, decimal_exponent);
+}
+
+// the digits of n end right before end, the return is where they start
+static char *write_digits(unsigned long long int n, char *end)
+{
+    while (n >= 100)
+    {
+        unsigned int pair = TYPECAST(unsigned int, n % 100) * 2;
+        n /= 100;
+        *--end = digit_pairs[pair + 1];
+        *--end = digit_pairs[pair];
+    }
+
+    if (n >= 10)
+    {
+        unsigned int pair = TYPECAST(unsigned int, n) * 2;
+        *--end = digit_pairs[pair + 1];
+        *--end = digit_pairs[pair];
+    }
+    else
+    {
+        *--end = TYPECAST(char, '0' + n);
+    }
+
+    return end;
+}
+
+// the upper 64 bits of the 128-bit product, rounded
+static Diy_Fp diy_fp_multiply(Diy_Fp x, Diy_Fp y)
+{
+    uint64_t x_high = x.f >> 32;
+    uint64_t x_low = x.f & 0xFFFFFFFF;
+    uint64_t y_high = y.f >> 32;
+    uint64_t y_low = y.f & 0xFFFFFFFF;
+
+    uint64_t high_high = x_high * y_high;
+    uint64_t high_low = x_high * y_low;
+    uint64_t low_high = x_low * y_high;
+    uint64_t low_low = x_low * y_low;
+
+    uint64_t middle = (low_low >> 32) + (high_low & 0xFFFFFFFF) + (low_high & 0xFFFFFFFF);
+    middle += (uint64_t)1 << 31; // round
+
+    Diy_Fp product = { high_high + (high_low >> 32) + (low_high >> 32) + (middle >> 32), x.e + y.e + 64 };
+    return product;
+}
+
+static Diy_Fp diy_fp_normalize(Diy_Fp x)
+{
+    while ((x.f >> 63) == 0)
+    {
+        x.f <<= 1;
+        x.e--;
+    }
+    return x;
+}
+
+// a power of ten c with GRISU_ALPHA <= c.e + e + 64 <= GRISU_GAMMA
+static Cached_Power cached_power_for(int e)
+{
+    // k = ceil((GRISU_ALPHA - e - 1) * log10(2)), 78913 / 2^18 is log10(2) rounded up
+    int f = GRISU_ALPHA - e - 1;
+    int k = (f * 78913) / (1 << 18) + (f > 0);
+    int index = (-CACHED_POWERS_MIN_DECIMAL_EXPONENT + k + (CACHED_POWERS_DECIMAL_STEP - 1)) / CACHED_POWERS_DECIMAL_STEP;
+    return cached_powers[index];
+}
+
+// x is finite and positive, x = digits * 10^decimal_exponent, false when the digits may not be the shortest
+static bool grisu3(double x, char *digits, int *length, int *decimal_exponent)
+{
+    uint64_t bits = 0;
+    memcpy(&bits, &x, sizeof(bits));
+    uint64_t exponent_bits = bits >> 52;
+    uint64_t fraction_bits = bits & (((uint64_t)1 << 52) - 1);
+
+    Diy_Fp v;
+    if (exponent_bits == 0)
+    {
+        v.f = fraction_bits;
+        v.e = 1 - 1075;
+    }
+    else
+    {
+        v.f = fraction_bits | ((uint64_t)1 << 52);
+        v.e = TYPECAST(int, exponent_bits) - 1075;
+    }
+
+    // the rounding interval is halfway to the neighbours, the lower one is closer at a power of two
+    Diy_Fp high = { (v.f << 1) + 1, v.e - 1 };
+    Diy_Fp low;
+    if (fraction_bits == 0 && exponent_bits > 1)
+    {
+        low.f = (v.f << 2) - 1;
+        low.e = v.e - 2;
+    }
+    else
+    {
+        low.f = (v.f << 1) - 1;
+        low.e = v.e - 1;
+    }
+
+    // w and high end up with the same exponent, low is brought to it
+    high = diy_fp_normalize(high);
+    low.f <<= low.e - high.e;
+    low.e = high.e;
+    Diy_Fp w = diy_fp_normalize(v);
+
+    Cached_Power cached = cached_power_for(w.e);
+    Diy_Fp c = { cached.f, cached.e };
+    w = diy_fp_multiply(w, c);
+    low = diy_fp_multiply(low, c);
+    high = diy_fp_multiply(high, c);
+
+    int kappa = 0;
+    *length = 0;
+    bool shortest = grisu3_digit_generate(digits, length, &kappa, low, w, high);
+    *decimal_exponent = -cached.k + kappa;
+    return shortest;
+}
+
+/*
+    every scaled value is off by less than one unit, so the digits are generated inside the unsafe interval,
+    which surely contains the real one, and then checked against the safe interval, which it surely contains
+*/
+static bool grisu3_digit_generate(char *digits, int *length, int *kappa, Diy_Fp low, Diy_Fp w, Diy_Fp high)
+{
+    uint64_t unit = 1;
+    uint64_t too_low = low.f - unit;
+    uint64_t too_high = high.f + unit;
+    uint64_t unsafe_interval = too_high - too_low;
+
+    // too_high = integrals + fractionals * 2^e
+    int e = -w.e;
+    uint64_t one = (uint64_t)1 << e;
+    uint32_t integrals = TYPECAST(uint32_t, too_high >> e);
+    uint64_t fractionals = too_high & (one - 1);
+
+    uint32_t divisor = 1;
+    *kappa = 1;
+    while (*kappa < 10 && integrals / 10 >= divisor)
+    {
+        divisor *= 10;
+        (*kappa)++;
+    }
+
+    while (*kappa > 0)
+    {
+        digits[(*length)++] = TYPECAST(char, '0' + integrals / divisor);
+        integrals %= divisor;
+        (*kappa)--;
+
+        uint64_t rest = ((uint64_t)integrals << e) + fractionals;
+        if (rest < unsafe_interval)
+            return grisu3_round_weed(digits, *length, too_high - w.f, unsafe_interval, rest, (uint64_t)divisor << e, unit);
+        divisor /= 10;
+    }
+
+    for (;;)
+    {
+        fractionals *= 10;
+        unit *= 10;
+        unsafe_interval *= 10;
+
+        digits[(*length)++] = TYPECAST(char, '0' + (fractionals >> e));
+        fractionals &= one - 1;
+        (*kappa)--;
+
+        if (fractionals < unsafe_interval)
+            return grisu3_round_weed(digits, *length, (too_high - w.f) * unit, unsafe_interval, fractionals, one, unit);
+    }
+}
+
+// move the last digit towards w, then make sure it is the closest one and lies in the safe interval
+static bool grisu3_round_weed(char *digits, int length, uint64_t distance_too_high_w, uint64_t unsafe_interval,
+                              uint64_t rest, uint64_t ten_kappa, uint64_t unit)
+{
+    uint64_t small_distance = distance_too_high_w - unit;
+    uint64_t big_distance = distance_too_high_w + unit;
+
+    while (rest < small_distance && unsafe_interval - rest >= ten_kappa &&
+           (rest + ten_kappa < small_distance || small_distance - rest >= rest + ten_kappa - small_distance))
+    {
+        digits[length - 1]--;
+        rest += ten_kappa;
+    }
+
+    // another digit might be closer to the real w
+    if (rest < big_distance && unsafe_interval - rest >= ten_kappa &&
+        (rest + ten_kappa < big_distance || big_distance - rest > rest + ten_kappa - big_distance))
+    {
+        return false;
+    }
+
+    return 2 * unit <= rest && rest <= unsafe_interval - 4 * unit;
+}
+
+// the fewest significant digits printf can round x to which strtod reads back exactly
+static void shortest_by_printf(double x, char *digits, int *length, int *decimal_exponent)
+{
+    char text[FORMAT_DOUBLE_LENGTH];
+    for (int precision = 1; precision <= 17; precision++)
+    {
+        snprintf(text, sizeof(text), "%.*e", precision - 1, x);
+        if (strtod(text, NULL) == x) break;
+    }
+
+    // d.ddde+XX
+    *length = 0;
+    const char *p = text;
+    for (; *p != 'e'; p++)
+    {
+        if (*p != '.') digits[(*length)++] = *p;
+    }
+    while (*length > 1 && digits[*length - 1] == '0') (*length)--;
+    *decimal_exponent = atoi(p + 1) - (*length - 1);
+}
+
+// 1234 and -2 become 12.34, the point moves out of the digits into an exponent when it is far away
+static size_t format_digits(char *buffer, const char *digits, int length, int decimal_exponent)
+{
+    int point = length + decimal_exponent; // the value is 0.digits * 10^point
+    char *p = buffer;
+
+    if (length <= point && point <= 21)
+    {
+        memcpy(p, digits, length);
+        p += length;
+        memset(p, '0', point - length);
+        p += point - length;
+        memcpy(p, ".0", 2);
+        p += 2;
+    }
+    else if (0 < point && point <= 21)
+    {
+        memcpy(p, digits, point);
+        p += point;
+        *p++ = '.';
+        memcpy(p, digits + point, length - point);
+        p += length - point;
+    }
+    else if (-4 < point && point <= 0)
+    {
+        memcpy(p, "0.", 2);
+        p += 2;
+        memset(p, '0', -point);
+        p += -point;
+        memcpy(p, digits, length);
+        p += length;
+    }
+    else
+    {
+        *p++ = digits[0];
+        if (length > 1)
+        {
+            *p++ = '.';
+            memcpy(p, digits + 1, length - 1);
+            p += length - 1;
+        }
+
+        int exponent = point - 1;
+        *p++ = 'e';
+        *p++ = exponent < 0 ? '-' : '+';
+        if (exponent < 0) exponent = -exponent;
+        if (exponent < 10) *p++ = '0';
+        char exponent_digits[4];
+        char *end = exponent_digits + sizeof(exponent_digits);
+        char *start = write_digits(TYPECAST(unsigned long long int, exponent), end);
+        memcpy(p, start, end - start);
+        p += end - start;
+    }
+
+    *p = '\0';
+    return TYPECAST(size_t, p - buffer);
+}
@@ -0,0 +1,633 @@
+#include "../include/global.h"
+#include "../include/gc.h"
+#include "../include/parser.h"
+#include "../include/environment.h"
+#include "../include/value.h"
+#include "../include/vector.h"
+#include "../include/flvector.h"
+#include "../include/hash_table.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+
+#define GC_BLOCK_LENGTH ((size_t)1024) // cells of one block
+#define GC_NURSERY_LENGTH ((size_t)16384) // cells allocated between two minor collections by default
+#define GC_MAJOR_FACTOR ((size_t)2) // a major collection runs when the old space is this times of what the last one left
+
+typedef struct _z_gc_cell GC_Cell;
+typedef struct _z_gc_cell {
+    GC_Cell *next_free; // in the free list when not in use
+    bool in_use;
+    bool old; // promoted out of the nursery
+    bool marked; // reached by the running collection
+    bool remembered; // an old holder in the remembered set, see gc_write_barrier()
+    AST_Node node;
+} GC_Cell;
+typedef struct _z_gc_block GC_Block;
+typedef struct _z_gc_block {
+    GC_Block *next;
+    size_t used; // cells bumped out of this block, only the first block has room
+    GC_Cell cells[GC_BLOCK_LENGTH];
+} GC_Block;
+typedef enum _z_gc_root_type {
+    VALUES_ROOT, VECTOR_ROOT, ENVIRONMENT_ROOT, FUNCTION_ROOT
+} GC_Root_Type;
+typedef struct _z_gc_root {
+    GC_Root_Type type;
+    union {
+        struct {
+            AST_Node **values;
+            size_t length;
+        } values;
+        Vector *vector; // AST_Node *[], read when collecting, so it may grow
+        Environment **environment; // the variable, not its value, it may change
+        struct {
+            GC_Root_Function function;
+            void *data;
+        } function;
+    } contents;
+} GC_Root;
+
+static GC_Block *blocks = NULL;
+static GC_Cell *free_list = NULL;
+static GC_Cell **nursery = NULL; // cells allocated since the last collection
+static size_t nursery_length = 0;
+static size_t nursery_allocated_length = GC_NURSERY_LENGTH;
+static size_t old_length = 0;
+static size_t major_threshold = GC_NURSERY_LENGTH * GC_MAJOR_FACTOR;
+static GC_Root *roots = NULL;
+static size_t roots_length = 0;
+static size_t roots_allocated_length = 0;
+static AST_Node **constants = NULL; // kept by gc_keep() until gc_free()
+static size_t constants_length = 0;
+static size_t constants_allocated_length = 0;
+static Environment *environments = NULL; // every live environment, linked by previous and next
+static AST_Node **remembered = NULL; // old vectors changed to hold a nursery value since the last collection
+static size_t remembered_length = 0;
+static size_t remembered_allocated_length = 0;
+static AST_Node **mark_stack = NULL; // marked values whose children are not marked yet
+static size_t mark_stack_length = 0;
+static size_t mark_stack_allocated_length = 0;
+static bool major_marking = false; // whether the running collection is a major one
+static size_t major_epoch = 0; // Environment::mark of the environments reached by the running major collection
+static GC_Stats stats = { 0, 0, 0, 0, 0, 0, 0.0, 0.0 };
+
+static GC_Cell *cell_of(AST_Node *value);
+static GC_Root *root_push(GC_Root_Type type);
+static void mark_roots(void);
+static void mark_remembered(void);
+static void mark_children(void);
+static void mark_held(AST_Node *value);
+static void mark_entry(Hash_Table_Entry *entry, void *aux_data);
+static void sweep_nursery(void);
+static void sweep_all(void);
+static void cell_release(GC_Cell *cell);
+static void value_finalize(AST_Node *value);
+static double now_milliseconds(void);
+
+// a cell for ast_node_new(), may run a collection first, so everything alive must be reachable from the roots
+AST_Node *gc_alloc(void)
+{
+    if (nursery == NULL)
+    {
+        nursery = (GC_Cell **)malloc(sizeof(GC_Cell *) * nursery_allocated_length);
+        if (nursery == NULL)
+        {
+            perror("gc_alloc(): malloc failed");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (nursery_length == nursery_allocated_length) gc_collect(old_length >= major_threshold);
+
+    GC_Cell *cell = free_list;
+    if (cell != NULL)
+    {
+        free_list = cell->next_free;
+    }
+    else
+    {
+        if (blocks == NULL || blocks->used == GC_BLOCK_LENGTH)
+        {
+            GC_Block *block = (GC_Block *)malloc(sizeof(GC_Block));
+            if (block == NULL)
+            {
+                perror("gc_alloc(): malloc failed");
+                exit(EXIT_FAILURE);
+            }
+            block->next = blocks;
+            block->used = 0;
+            blocks = block;
+            stats.heap_bytes += sizeof(GC_Block);
+        }
+        cell = &blocks->cells[blocks->used++];
+    }
+
+    cell->next_free = NULL;
+    cell->in_use = true;
+    cell->old = false;
+    cell->marked = false;
+    cell->remembered = false;
+    nursery[nursery_length++] = cell;
+    stats.bytes_allocated += sizeof(GC_Cell);
+
+    return &cell->node;
+}
+
+// cells allocated between two minor collections, set before the first allocation
+void gc_set_nursery_length(size_t length)
+{
+    if (length == 0) length = 1;
+    if (length < nursery_length) gc_collect(false);
+
+    nursery = (GC_Cell **)realloc(nursery, sizeof(GC_Cell *) * length);
+    if (nursery == NULL)
+    {
+        perror("gc_set_nursery_length(): realloc failed");
+        exit(EXIT_FAILURE);
+    }
+    nursery_allocated_length = length;
+    major_threshold = length * GC_MAJOR_FACTOR;
+}
+
+// values[0, length) are roots until gc_pop(), NULL and immediates are skipped
+void gc_push_values(AST_Node **values, size_t length)
+{
+    GC_Root *root = root_push(VALUES_ROOT);
+    root->contents.values.values = values;
+    root->contents.values.length = length;
+}
+
+// AST_Node *[], its elements are roots until gc_pop()
+void gc_push_vector(Vector *values)
+{
+    GC_Root *root = root_push(VECTOR_ROOT);
+    root->contents.vector = values;
+}
+
+// *env and its parents are roots until gc_pop(), *env may be changed or be NULL
+void gc_push_environment(Environment **env)
+{
+    GC_Root *root = root_push(ENVIRONMENT_ROOT);
+    root->contents.environment = env;
+}
+
+// function(data) is called by every collection until gc_pop()
+void gc_push_root(GC_Root_Function function, void *data)
+{
+    GC_Root *root = root_push(FUNCTION_ROOT);
+    root->contents.function.function = function;
+    root->contents.function.data = data;
+}
+
+// roots are pushed and popped in LIFO order
+// value stays alive until gc_free(), for the shared values of literals in the ast
+void gc_keep(AST_Node *value)
+{
+    if (constants_length == constants_allocated_length)
+    {
+        constants_allocated_length = constants_allocated_length == 0 ? 16 : constants_allocated_length * 2;
+        constants = (AST_Node **)realloc(constants, sizeof(AST_Node *) * constants_allocated_length);
+        if (constants == NULL)
+        {
+            perror("gc_keep(): realloc failed");
+            exit(EXIT_FAILURE);
+        }
+    }
+    constants[constants_length++] = value;
+}
+
+void gc_pop(size_t count)
+{
+    roots_length -= count;
+}
+
+// called by GC_Root_Function
+void gc_mark_value(AST_Node *value)
+{
+    if (value == NULL || value_is_immediate(value) || value->storage != GC_STORAGE) return;
+
+    GC_Cell *cell = cell_of(value);
+    if (cell->marked == true) return;
+    if (cell->old == true && major_marking == false) return; // alive until the next major collection
+
+    cell->marked = true;
+
+    if (mark_stack_length == mark_stack_allocated_length)
+    {
+        mark_stack_allocated_length = mark_stack_allocated_length == 0 ? 256 : mark_stack_allocated_length * 2;
+        mark_stack = (AST_Node **)realloc(mark_stack, sizeof(AST_Node *) * mark_stack_allocated_length);
+        if (mark_stack == NULL)
+        {
+            perror("gc_mark_value(): realloc failed");
+            exit(EXIT_FAILURE);
+        }
+    }
+    mark_stack[mark_stack_length++] = value;
+}
+
+// called by GC_Root_Function, the environment and its parents
+void gc_mark_environment(Environment *env)
+{
+    // a minor collection scans every environment by itself
+    if (major_marking == false) return;
+
+    for (; env != NULL && env->mark != major_epoch; env = env->parent)
+    {
+        env->mark = major_epoch;
+        for (size_t i = 0; i < env->length; i++)
+        {
+            gc_mark_value(env->slots[i]);
+        }
+    }
+}
+
+/*
+    minor: the nursery only, roots are the pushed ones, every slot of every environment and the remembered vectors
+    major: all cells, roots are the pushed ones, environments are traced from them and from closures,
+           so a closure stored in the environment it captured is collected with it
+*/
+void gc_collect(bool major)
+{
+    double start = now_milliseconds();
+
+    major_marking = major;
+    if (major == true) major_epoch++;
+
+    mark_roots();
+    if (major == false)
+    {
+        for (Environment *env = environments; env != NULL; env = env->next)
+        {
+            for (size_t i = 0; i < env->length; i++)
+            {
+                gc_mark_value(env->slots[i]);
+            }
+        }
+    }
+    mark_remembered();
+    mark_children();
+
+    if (major == true)
+    {
+        sweep_all();
+        stats.major_collections++;
+    }
+    else
+    {
+        sweep_nursery();
+        stats.minor_collections++;
+    }
+    nursery_length = 0;
+
+    double pause = now_milliseconds() - start;
+    stats.pause_total += pause;
+    if (pause > stats.pause_max) stats.pause_max = pause;
+}
+
+/*
+    called after value is stored into holder, a vector or a hash table, so that a minor collection finds value through an old holder
+    the holder is remembered until the next collection, by then its nursery values are promoted or it is swept
+*/
+void gc_write_barrier(AST_Node *holder, AST_Node *value)
+{
+    if (value == NULL || value_is_immediate(value) || value->storage != GC_STORAGE || holder->storage != GC_STORAGE) return;
+
+    GC_Cell *cell = cell_of(holder);
+    if (cell->old == false || cell->remembered == true || cell_of(value)->old == true) return;
+
+    if (remembered_length == remembered_allocated_length)
+    {
+        remembered_allocated_length = remembered_allocated_length == 0 ? 64 : remembered_allocated_length * 2;
+        remembered = (AST_Node **)realloc(remembered, sizeof(AST_Node *) * remembered_allocated_length);
+        if (remembered == NULL)
+        {
+            perror("gc_write_barrier(): realloc failed");
+            exit(EXIT_FAILURE);
+        }
+    }
+    cell->remembered = true;
+    remembered[remembered_length++] = holder;
+}
+
+// called by environment_new()
+void gc_track_environment(Environment *env)
+{
+    env->mark = 0;
+    env->previous = NULL;
+    env->next = environments;
+    if (environments != NULL) environments->previous = env;
+    environments = env;
+}
+
+// called when the environment is freed
+void gc_untrack_environment(Environment *env)
+{
+    if (env->previous != NULL) env->previous->next = env->next;
+    else environments = env->next;
+    if (env->next != NULL) env->next->previous = env->previous;
+}
+
+GC_Stats gc_stats(void)
+{
+    return stats;
+}
+
+void gc_print_stats(FILE *stream)
+{
+    fprintf(stream, "gc: minor collections: %zu\n"
+                    "gc: major collections: %zu\n"
+                    "gc: bytes allocated: %zu\n"
+                    "gc: bytes promoted: %zu\n"
+                    "gc: bytes freed: %zu\n"
+                    "gc: heap bytes: %zu\n"
+                    "gc: pause total: %.3f ms\n"
+                    "gc: pause max: %.3f ms\n",
+                    stats.minor_collections, stats.major_collections,
+                    stats.bytes_allocated, stats.bytes_promoted, stats.bytes_freed, stats.heap_bytes,
+                    stats.pause_total, stats.pause_max);
+}
+
+// every value is freed, nothing may be used after this
+int gc_free(void)
+{
+    while (blocks != NULL)
+    {
+        GC_Block *next = blocks->next;
+        for (size_t i = 0; i < blocks->used; i++)
+        {
+            if (blocks->cells[i].in_use == true) value_finalize(&blocks->cells[i].node);
+        }
+        free(blocks);
+        blocks = next;
+    }
+
+    free(nursery);
+    free(roots);
+    free(mark_stack);
+    free(constants);
+    free(remembered);
+    remembered = NULL;
+    remembered_length = remembered_allocated_length = 0;
+    nursery = NULL;
+    roots = NULL;
+    mark_stack = NULL;
+    constants = NULL;
+    free_list = NULL;
+    nursery_length = roots_length = roots_allocated_length = mark_stack_length = mark_stack_allocated_length = 0;
+    constants_length = constants_allocated_length = 0;
+    old_length = 0;
+
+    return 0;
+}
+
+static GC_Cell *cell_of(AST_Node *value)
+{
+    return (GC_Cell *)((char *)value - offsetof(GC_Cell, node));
+}
+
+static GC_Root *root_push(GC_Root_Type type)
+{
+    if (roots_length == roots_allocated_length)
+    {
+        roots_allocated_length = roots_allocated_length == 0 ? 64 : roots_allocated_length * 2;
+        roots = (GC_Root *)realloc(roots, sizeof(GC_Root) * roots_allocated_length);
+        if (roots == NULL)
+        {
+            perror("root_push(): realloc failed");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    GC_Root *root = &roots[roots_length++];
+    root->type = type;
+    return root;
+}
+
+static void mark_roots(void)
+{
+    // promoted after their first collection, so only a major collection traces them again
+    for (size_t i = 0; i < constants_length; i++)
+    {
+        gc_mark_value(constants[i]);
+    }
+
+    for (size_t i = 0; i < roots_length; i++)
+    {
+        GC_Root *root = &roots[i];
+
+        if (root->type == VALUES_ROOT)
+        {
+            for (size_t j = 0; j < root->contents.values.length; j++)
+            {
+                gc_mark_value(root->contents.values.values[j]);
+            }
+        }
+        else if (root->type == VECTOR_ROOT)
+        {
+            Vector *vector = root->contents.vector;
+            for (size_t j = 0; j < VectorLength(vector); j++)
+            {
+                gc_mark_value(*(AST_Node **)VectorNth(vector, j));
+            }
+        }
+        else if (root->type == ENVIRONMENT_ROOT)
+        {
+            gc_mark_environment(*root->contents.environment);
+        }
+        else if (root->type == FUNCTION_ROOT)
+        {
+            root->contents.function.function(root->contents.function.data);
+        }
+    }
+}
+
+// what the remembered holders hold are roots of a minor collection, a major one traces them anyway
+static void mark_remembered(void)
+{
+    for (size_t i = 0; i < remembered_length; i++)
+    {
+        AST_Node *holder = remembered[i];
+        cell_of(holder)->remembered = false;
+        if (major_marking == false) mark_held(holder);
+    }
+    remembered_length = 0;
+}
+
+// values reachable from marked values
+static void mark_children(void)
+{
+    while (mark_stack_length > 0)
+    {
+        mark_held(mark_stack[--mark_stack_length]);
+    }
+}
+
+// pairs, rationals, vectors, hash tables and trie nodes hold values, closures hold environments
+static void mark_held(AST_Node *value)
+{
+    if (value->type == Pair)
+    {
+        gc_mark_value(value->contents.pair.car);
+        gc_mark_value(value->contents.pair.cdr);
+    }
+
+    if (value->type == Rational)
+    {
+        gc_mark_value(value->contents.rational.numerator);
+        gc_mark_value(value->contents.rational.denominator);
+    }
+
+    if (value->type == Racket_Vector)
+    {
+        for (size_t i = 0; i < value->contents.racket_vector.length; i++)
+        {
+            gc_mark_value(value->contents.racket_vector.elements[i]);
+        }
+    }
+
+    if (value->type == Racket_Hash)
+    {
+        if (value->contents.racket_hash.table != NULL) hash_table_for_each(value->contents.racket_hash.table, mark_entry, NULL);
+        gc_mark_value(value->contents.racket_hash.root);
+    }
+
+    if (value->type == Hash_Node)
+    {
+        for (size_t i = 0; i < value->contents.hash_node.length * 2; i++)
+        {
+            gc_mark_value(value->contents.hash_node.slots[i]);
+        }
+    }
+
+    if (value->type == Procedure)
+    {
+        gc_mark_environment(value->contents.procedure.environment);
+    }
+}
+
+static void mark_entry(Hash_Table_Entry *entry, void *aux_data)
+{
+    gc_mark_value(entry->key);
+    gc_mark_value(entry->value);
+}
+
+// marked cells of the nursery are promoted in place, the others are freed
+static void sweep_nursery(void)
+{
+    for (size_t i = 0; i < nursery_length; i++)
+    {
+        GC_Cell *cell = nursery[i];
+
+        if (cell->marked == true)
+        {
+            cell->marked = false;
+            cell->old = true;
+            old_length++;
+            stats.bytes_promoted += sizeof(GC_Cell);
+        }
+        else
+        {
+            cell_release(cell);
+        }
+    }
+}
+
+static void sweep_all(void)
+{
+    old_length = 0;
+
+    for (GC_Block *block = blocks; block != NULL; block = block->next)
+    {
+        for (size_t i = 0; i < block->used; i++)
+        {
+            GC_Cell *cell = &block->cells[i];
+            if (cell->in_use == false) continue;
+
+            if (cell->marked == true)
+            {
+                cell->marked = false;
+                if (cell->old == false) stats.bytes_promoted += sizeof(GC_Cell);
+                cell->old = true;
+                old_length++;
+            }
+            else
+            {
+                cell_release(cell);
+            }
+        }
+    }
+
+    major_threshold = old_length * GC_MAJOR_FACTOR;
+    if (major_threshold < nursery_allocated_length * GC_MAJOR_FACTOR) major_threshold = nursery_allocated_length * GC_MAJOR_FACTOR;
+}
+
+static void cell_release(GC_Cell *cell)
+{
+    value_finalize(&cell->node);
+
+    #if defined(TEST_MODE) || defined(DEBUG_MODE)
+    memset(&cell->node, 0xDB, sizeof(AST_Node)); // a value used after it was collected reads garbage at once
+    #endif
+
+    cell->in_use = false;
+    cell->next_free = free_list;
+    free_list = cell;
+    stats.bytes_freed += sizeof(GC_Cell);
+}
+
+// what a value owns outside its cell, the values it holds are collected by themselves
+static void value_finalize(AST_Node *value)
+{
+    if (value->context != NULL) VectorFree(value->context, NULL, NULL);
+
+    if (value->type == Number_Literal)
+    {
+        free(value->contents.literal.value);
+        free(value->contents.literal.c_native_value);
+    }
+
+    if (value->type == String_Literal ||
+        value->type == Character_Literal ||
+        value->type == Boolean_Literal)
+    {
+        free(value->contents.literal.value);
+    }
+
+    if (value->type == Flvector)
+    {
+        flvector_elements_free(value->contents.flvector.elements);
+    }
+
+    if (value->type == Racket_Vector)
+    {
+        free(value->contents.racket_vector.elements);
+    }
+
+    if (value->type == Racket_Hash)
+    {
+        hash_table_free(value->contents.racket_hash.table);
+    }
+
+    if (value->type == Hash_Node)
+    {
+        free(value->contents.hash_node.slots);
+    }
+
+    if (value->type == Procedure)
+    {
+        free(value->contents.procedure.name);
+        // params and body_exprs are borrowed from the Lambda_Form
+        environment_release(value->contents.procedure.environment);
+    }
+}
+
+static double now_milliseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return TYPECAST(double, now.tv_sec) * 1000.0 + TYPECAST(double, now.tv_nsec) / 1000000.0;
+}
@@ -0,0 +1,288 @@
+#include "../include/global.h"
+#include "../include/hamt.h"
+#include "../include/value.h"
+#include "../include/gc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define HASH_BITS (sizeof(size_t) * 8) // a node deeper than this many bits of hash is a collision node
+#define BRANCH_MASK ((size_t)((1u << HAMT_BITS) - 1))
+
+static AST_Node *node_set(AST_Node *node, AST_Node *key, AST_Node *value, size_t hash, size_t shift, bool *added);
+static AST_Node *node_remove(AST_Node *node, AST_Node *key, size_t hash, size_t shift, bool *removed);
+static AST_Node *node_merge(AST_Node *key1, AST_Node *value1, size_t hash1, AST_Node *key2, AST_Node *value2, size_t hash2, size_t shift);
+static AST_Node *node_replaced(AST_Node *node, size_t i, AST_Node *key, AST_Node *value);
+static AST_Node *node_inserted(AST_Node *node, uint32_t bitmap, size_t i, AST_Node *key, AST_Node *value);
+static AST_Node *node_removed(AST_Node *node, uint32_t bitmap, size_t i);
+static bool is_sub_node(AST_Node *key);
+static size_t bit_count(uint32_t bits);
+
+AST_Node *hamt_get(AST_Node *root, AST_Node *key, bool *found)
+{
+    size_t hash = hash_table_hash(HASH_EQUAL, key);
+    AST_Node *node = root;
+    for (size_t shift = 0; node != NULL; shift += HAMT_BITS)
+    {
+        AST_Node **slots = node->contents.hash_node.slots;
+        uint32_t bitmap = node->contents.hash_node.bitmap;
+        if (bitmap == 0)
+        {
+            for (size_t i = 0; i < node->contents.hash_node.length; i++)
+            {
+                if (value_equal(slots[i * 2], key))
+                {
+                    *found = true;
+                    return slots[i * 2 + 1];
+                }
+            }
+            break;
+        }
+
+        uint32_t bit = TYPECAST(uint32_t, 1u << ((hash >> shift) & BRANCH_MASK));
+        if ((bitmap & bit) == 0) break;
+        size_t i = bit_count(bitmap & (bit - 1));
+        if (is_sub_node(slots[i * 2]))
+        {
+            node = slots[i * 2];
+            continue;
+        }
+        if (value_equal(slots[i * 2], key))
+        {
+            *found = true;
+            return slots[i * 2 + 1];
+        }
+        break;
+    }
+
+    *found = false;
+    return NULL;
+}
+
+AST_Node *hamt_set(AST_Node *root, AST_Node *key, AST_Node *value, bool *added)
+{
+    size_t hash = hash_table_hash(HASH_EQUAL, key);
+    if (root == NULL)
+    {
+        *added = true;
+        AST_Node *node = ast_node_new(NOT_IN_AST, Hash_Node, TYPECAST(uint32_t, 1u << (hash & BRANCH_MASK)), (size_t)1);
+        node->contents.hash_node.slots[0] = key;
+        node->contents.hash_node.slots[1] = value;
+        return node;
+    }
+    return node_set(root, key, value, hash, 0, added);
+}
+
+AST_Node *hamt_remove(AST_Node *root, AST_Node *key, bool *removed)
+{
+    *removed = false;
+    if (root == NULL) return NULL;
+    return node_remove(root, key, hash_table_hash(HASH_EQUAL, key), 0, removed);
+}
+
+void hamt_for_each(AST_Node *root, Hash_Table_Function function, void *aux_data)
+{
+    if (root == NULL) return;
+    AST_Node **slots = root->contents.hash_node.slots;
+    for (size_t i = 0; i < root->contents.hash_node.length; i++)
+    {
+        if (is_sub_node(slots[i * 2]))
+        {
+            hamt_for_each(slots[i * 2], function, aux_data);
+            continue;
+        }
+        Hash_Table_Entry entry = { slots[i * 2], slots[i * 2 + 1], 0 };
+        function(&entry, aux_data);
+    }
+}
+
+// node is not changed, the result is node itself when key already has value
+static AST_Node *node_set(AST_Node *node, AST_Node *key, AST_Node *value, size_t hash, size_t shift, bool *added)
+{
+    AST_Node **slots = node->contents.hash_node.slots;
+    uint32_t bitmap = node->contents.hash_node.bitmap;
+    size_t length = node->contents.hash_node.length;
+    if (bitmap == 0)
+    {
+        for (size_t i = 0; i < length; i++)
+        {
+            if (!value_equal(slots[i * 2], key)) continue;
+            *added = false;
+            if (slots[i * 2 + 1] == value) return node;
+            return node_replaced(node, i, key, value);
+        }
+        *added = true;
+        return node_inserted(node, 0, length, key, value);
+    }
+
+    uint32_t bit = TYPECAST(uint32_t, 1u << ((hash >> shift) & BRANCH_MASK));
+    size_t i = bit_count(bitmap & (bit - 1));
+    if ((bitmap & bit) == 0)
+    {
+        *added = true;
+        return node_inserted(node, bitmap | bit, i, key, value);
+    }
+
+    AST_Node *child = NULL;
+    if (is_sub_node(slots[i * 2]))
+    {
+        child = node_set(slots[i * 2], key, value, hash, shift + HAMT_BITS, added);
+        if (child == slots[i * 2]) return node;
+    }
+    else if (value_equal(slots[i * 2], key))
+    {
+        *added = false;
+        if (slots[i * 2 + 1] == value) return node;
+        return node_replaced(node, i, key, value);
+    }
+    else
+    {
+        *added = true;
+        AST_Node *other = slots[i * 2];
+        child = node_merge(other, slots[i * 2 + 1], hash_table_hash(HASH_EQUAL, other), key, value, hash, shift + HAMT_BITS);
+    }
+
+    gc_push_values(&child, 1);
+    AST_Node *result = node_replaced(node, i, child, NULL);
+    gc_pop(1);
+    return result;
+}
+
+// node itself when key is not in it, NULL when nothing is left
+static AST_Node *node_remove(AST_Node *node, AST_Node *key, size_t hash, size_t shift, bool *removed)
+{
+    AST_Node **slots = node->contents.hash_node.slots;
+    uint32_t bitmap = node->contents.hash_node.bitmap;
+    size_t length = node->contents.hash_node.length;
+    if (bitmap == 0)
+    {
+        for (size_t i = 0; i < length; i++)
+        {
+            if (!value_equal(slots[i * 2], key)) continue;
+            *removed = true;
+            return length == 1 ? NULL : node_removed(node, 0, i);
+        }
+        return node;
+    }
+
+    uint32_t bit = TYPECAST(uint32_t, 1u << ((hash >> shift) & BRANCH_MASK));
+    if ((bitmap & bit) == 0) return node;
+    size_t i = bit_count(bitmap & (bit - 1));
+
+    if (!is_sub_node(slots[i * 2]))
+    {
+        if (!value_equal(slots[i * 2], key)) return node;
+        *removed = true;
+        return length == 1 ? NULL : node_removed(node, bitmap & ~bit, i);
+    }
+
+    AST_Node *child = node_remove(slots[i * 2], key, hash, shift + HAMT_BITS, removed);
+    if (child == slots[i * 2]) return node;
+    if (child == NULL) return length == 1 ? NULL : node_removed(node, bitmap & ~bit, i);
+
+    // a sub-node left with one key is pulled up into this node, so a trie keeps no chain of single entries
+    AST_Node **child_slots = child->contents.hash_node.slots;
+    if (child->contents.hash_node.length == 1 && !is_sub_node(child_slots[0]))
+    {
+        return node_replaced(node, i, child_slots[0], child_slots[1]);
+    }
+    gc_push_values(&child, 1);
+    AST_Node *result = node_replaced(node, i, child, NULL);
+    gc_pop(1);
+    return result;
+}
+
+// a node of two keys which took the same branch of every level above shift
+static AST_Node *node_merge(AST_Node *key1, AST_Node *value1, size_t hash1, AST_Node *key2, AST_Node *value2, size_t hash2, size_t shift)
+{
+    if (shift >= HASH_BITS)
+    {
+        AST_Node *node = ast_node_new(NOT_IN_AST, Hash_Node, (uint32_t)0, (size_t)2);
+        AST_Node **slots = node->contents.hash_node.slots;
+        slots[0] = key1;
+        slots[1] = value1;
+        slots[2] = key2;
+        slots[3] = value2;
+        return node;
+    }
+
+    size_t branch1 = (hash1 >> shift) & BRANCH_MASK;
+    size_t branch2 = (hash2 >> shift) & BRANCH_MASK;
+    if (branch1 == branch2)
+    {
+        AST_Node *child = node_merge(key1, value1, hash1, key2, value2, hash2, shift + HAMT_BITS);
+        gc_push_values(&child, 1);
+        AST_Node *node = ast_node_new(NOT_IN_AST, Hash_Node, TYPECAST(uint32_t, 1u << branch1), (size_t)1);
+        gc_pop(1);
+        node->contents.hash_node.slots[0] = child;
+        node->contents.hash_node.slots[1] = NULL;
+        return node;
+    }
+
+    AST_Node *node = ast_node_new(NOT_IN_AST, Hash_Node, TYPECAST(uint32_t, (1u << branch1) | (1u << branch2)), (size_t)2);
+    AST_Node **slots = node->contents.hash_node.slots;
+    size_t first = branch1 < branch2 ? 0 : 2;
+    slots[first] = key1;
+    slots[first + 1] = value1;
+    slots[2 - first] = key2;
+    slots[3 - first] = value2;
+    return node;
+}
+
+// copies of node, which is held by a rooted trie, the key and value given must be rooted by the caller
+// a new node is young, it needs no write barrier
+static AST_Node *node_replaced(AST_Node *node, size_t i, AST_Node *key, AST_Node *value)
+{
+    size_t length = node->contents.hash_node.length;
+    AST_Node *copy = ast_node_new(NOT_IN_AST, Hash_Node, node->contents.hash_node.bitmap, length);
+    memcpy(copy->contents.hash_node.slots, node->contents.hash_node.slots, sizeof(AST_Node *) * length * 2);
+    copy->contents.hash_node.slots[i * 2] = key;
+    copy->contents.hash_node.slots[i * 2 + 1] = value;
+    return copy;
+}
+
+static AST_Node *node_inserted(AST_Node *node, uint32_t bitmap, size_t i, AST_Node *key, AST_Node *value)
+{
+    size_t length = node->contents.hash_node.length;
+    AST_Node *copy = ast_node_new(NOT_IN_AST, Hash_Node, bitmap, length + 1);
+    AST_Node **slots = node->contents.hash_node.slots;
+    AST_Node **copy_slots = copy->contents.hash_node.slots;
+    memcpy(copy_slots, slots, sizeof(AST_Node *) * i * 2);
+    copy_slots[i * 2] = key;
+    copy_slots[i * 2 + 1] = value;
+    memcpy(&copy_slots[i * 2 + 2], &slots[i * 2], sizeof(AST_Node *) * (length - i) * 2);
+    return copy;
+}
+
+static AST_Node *node_removed(AST_Node *node, uint32_t bitmap, size_t i)
+{
+    size_t length = node->contents.hash_node.length;
+    AST_Node *copy = ast_node_new(NOT_IN_AST, Hash_Node, bitmap, length - 1);
+    AST_Node **slots = node->contents.hash_node.slots;
+    AST_Node **copy_slots = copy->contents.hash_node.slots;
+    memcpy(copy_slots, slots, sizeof(AST_Node *) * i * 2);
+    memcpy(&copy_slots[i * 2], &slots[i * 2 + 2], sizeof(AST_Node *) * (length - i - 1) * 2);
+    return copy;
+}
+
+// keys are values of racket, never a Hash_Node
+static bool is_sub_node(AST_Node *key)
+{
+    return value_is_pointer(key) && key != NULL && key->type == Hash_Node;
+}
+
+static size_t bit_count(uint32_t bits)
+{
+    #if defined(__GNUC__) || defined(__clang__)
+    return TYPECAST(size_t, __builtin_popcount(bits));
+    #else
+    size_t count = 0;
+    for (; bits != 0; bits &= bits - 1)
+    {
+        count++;
+    }
+    return count;
+    #endif
+}
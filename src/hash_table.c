@@ -0,0 +1,240 @@
+#include "../include/global.h"
+#include "../include/hash_table.h"
+#include "../include/value.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define HASH_TABLE_SSE2
+#include <emmintrin.h>
+#endif
+
+#define CONTROL_EMPTY ((signed char)-128) // 0x80, a full slot holds 7 bits of its hash, 0 to 127
+#define CONTROL_DELETED ((signed char)-2) // 0xFE, a lookup goes on past it, an insertion may reuse it
+
+static bool key_equal(Hash_Table *table, AST_Node *a, AST_Node *b);
+static Hash_Table_Entry *table_find(Hash_Table *table, AST_Node *key, size_t hash);
+static size_t table_find_free(Hash_Table *table, size_t hash);
+static void table_allocate(Hash_Table *table, size_t capacity);
+static void table_grow(Hash_Table *table);
+static unsigned int group_match(const signed char *control, signed char byte);
+static unsigned int group_match_free(const signed char *control);
+static unsigned int lowest_bit(unsigned int mask);
+
+Hash_Table *hash_table_new(Hash_Table_Equality equality)
+{
+    Hash_Table *table = (Hash_Table *)malloc(sizeof(Hash_Table));
+    if (table == NULL)
+    {
+        perror("hash_table_new(): malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    table->equality = equality;
+    table->length = 0;
+    table_allocate(table, HASH_TABLE_GROUP);
+    return table;
+}
+
+void hash_table_free(Hash_Table *table)
+{
+    if (table == NULL) return;
+    free(table->control);
+    free(table->entries);
+    free(table);
+}
+
+Hash_Table_Entry *hash_table_get(Hash_Table *table, AST_Node *key)
+{
+    return table_find(table, key, hash_table_hash(table->equality, key));
+}
+
+void hash_table_set(Hash_Table *table, AST_Node *key, AST_Node *value)
+{
+    size_t hash = hash_table_hash(table->equality, key);
+    Hash_Table_Entry *entry = table_find(table, key, hash);
+    if (entry != NULL)
+    {
+        entry->value = value;
+        return;
+    }
+
+    size_t slot = table_find_free(table, hash);
+    if (table->control[slot] == CONTROL_EMPTY && table->growth_left == 0)
+    {
+        table_grow(table);
+        slot = table_find_free(table, hash);
+    }
+
+    if (table->control[slot] == CONTROL_EMPTY) table->growth_left--;
+    table->control[slot] = (signed char)(hash & 0x7F);
+    table->entries[slot] = (Hash_Table_Entry){ key, value, hash };
+    table->length++;
+}
+
+bool hash_table_remove(Hash_Table *table, AST_Node *key)
+{
+    Hash_Table_Entry *entry = hash_table_get(table, key);
+    if (entry == NULL) return false;
+
+    // every lookup which reaches a group with an empty slot stops there, so no key behind it needs a tombstone
+    size_t slot = TYPECAST(size_t, entry - table->entries);
+    const signed char *control = &table->control[slot / HASH_TABLE_GROUP * HASH_TABLE_GROUP];
+    if (group_match(control, CONTROL_EMPTY) != 0)
+    {
+        table->control[slot] = CONTROL_EMPTY;
+        table->growth_left++;
+    }
+    else
+    {
+        table->control[slot] = CONTROL_DELETED;
+    }
+    entry->key = NULL;
+    entry->value = NULL;
+    table->length--;
+    return true;
+}
+
+void hash_table_for_each(Hash_Table *table, Hash_Table_Function function, void *aux_data)
+{
+    for (size_t i = 0; i < table->capacity; i++)
+    {
+        if (table->control[i] >= 0) function(&table->entries[i], aux_data);
+    }
+}
+
+// mixed so that every bit of the result, such as the 7 bits of a control byte, varies with every bit of the key
+size_t hash_table_hash(Hash_Table_Equality equality, AST_Node *key)
+{
+    uint64_t hash = equality == HASH_EQ ? value_bits(key) : TYPECAST(uint64_t, value_hash(key));
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+    hash ^= hash >> 33;
+    return TYPECAST(size_t, hash);
+}
+
+static bool key_equal(Hash_Table *table, AST_Node *a, AST_Node *b)
+{
+    if (table->equality == HASH_EQ) return a == b;
+    return value_equal(a, b);
+}
+
+static Hash_Table_Entry *table_find(Hash_Table *table, AST_Node *key, size_t hash)
+{
+    signed char h2 = (signed char)(hash & 0x7F);
+    size_t groups_mask = table->capacity / HASH_TABLE_GROUP - 1;
+    size_t group = (hash >> 7) & groups_mask;
+
+    // triangular steps visit every group of a power of 2, and growth_left keeps one empty slot at least
+    for (size_t step = 1; ; step++)
+    {
+        const signed char *control = &table->control[group * HASH_TABLE_GROUP];
+        for (unsigned int match = group_match(control, h2); match != 0; match &= match - 1)
+        {
+            Hash_Table_Entry *entry = &table->entries[group * HASH_TABLE_GROUP + lowest_bit(match)];
+            if (entry->hash == hash && key_equal(table, entry->key, key)) return entry;
+        }
+        if (group_match(control, CONTROL_EMPTY) != 0) return NULL;
+        group = (group + step) & groups_mask;
+    }
+}
+
+// the first empty or deleted slot on the probe sequence of hash
+static size_t table_find_free(Hash_Table *table, size_t hash)
+{
+    size_t groups_mask = table->capacity / HASH_TABLE_GROUP - 1;
+    size_t group = (hash >> 7) & groups_mask;
+
+    for (size_t step = 1; ; step++)
+    {
+        unsigned int match = group_match_free(&table->control[group * HASH_TABLE_GROUP]);
+        if (match != 0) return group * HASH_TABLE_GROUP + lowest_bit(match);
+        group = (group + step) & groups_mask;
+    }
+}
+
+static void table_allocate(Hash_Table *table, size_t capacity)
+{
+    table->control = (signed char *)aligned_alloc(HASH_TABLE_GROUP, capacity);
+    table->entries = (Hash_Table_Entry *)malloc(sizeof(Hash_Table_Entry) * capacity);
+    if (table->control == NULL || table->entries == NULL)
+    {
+        perror("table_allocate(): malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    memset(table->control, CONTROL_EMPTY, capacity);
+    table->capacity = capacity;
+    table->growth_left = capacity - capacity / 8;
+}
+
+// doubles the capacity, or only drops the tombstones when they took the room
+static void table_grow(Hash_Table *table)
+{
+    signed char *control = table->control;
+    Hash_Table_Entry *entries = table->entries;
+    size_t capacity = table->capacity;
+
+    table_allocate(table, (table->length + 1) * 16 > capacity * 7 ? capacity * 2 : capacity);
+    for (size_t i = 0; i < capacity; i++)
+    {
+        if (control[i] < 0) continue;
+        size_t slot = table_find_free(table, entries[i].hash);
+        table->control[slot] = control[i];
+        table->entries[slot] = entries[i];
+        table->growth_left--;
+    }
+
+    free(control);
+    free(entries);
+}
+
+// bit i is set when control[i] is byte
+static unsigned int group_match(const signed char *control, signed char byte)
+{
+    #ifdef HASH_TABLE_SSE2
+    __m128i group = _mm_load_si128((const __m128i *)control);
+    return TYPECAST(unsigned int, _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(byte))));
+    #else
+    unsigned int match = 0;
+    for (size_t i = 0; i < HASH_TABLE_GROUP; i++)
+    {
+        if (control[i] == byte) match |= 1u << i;
+    }
+    return match;
+    #endif
+}
+
+// bit i is set when control[i] is empty or deleted, the only bytes with the sign bit
+static unsigned int group_match_free(const signed char *control)
+{
+    #ifdef HASH_TABLE_SSE2
+    return TYPECAST(unsigned int, _mm_movemask_epi8(_mm_load_si128((const __m128i *)control)));
+    #else
+    unsigned int match = 0;
+    for (size_t i = 0; i < HASH_TABLE_GROUP; i++)
+    {
+        if (control[i] < 0) match |= 1u << i;
+    }
+    return match;
+    #endif
+}
+
+// mask is not 0
+static unsigned int lowest_bit(unsigned int mask)
+{
+    #if defined(__GNUC__) || defined(__clang__)
+    return TYPECAST(unsigned int, __builtin_ctz(mask));
+    #else
+    unsigned int i = 0;
+    while ((mask & 1u) == 0)
+    {
+        mask >>= 1;
+        i++;
+    }
+    return i;
+    #endif
+}
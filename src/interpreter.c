@@ -1,5 +1,14 @@
 #include "../include/global.h"
 #include "../include/interpreter.h"
+#include "../include/environment.h"
+#include "../include/arena.h"
+#include "../include/gc.h"
+#include "../include/vm.h"
+#include "../include/value.h"
+#include "../include/number.h"
+#include "../include/format.h"
+#include "../include/hash_table.h"
+#include "../include/hamt.h"
 #include "../include/parser.h"
 #include "../include/racket_built_in.h"
 #include "../include/addon.h"
@@ -8,15 +17,36 @@
 #include <string.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdio.h>
+
+typedef struct _z_scope Scope;
+typedef struct _z_scope {
+    Scope *parent;
+    Vector *context; // AST_Node *(type: Binding)[], the layout of the environment
+    Symbol_Table *table; // only the global scope has it, local scopes are small enough to scan
+    size_t visible_length; // let*: an init value only sees the bindings before it
+} Scope;
+
+// temporaries of evaluating a top level form, such as the operands of a call, reset by calculator() after every form
+static Arena *scratch = NULL;
 
 static AST_Node *find_contextable_node(AST_Node *current_node);
-static AST_Node *search_binding_value(AST_Node *binding);
 static int result_free(Result result);
 static void output_result(Result result, void *aux_data);
-static void *context_simple_copy_helper(void *value_addr, size_t index, Vector *original_vector, Vector *new_vector, void *aux_data);
-static void middle_thing_free_helper(void *value_addr, size_t index, Vector *vector, void *aux_data);
-static int middle_thing_free(AST_Node *ast_node, void *aux_data);
+static void output_hash_entry(Hash_Table_Entry *entry, void *aux_data);
+static void output_number(AST_Node *number);
+static AST_Node *eval_leading_body(Vector *body_exprs, Environment *env, void *aux_data);
+static long context_index(Vector *context, Symbol_Table *table, const unsigned char *name, size_t visible_length);
+static Lexical_Address scope_lookup(Scope *scope, const unsigned char *name);
+static void resolve_addresses_helper(AST_Node *node, Scope *scope);
+static void resolve_body(Vector *body_exprs, Scope *scope);
 
+/*
+    set parent for every node, and record the layout of environments into context
+    Program: built-in bindings, addon bindings and top level defines
+    Lambda_Form: params and the defines in its body
+    let, let*, letrec: bindings and the defines in its body
+*/
 void generate_context(AST_Node *node, AST_Node *parent, void *aux_data)
 {
     node->parent = parent;
@@ -35,6 +65,8 @@ void generate_context(AST_Node *node, AST_Node *parent, void *aux_data)
             AST_Node *binding = *(AST_Node **)VectorNth(built_in_bindings, i);
             generate_context(binding, node, aux_data); // generate context for built-in bindings
             VectorAppend(node->contents.program.built_in_bindings, &binding);
+            VectorAppend(node->context, &binding);
+            symbol_table_set(node->contents.program.global_table, binding->contents.binding.name, VectorLength(node->context) - 1);
         }
         free_built_in_bindings(built_in_bindings, NULL); // free 'built_in_bindings' itself only
 
@@ -44,6 +76,8 @@ void generate_context(AST_Node *node, AST_Node *parent, void *aux_data)
             AST_Node *binding = *(AST_Node **)VectorNth(addon_bindings, i);
             generate_context(binding, node, aux_data);
             VectorAppend(node->contents.program.addon_bindings, &binding);
+            VectorAppend(node->context, &binding);
+            symbol_table_set(node->contents.program.global_table, binding->contents.binding.name, VectorLength(node->context) - 1);
         }
         free_addon_bindings(addon_bindings, NULL); // free 'addon_bindings' itself only
 
@@ -69,146 +103,34 @@ void generate_context(AST_Node *node, AST_Node *parent, void *aux_data)
             }
             else
             {
-                VectorAppend(contextable->context, &binding);
-            } 
-            generate_context(binding, node, aux_data);
-        }
-
-        if (node->contents.local_binding_form.type == LET)
-        {
-            Vector *bindings = node->contents.local_binding_form.contents.lets.bindings;
-            Vector *body_exprs = node->contents.local_binding_form.contents.lets.body_exprs;
-
-            for (size_t i = 0; i < VectorLength(bindings); i++)
-            {
-                AST_Node *binding = *(AST_Node **)VectorNth(bindings, i);
-                generate_context(binding, node, aux_data);
-            }
-
-            // append bindings to every expr in body_exprs, even a Number_Literal ast node
-            for (size_t i = 0; i < VectorLength(body_exprs); i++)
-            {
-                AST_Node *body_expr = *(AST_Node **)VectorNth(body_exprs, i); 
-                if (body_expr->context == NULL)
-                {
-                    body_expr->context = VectorNew(sizeof(AST_Node *));
-                }
-                for(size_t j = 0; j < VectorLength(bindings); j++)
-                {
-                    AST_Node *binding = *(AST_Node **)VectorNth(bindings, j);
-                    VectorAppend(body_expr->context, &binding);
-                }
-            }
-
-            for (size_t i = 0; i < VectorLength(body_exprs); i++)
-            {
-                AST_Node *body_expr = *(AST_Node **)VectorNth(body_exprs, i);
-                generate_context(body_expr, node, aux_data);
-            }
-        }
-
-        if (node->contents.local_binding_form.type == LET_STAR)
-        {
-            Vector *bindings = node->contents.local_binding_form.contents.lets.bindings;
-            Vector *body_exprs = node->contents.local_binding_form.contents.lets.body_exprs;
-            
-            for (size_t i = 0; i < VectorLength(bindings) - 1; i++)
-            {
-                AST_Node *nxt_binding = *(AST_Node **)VectorNth(bindings, i + 1);
-                AST_Node *value = nxt_binding->contents.binding.value;
-                if (value->context == NULL)
-                {
-                    value->context = VectorNew(sizeof(AST_Node *));
-                }
-                for (size_t j = 0; j < i + 1; j++)
-                {
-                    AST_Node *binding = *(AST_Node **)VectorNth(bindings, j);
-                    VectorAppend(value->context, &binding);
-                }
-            }
-
-            for (size_t i = 0; i < VectorLength(bindings); i++)
-            {
-                AST_Node *binding = *(AST_Node **)VectorNth(bindings, i);
-                generate_context(binding, node, aux_data);
-            }
- 
-            // append bindings to every expr in body_exprs, even a Number_Literal ast node
-            for (size_t i = 0; i < VectorLength(body_exprs); i++)
-            {
-                AST_Node *body_expr = *(AST_Node **)VectorNth(body_exprs, i); 
-                if (body_expr->context == NULL)
-                {
-                    body_expr->context = VectorNew(sizeof(AST_Node *));
-                }
-                for(size_t j = 0; j < VectorLength(bindings); j++)
+                // define the same name again works on the same slot
+                Symbol_Table *table = contextable->type == Program ? contextable->contents.program.global_table : NULL;
+                if (context_index(contextable->context, table, binding->contents.binding.name, VectorLength(contextable->context)) == -1)
                 {
-                    AST_Node *binding = *(AST_Node **)VectorNth(bindings, j);
-                    VectorAppend(body_expr->context, &binding);
+                    VectorAppend(contextable->context, &binding);
+                    if (table != NULL) symbol_table_set(table, binding->contents.binding.name, VectorLength(contextable->context) - 1);
                 }
-            }
-
-            for (size_t i = 0; i < VectorLength(body_exprs); i++)
-            {
-                AST_Node *body_expr = *(AST_Node **)VectorNth(body_exprs, i);
-                generate_context(body_expr, node, aux_data);
-            }
+            } 
+            generate_context(binding, node, aux_data);
         }
 
-        if (node->contents.local_binding_form.type == LETREC)
+        if (node->contents.local_binding_form.type == LET ||
+            node->contents.local_binding_form.type == LET_STAR ||
+            node->contents.local_binding_form.type == LETREC)
         {
             Vector *bindings = node->contents.local_binding_form.contents.lets.bindings;
             Vector *body_exprs = node->contents.local_binding_form.contents.lets.body_exprs;
 
-            if (VectorLength(bindings) == 1)
-            {
-                AST_Node *single_binding = *(AST_Node **)VectorNth(bindings, 0);
-                AST_Node *value = single_binding->contents.binding.value;
-
-                if (value->context == NULL)
-                {
-                    value->context = VectorNew(sizeof(AST_Node *));
-                }
-
-                VectorAppend(value->context, &single_binding);
-            }
-
-            for (size_t i = 0; i < VectorLength(bindings) - 1; i++)
+            if (node->context == NULL)
             {
-                AST_Node *nxt_binding = *(AST_Node **)VectorNth(bindings, i + 1);
-                AST_Node *value = nxt_binding->contents.binding.value;
-
-                if (value->context == NULL)
-                {
-                    value->context = VectorNew(sizeof(AST_Node *));
-                }
-                
-                for (size_t j = 0; j <= i + 1; j++)
-                {
-                    AST_Node *binding = *(AST_Node **)VectorNth(bindings, j);
-                    VectorAppend(value->context, &binding);
-                }
+                node->context = VectorNew(sizeof(AST_Node *));
             }
 
             for (size_t i = 0; i < VectorLength(bindings); i++)
             {
                 AST_Node *binding = *(AST_Node **)VectorNth(bindings, i);
+                VectorAppend(node->context, &binding);
                 generate_context(binding, node, aux_data);
-            } 
-
-            // append bindings to every expr in body_exprs, even a Number_Literal ast node
-            for (size_t i = 0; i < VectorLength(body_exprs); i++)
-            {
-                AST_Node *body_expr = *(AST_Node **)VectorNth(body_exprs, i); 
-                if (body_expr->context == NULL)
-                {
-                    body_expr->context = VectorNew(sizeof(AST_Node *));
-                }
-                for(size_t j = 0; j < VectorLength(bindings); j++)
-                {
-                    AST_Node *binding = *(AST_Node **)VectorNth(bindings, j);
-                    VectorAppend(body_expr->context, &binding);
-                }
             }
 
             for (size_t i = 0; i < VectorLength(body_exprs); i++)
@@ -283,7 +205,6 @@ void generate_context(AST_Node *node, AST_Node *parent, void *aux_data)
         if (cond_clause_type == TEST_EXPR_WITH_THENBODY)
         {
             // [test-expr then-body ...+]
-            // needs to free test_expr and then_bodies
             AST_Node *test_expr = node->contents.cond_clause.test_expr;
             generate_context(test_expr, node, aux_data);
 
@@ -297,7 +218,6 @@ void generate_context(AST_Node *node, AST_Node *parent, void *aux_data)
         else if (cond_clause_type == ELSE_STATEMENT)
         {
             // [else then-body ...+]
-            // needs to free then_bodies
             Vector *then_bodies = node->contents.cond_clause.then_bodies;
             for (size_t i = 0; i < VectorLength(then_bodies); i++)
             {
@@ -321,6 +241,12 @@ void generate_context(AST_Node *node, AST_Node *parent, void *aux_data)
 
     if (node->type == Call_Expression)
     {
+        AST_Node *anonymous_procedure = node->contents.call_expression.anonymous_procedure;
+        if (anonymous_procedure != NULL && anonymous_procedure->type == Lambda_Form)
+        {
+            generate_context(anonymous_procedure, node, aux_data);
+        }
+
         Vector *params = node->contents.call_expression.params;
         for (size_t i = 0; i < VectorLength(params); i++)
         {
@@ -342,25 +268,16 @@ void generate_context(AST_Node *node, AST_Node *parent, void *aux_data)
         Vector *params = node->contents.lambda_form.params;
         Vector *body_exprs = node->contents.lambda_form.body_exprs;
 
-        for (size_t i = 0; i < VectorLength(params); i++)
+        if (node->context == NULL)
         {
-            AST_Node *param = *(AST_Node **)VectorNth(params, i);
-            generate_context(param, node, aux_data);
+            node->context = VectorNew(sizeof(AST_Node *));
         }
 
-        // append param to every expr in body_exprs, even a Number_Literal ast node
-        for (size_t i = 0; i < VectorLength(body_exprs); i++)
+        for (size_t i = 0; i < VectorLength(params); i++)
         {
-            AST_Node *body_expr = *(AST_Node **)VectorNth(body_exprs, i); 
-            if (body_expr->context == NULL)
-            {
-                body_expr->context = VectorNew(sizeof(AST_Node *));
-            }
-            for(size_t j = 0; j < VectorLength(params); j++)
-            {
-                AST_Node *param = *(AST_Node **)VectorNth(params, j);
-                VectorAppend(body_expr->context, &param);
-            }
+            AST_Node *param = *(AST_Node **)VectorNth(params, i);
+            VectorAppend(node->context, &param);
+            generate_context(param, node, aux_data);
         }
 
         for (size_t i = 0; i < VectorLength(body_exprs); i++)
@@ -372,45 +289,8 @@ void generate_context(AST_Node *node, AST_Node *parent, void *aux_data)
 
     if (node->type == Procedure)
     {
-        // built-in procedure
-        if (node->contents.procedure.c_native_function != NULL)
-        {
-
-        }
-
-        // programmer defined procedure
-        if (node->contents.procedure.c_native_function == NULL)
-        {
-            Vector *params = node->contents.procedure.params;
-            Vector *body_exprs = node->contents.procedure.body_exprs;
-
-            for (size_t i = 0; i < VectorLength(params); i++)
-            {
-                AST_Node *param = *(AST_Node **)VectorNth(params, i);
-                generate_context(param, node, aux_data);
-            }
-
-            // append param to every expr in body_exprs, even a Number_Literal ast node
-            for (size_t i = 0; i < VectorLength(body_exprs); i++)
-            {
-                AST_Node *body_expr = *(AST_Node **)VectorNth(body_exprs, i); 
-                if (body_expr->context == NULL)
-                {
-                    body_expr->context = VectorNew(sizeof(AST_Node *));
-                }
-                for(size_t j = 0; j < VectorLength(params); j++)
-                {
-                    AST_Node *param = *(AST_Node **)VectorNth(params, j);
-                    VectorAppend(body_expr->context, &param);
-                }
-            }
-
-            for (size_t i = 0; i < VectorLength(body_exprs); i++)
-            {
-                AST_Node *body_expr = *(AST_Node **)VectorNth(body_exprs, i);
-                generate_context(body_expr, node, aux_data);
-            } 
-        }
+        // procedures only appear at runtime, their params and body_exprs belong to a Lambda_Form
+        return;
     }
     
     if (node->type == Number_Literal ||
@@ -448,7 +328,7 @@ void generate_context(AST_Node *node, AST_Node *parent, void *aux_data)
         }
     }
 
-    if (node->type == Pair_Literal)
+    if (node->type == Pair_Literal || node->type == Vector_Literal)
     {
         // same situation with List_Literal
         Vector *elems = (Vector *)node->contents.literal.value;
@@ -461,716 +341,541 @@ void generate_context(AST_Node *node, AST_Node *parent, void *aux_data)
 }
 
 /*
-    return NULL or NOT_IN_AST(return copy of the original one) or Procedure(procedure return itself)
-    this function will make some ast_node not in ast, should be free manually
+    turn every identifier into a Lexical_Address after generate_context(), so eval() and vm_run() never search names
+    a scope is the context of a node which creates an environment at runtime, depth counts the scopes in between
+*/
+void resolve_addresses(AST ast, void *aux_data)
+{
+    Scope global = { NULL, ast->context, ast->contents.program.global_table, VectorLength(ast->context) };
+
+    Vector *body = ast->contents.program.body;
+    for (size_t i = 0; i < VectorLength(body); i++)
+    {
+        AST_Node *sub_node = *(AST_Node **)VectorNth(body, i);
+        resolve_addresses_helper(sub_node, &global);
+    }
+}
+
+/*
+    return NULL, an immediate, or a value of the collector which may be shared, such as a closure or a list held by an environment
+    env is the environment which the ast_node is evaluated against, the ast itself is never changed
+    env is kept alive and reachable by the caller, frame and the temporaries of this eval() are pushed as gc roots
+    tail positions (if, cond, and, or, let bodies, procedure bodies) don't call eval() again,
+    they replace ast_node and env and go on with the loop, so the C stack stays constant
 */
-Result eval(AST_Node *ast_node, void *aux_data)
+Result eval(AST_Node *ast_node, Environment *env, void *aux_data)
 {
-    if (ast_node == NULL) return NULL;
     Result result = NULL;
-    bool matched = false;
+    Environment *frame = NULL; // created by this eval() for the current tail position, released before return
+    gc_push_environment(&frame);
 
-    if (ast_node->type == Call_Expression)
+    for (;;)
     {
-        matched = true;
-        
-        const unsigned char *name = ast_node->contents.call_expression.name;
-        AST_Node *anonymous_procedure = ast_node->contents.call_expression.anonymous_procedure;
-        AST_Node *procedure = NULL;
+        if (ast_node == NULL) break;
+        if (value_is_immediate(ast_node) || ast_node->storage == GC_STORAGE)
+        {
+            // values are values already
+            result = ast_node;
+            break;
+        }
+
+        bool matched = false;
+        AST_Node *tail_expr = NULL; // evaluated by the next round of the loop
 
-        // directly anonymous procedure call see in map function impl, or ((lambda (x) x) 1) need to eval out
-        if (name == NULL && anonymous_procedure != NULL)
+        if (ast_node->type == Call_Expression)
         {
-            if (anonymous_procedure->type == Lambda_Form)
+            matched = true;
+            
+            const unsigned char *name = ast_node->contents.call_expression.name;
+            AST_Node *anonymous_procedure = ast_node->contents.call_expression.anonymous_procedure;
+            AST_Node *procedure = NULL;
+
+            // a procedure value called directly, or ((lambda (x) x) 1) need to eval out
+            if (name == NULL && anonymous_procedure != NULL)
             {
-                procedure = eval(anonymous_procedure, aux_data);
-                generate_context(procedure, ast_node, NULL);
-                ast_node->contents.call_expression.anonymous_procedure = procedure;
-                ast_node_free(anonymous_procedure);
+                if (anonymous_procedure->type == Lambda_Form)
+                {
+                    procedure = eval(anonymous_procedure, env, aux_data);
+                }
+                else if (anonymous_procedure->type == Procedure)
+                {
+                    // a procedure value put in the ast
+                    procedure = anonymous_procedure;
+                }
             }
-            else if (anonymous_procedure->type == Procedure)
+            // named procedure call
+            else if (name != NULL && anonymous_procedure == NULL)
             {
-                // map
-                procedure = anonymous_procedure;
+                procedure = lookup_value(env, ast_node->contents.call_expression.address, name);
             }
-        }
-        // named procedure call
-        else if (name != NULL && anonymous_procedure == NULL)
-        {
-            AST_Node *binding = ast_node_new(NOT_IN_AST, Binding, name, NULL);
-            generate_context(binding, ast_node, NULL);
-            AST_Node *binding_contains_value = search_binding_value(binding);
-            ast_node_free(binding); // free the tmp binding
-
-            if (binding_contains_value == NULL)
+            
+            if (procedure == NULL)
             {
-                fprintf(stderr, "eval(): unbound identifier: %s\n", name);
+                fprintf(stderr, "eval(): call expression error\n");
                 exit(EXIT_FAILURE);
             }
 
-            procedure = binding_contains_value->contents.binding.value;
-        }
-        else {
-            fprintf(stderr, "eval(): call expression error\n");
-            exit(EXIT_FAILURE);
-        }
-
-        if (procedure->type != Procedure)
-        {
-            fprintf(stderr, "eval(): not a procedure: %s\n", name);
-            exit(EXIT_FAILURE); 
-        }
-
-        // built-in or addon procedure
-        if (procedure->contents.procedure.c_native_function != NULL)
-        {
-            Vector *params = ast_node->contents.call_expression.params;
-            Vector *operands = VectorNew(sizeof(AST_Node *));
-
-            // eval out operands
-            for (size_t i = 0; i < VectorLength(params); i++)
+            if (value_type(procedure) != Procedure)
             {
-                AST_Node *param = *(AST_Node **)VectorNth(params, i);
-                AST_Node *operand = eval(param, aux_data);
-                VectorAppend(operands, &operand);
+                fprintf(stderr, "eval(): not a procedure: %s\n", name);
+                exit(EXIT_FAILURE); 
             }
 
-            Function c_native_function = procedure->contents.procedure.c_native_function;
-            result = ((AST_Node *(*)(AST_Node *procedure, Vector *operands))c_native_function)(procedure, operands);
-
-            VectorFree(operands, middle_thing_free_helper, NULL);
-        }
-
-        // programmer defined procedure
-        if (procedure->contents.procedure.c_native_function == NULL)
-        {
             Vector *params = ast_node->contents.call_expression.params;
-            Vector *operands = VectorNew(sizeof(AST_Node *)); 
+            size_t operands_count = VectorLength(params);
 
-            // eval out operands
-            for (size_t i = 0; i < VectorLength(params); i++)
+            // (+ a b), (= n 0): two operands go straight to the fixed-arity entry point of a built-in, no operand array is made
+            if (operands_count == 2 && procedure->contents.procedure.c_native_binary_function != NULL)
             {
-                AST_Node *param = *(AST_Node **)VectorNth(params, i);
-                AST_Node *operand = eval(param, aux_data);
-                VectorAppend(operands, &operand);
+                AST_Node *roots[3] = { procedure, NULL, NULL };
+                gc_push_values(roots, 3);
+                roots[1] = eval(*(AST_Node **)VectorNth(params, 0), env, aux_data);
+                roots[2] = eval(*(AST_Node **)VectorNth(params, 1), env, aux_data);
+
+                Function c_native_binary_function = procedure->contents.procedure.c_native_binary_function;
+                result = ((AST_Node *(*)(AST_Node *procedure, AST_Node *a, AST_Node *b))c_native_binary_function)(procedure, roots[1], roots[2]);
+                gc_pop(1);
             }
-
-            // check arity
-            size_t required_params_count = procedure->contents.procedure.required_params_count;
-            size_t operands_count = VectorLength(operands);
-            if (operands_count != required_params_count)
+            else
             {
-                if (procedure->contents.procedure.name == NULL)
+                // eval out operands
+                // they only live during the call, so they are kept in the scratch arena and released after it, nested calls release first
+                // the procedure goes first, ((lambda (x) x) 1) is held by nothing else, and everything is a gc root until the call
+                Arena_Mark mark = arena_mark(scratch);
+                AST_Node **roots = (AST_Node **)arena_alloc(scratch, sizeof(AST_Node *) * (operands_count + 1));
+                AST_Node **operands_array = roots + 1;
+                roots[0] = procedure;
+                for (size_t i = 0; i < operands_count; i++) operands_array[i] = NULL;
+                gc_push_values(roots, operands_count + 1);
+
+                for (size_t i = 0; i < operands_count; i++)
                 {
-                    fprintf(stderr, "anomyous procedure: arity mismatch;\n"
-                                    "the expected number of arguments does not match the given number\n"
-                                    "expected: %zu\n"
-                                    "given: %zu\n", required_params_count, operands_count);
-                    exit(EXIT_FAILURE); 
-                }
-                else if (procedure->contents.procedure.name != NULL)
-                {
-                    fprintf(stderr, "%s: arity mismatch;\n"
-                                    "the expected number of arguments does not match the given number\n"
-                                    "expected: %zu\n"
-                                    "given: %zu\n", procedure->contents.procedure.name, required_params_count, operands_count);
-                    exit(EXIT_FAILURE); 
+                    AST_Node *param = *(AST_Node **)VectorNth(params, i);
+                    operands_array[i] = eval(param, env, aux_data);
                 }
-            }
+                Vector operands_vector = { operands_array, sizeof(AST_Node *), operands_count, operands_count };
+                Vector *operands = &operands_vector;
 
-            // generate a environment for every function call
-            Vector *virtual_params = procedure->contents.procedure.params;
-            Vector *body_exprs = procedure->contents.procedure.body_exprs;
+                // built-in or addon procedure
+                if (procedure->contents.procedure.c_native_function != NULL)
+                {
+                    Function c_native_function = procedure->contents.procedure.c_native_function;
+                    result = ((AST_Node *(*)(AST_Node *procedure, Vector *operands))c_native_function)(procedure, operands);
 
-            Vector *virtual_params_copy = VectorNew(sizeof(AST_Node *));
-            Vector *body_exprs_copy = VectorNew(sizeof(AST_Node *));
-            
-            for (size_t i = 0; i < VectorLength(virtual_params); i++)
-            {
-                AST_Node *virtual_param = *(AST_Node **)VectorNth(virtual_params, i);
-                AST_Node *virtual_param_copy = ast_node_deep_copy(virtual_param, aux_data);
-                ast_node_set_tag_recursive(virtual_param_copy, NOT_IN_AST);
+                    gc_pop(1);
+                    arena_release(scratch, mark);
+                }
 
-                if (virtual_param->context != NULL)
+                // programmer defined procedure
+                else if (procedure->contents.procedure.c_native_function == NULL)
                 {
-                    virtual_param_copy->context = VectorCopy(virtual_param->context, context_simple_copy_helper, NULL);
-                }
+                    // check arity
+                    size_t required_params_count = procedure->contents.procedure.required_params_count;
+                    if (operands_count != required_params_count)
+                    {
+                        if (procedure->contents.procedure.name == NULL)
+                        {
+                            fprintf(stderr, "anomyous procedure: arity mismatch;\n"
+                                            "the expected number of arguments does not match the given number\n"
+                                            "expected: %zu\n"
+                                            "given: %zu\n", required_params_count, operands_count);
+                            exit(EXIT_FAILURE); 
+                        }
+                        else if (procedure->contents.procedure.name != NULL)
+                        {
+                            fprintf(stderr, "%s: arity mismatch;\n"
+                                            "the expected number of arguments does not match the given number\n"
+                                            "expected: %zu\n"
+                                            "given: %zu\n", procedure->contents.procedure.name, required_params_count, operands_count);
+                            exit(EXIT_FAILURE); 
+                        }
+                    }
 
-                generate_context(virtual_param_copy, virtual_param->parent, NULL);
-                VectorAppend(virtual_params_copy, &virtual_param_copy);
+                    // one environment for every function call, holds the operands in the first slots, the body is shared
+                    Environment *inner = environment_new(procedure->contents.procedure.environment, procedure->contents.procedure.frame_length);
+                    for (size_t i = 0; i < operands_count; i++)
+                    {
+                        inner->slots[i] = operands_array[i];
+                    }
+                    gc_pop(1);
+                    arena_release(scratch, mark); // operands are held by inner now
+
+                    // the environment of the last tail position is not needed anymore
+                    // inner keeps the closure's environment, body_exprs belongs to the Lambda_Form
+                    environment_release(frame);
+                    env = frame = inner;
+                    tail_expr = eval_leading_body(procedure->contents.procedure.body_exprs, env, aux_data);
+                }
             }
+        }
+        
+        if (ast_node->type == Local_Binding_Form)
+        {
+            Local_Binding_Form_Type local_binding_form_type = ast_node->contents.local_binding_form.type;
 
-            for (size_t i = 0; i < VectorLength(body_exprs); i++)
+            if (local_binding_form_type == DEFINE)
             {
-                AST_Node *body_expr = *(AST_Node **)VectorNth(body_exprs, i);
-                AST_Node *body_expr_copy = ast_node_deep_copy(body_expr, aux_data);
-                ast_node_set_tag_recursive(body_expr_copy, NOT_IN_AST);
-
-                // body_expr must have context includes params in procedure
-                if (body_expr->context == NULL)
-                {
-                    body_expr_copy->context = VectorNew(sizeof(AST_Node *));
-                }
+                // define works out no value
+                // eval the init value of binding, and bind it in the current environment
+                matched = true;
+                AST_Node *binding = ast_node->contents.local_binding_form.contents.define.binding;
+                
+                AST_Node *init_value = binding->contents.binding.value;
+                AST_Node *eval_value = eval(init_value, env, aux_data);
 
-                if (body_expr->context != NULL)
+                if (eval_value == NULL)
                 {
-                    body_expr_copy->context = VectorCopy(body_expr->context, context_simple_copy_helper, NULL);
+                    // something wrong here
+                    fprintf(stderr, "eval(): something wrong here\n");
+                    exit(EXIT_FAILURE); 
                 }
 
-                // append virtual_param_copy to body_expr_copy's context
-                for(size_t j = 0; j < VectorLength(virtual_params_copy); j++)
+                set_procedure_name(eval_value, binding->contents.binding.name);
+                *environment_slot(env, binding->contents.binding.address) = eval_value;
+            }
+            
+            if (local_binding_form_type == LET)
+            {
+                matched = true;
+                Vector *bindings = ast_node->contents.local_binding_form.contents.lets.bindings;
+                Vector *body_exprs = ast_node->contents.local_binding_form.contents.lets.body_exprs;
+
+                // init values are evaled in the outer environment
+                Environment *inner = environment_new(env, VectorLength(ast_node->context));
+                gc_push_environment(&inner);
+                for (size_t i = 0; i < VectorLength(bindings); i++)
                 {
-                    AST_Node *virtual_param_copy = *(AST_Node **)VectorNth(virtual_params_copy, j);
-                    VectorAppend(body_expr_copy->context, &virtual_param_copy);
+                    AST_Node *binding = *(AST_Node **)VectorNth(bindings, i);
+                    AST_Node *eval_value = eval(binding->contents.binding.value, env, aux_data);
+                    set_procedure_name(eval_value, binding->contents.binding.name);
+                    inner->slots[i] = eval_value;
                 }
+                gc_pop(1);
 
-                generate_context(body_expr_copy, body_expr->parent, NULL);
-                VectorAppend(body_exprs_copy, &body_expr_copy);
+                environment_release(frame);
+                env = frame = inner;
+                tail_expr = eval_leading_body(body_exprs, env, aux_data);
             }
 
-            // binding virtual params copy to actual params
-            for (size_t i = 0; i < VectorLength(virtual_params_copy); i++)
+            if (local_binding_form_type == LET_STAR ||
+                local_binding_form_type == LETREC)
             {
-                AST_Node *virtual_param_copy = *(AST_Node **)VectorNth(virtual_params_copy, i);
-                AST_Node *operand = *(AST_Node **)VectorNth(operands, i);
-                virtual_param_copy->contents.binding.value = operand;
-            }
-
-            // eval
-            size_t last = VectorLength(body_exprs_copy) - 1;
-            for (size_t i = 0; i < VectorLength(body_exprs_copy); i++)
-            {
-                AST_Node *body_expr_copy = *(AST_Node **)VectorNth(body_exprs_copy, i);
-                result = eval(body_expr_copy, aux_data);
-                if (i != last)
+                matched = true;
+                Vector *bindings = ast_node->contents.local_binding_form.contents.lets.bindings;
+                Vector *body_exprs = ast_node->contents.local_binding_form.contents.lets.body_exprs;
+
+                // init values are evaled in the new environment, in order
+                // which bindings they can see (let*: the ones before, letrec: all) is decided by resolve_addresses()
+                Environment *inner = environment_new(env, VectorLength(ast_node->context));
+                gc_push_environment(&inner);
+                for (size_t i = 0; i < VectorLength(bindings); i++)
                 {
-                    middle_thing_free(result, aux_data);
+                    AST_Node *binding = *(AST_Node **)VectorNth(bindings, i);
+                    AST_Node *eval_value = eval(binding->contents.binding.value, inner, aux_data);
+                    set_procedure_name(eval_value, binding->contents.binding.name);
+                    inner->slots[i] = eval_value;
                 }
-            }
+                gc_pop(1);
 
-            // set virtual_param_copy's value to null
-            for (size_t i = 0; i < VectorLength(virtual_params_copy); i++)
-            {
-                AST_Node *virtual_param_copy = *(AST_Node **)VectorNth(virtual_params_copy, i);
-                virtual_param_copy->contents.binding.value = NULL; 
+                environment_release(frame);
+                env = frame = inner;
+                tail_expr = eval_leading_body(body_exprs, env, aux_data);
             }
-
-            // free operands
-            VectorFree(operands, middle_thing_free_helper, NULL);
-
-            // free virtual_params_copy
-            VectorFree(virtual_params_copy, middle_thing_free_helper, NULL);
-
-            // free body_exprs_copy
-            VectorFree(body_exprs_copy, middle_thing_free_helper, NULL);
         }
-    }
-    
-    if (ast_node->type == Local_Binding_Form)
-    {
-        Local_Binding_Form_Type local_binding_form_type = ast_node->contents.local_binding_form.type;
 
-        if (local_binding_form_type == DEFINE)
+        if (ast_node->type == Set_Form)
         {
-            // define works out no value
-            // eval the init value of binding into a new ast_node, and instead of the init value node by new ast_node
             matched = true;
-            AST_Node *binding = ast_node->contents.local_binding_form.contents.define.binding;
-            
-            AST_Node *init_value = binding->contents.binding.value;
-            AST_Node *eval_value = eval(init_value, aux_data);
+            AST_Node *id = ast_node->contents.set_form.id;
+            AST_Node *expr = ast_node->contents.set_form.expr;
+
+            AST_Node *expr_val = eval(expr, env, aux_data);
 
-            if (eval_value == init_value)
+            if (id->contents.binding.address.resolved == false)
             {
-                // do nothing
+                fprintf(stderr, "eval(): set!: unbound identifier: %s\n", id->contents.binding.name);
+                exit(EXIT_FAILURE);
             }
 
-            if (eval_value != init_value)
+            set_procedure_name(expr_val, id->contents.binding.name);
+            *environment_slot(env, id->contents.binding.address) = expr_val;
+
+            result = NULL;
+        } 
+
+        if (ast_node->type == Conditional_Form)
+        {
+            Conditional_Form_Type conditional_form_type = ast_node->contents.conditional_form.type;
+
+            if (conditional_form_type == IF)
             {
-                if (eval_value == NULL)
+                matched = true;
+                AST_Node *test_expr = ast_node->contents.conditional_form.contents.if_expression.test_expr;
+                AST_Node *then_expr = ast_node->contents.conditional_form.contents.if_expression.then_expr;
+                AST_Node *else_expr = ast_node->contents.conditional_form.contents.if_expression.else_expr;
+
+                AST_Node *test_val = eval(test_expr, env, aux_data);
+                if (test_val == NULL)
                 {
-                    // something wrong here
-                    fprintf(stderr, "eval(): something wrong here\n");
+                    fprintf(stderr, "eval(): if: bad syntax\n");
                     exit(EXIT_FAILURE); 
                 }
 
-                if (ast_node_get_tag(eval_value) == NOT_IN_AST)
-                {
-                    ast_node_set_tag_recursive(eval_value, IN_AST);
-                    generate_context(eval_value, binding, aux_data);
-                    binding->contents.binding.value = eval_value;
-                    ast_node_free(init_value); // free old value
-                }
+                bool val = !is_false(test_val); // true by default
 
-                if (eval_value->type == Procedure)
-                {
-                    eval_value->contents.procedure.name = malloc(strlen(TYPECAST(const char *, binding->contents.binding.name)) + 1);
-                    strcpy(TYPECAST(char *, eval_value->contents.procedure.name), TYPECAST(const char *, binding->contents.binding.name));
-                    generate_context(eval_value, binding, aux_data);
-                    ast_node_free(init_value);
-                }
+                if (val == true)
+                    tail_expr = then_expr; // excute then expr
+                else
+                    tail_expr = else_expr; // excute else expr
             }
-        }
-        
-        if (local_binding_form_type == LET ||
-            local_binding_form_type == LET_STAR ||
-            local_binding_form_type == LETREC)
-        {
-            matched = true;
-            Vector *bindings = ast_node->contents.local_binding_form.contents.lets.bindings;
-            Vector *body_exprs = ast_node->contents.local_binding_form.contents.lets.body_exprs;
 
-            // eval bindings
-            for (size_t i = 0; i < VectorLength(bindings); i++)
+            if (conditional_form_type == COND)
             {
-                AST_Node *binding = *(AST_Node **)VectorNth(bindings, i);
-                AST_Node *init_value = binding->contents.binding.value;
-                AST_Node *eval_value = eval(init_value, aux_data);
-                binding->contents.binding.value = eval_value;
+                matched = true;
+                Vector *cond_clauses = ast_node->contents.conditional_form.contents.cond_expression.cond_clauses;
 
-                if (eval_value != init_value)
+                for (size_t i = 0; i < VectorLength(cond_clauses); i++)
                 {
-                    if (eval_value != NULL && ast_node_get_tag(eval_value) == IN_AST)
+                    AST_Node *cond_clause = *(AST_Node **)VectorNth(cond_clauses, i);
+
+                    if (cond_clause->contents.cond_clause.type == TEST_EXPR_WITH_THENBODY)
                     {
-                        binding->contents.binding.value = ast_node_deep_copy(eval_value, NULL);
+                        // [test-expr then-body ...+]
+                        AST_Node *test_expr = cond_clause->contents.cond_clause.test_expr;
+
+                        AST_Node *test_val = eval(test_expr, env, aux_data);
+                        if (test_val == NULL)
+                        {
+                            fprintf(stderr, "eval(): cond: bad syntax\n");
+                            exit(EXIT_FAILURE); 
+                        }
+
+                        bool val = !is_false(test_val);
+
+                        if (val == true)
+                        {
+                            tail_expr = eval_leading_body(cond_clause->contents.cond_clause.then_bodies, env, aux_data);
+                            break;
+                        }
                     }
-                    else if (eval_value != NULL && ast_node_get_tag(eval_value) == NOT_IN_AST)
+                    else if (cond_clause->contents.cond_clause.type == ELSE_STATEMENT)
                     {
-                        ast_node_set_tag(binding->contents.binding.value, IN_AST);
-                        // maybe double free here
-                        ast_node_free(init_value);
+                        // [else then-body ...+]
+                        tail_expr = eval_leading_body(cond_clause->contents.cond_clause.then_bodies, env, aux_data);
+                        break;
                     }
-                    generate_context(binding->contents.binding.value, binding, NULL);
-                }
-
-                if (binding->contents.binding.value->type == Procedure)
-                {
-                    AST_Node *procedure = binding->contents.binding.value;
-                    procedure->contents.procedure.name = malloc(strlen(TYPECAST(const char *, binding->contents.binding.name)) + 1);
-                    strcpy(TYPECAST(char *, procedure->contents.procedure.name), TYPECAST(const char *, binding->contents.binding.name));
-                }
+                    else if (cond_clause->contents.cond_clause.type == TEST_EXPR_WITH_PROC)
+                    {
+                    }
+                    else if (cond_clause->contents.cond_clause.type == SINGLE_TEST_EXPR)
+                    {
+                    }
+                    else
+                    {
+                        // something wrong here
+                        fprintf(stderr, "eval(): can not handle Cond_Clause_Type: %d\n", cond_clause->contents.cond_clause.type);
+                        exit(EXIT_FAILURE);
+                    }
+                }
             }
 
-            // eval body_exprs
-            size_t last = VectorLength(body_exprs) - 1;
-            for (size_t i = 0; i < VectorLength(body_exprs); i++)
+            if (conditional_form_type == AND)
             {
-                AST_Node *body_expr = *(AST_Node **)VectorNth(body_exprs, i);
-                result = eval(body_expr, aux_data); // the last body_expr's result will be returned
-                if (i != last) 
+                matched = true;
+                Vector *exprs = ast_node->contents.conditional_form.contents.and_expression.exprs;
+                size_t length = VectorLength(exprs);
+
+                if (length == 0)
+                {
+                    result = value_from_boolean(R_TRUE);
+                }
+                else
                 {
-                    if (result != NULL && ast_node_get_tag(result) == NOT_IN_AST)
+                    // the first #f, or the value of the last expr which is a tail position
+                    tail_expr = *(AST_Node **)VectorNth(exprs, length - 1);
+                    for (size_t i = 0; i + 1 < length; i++)
                     {
-                        // maybe double free here
-                        ast_node_free(result);
+                        AST_Node *expr = *(AST_Node **)VectorNth(exprs, i);
+                        AST_Node *expr_val = eval(expr, env, aux_data);
+                        if (is_false(expr_val))
+                        {
+                            result = expr_val;
+                            tail_expr = NULL;
+                            break;
+                        }
                     }
                 }
             }
-        }
-    }
-
-    if (ast_node->type == Set_Form)
-    {
-        matched = true;
-        AST_Node *id = ast_node->contents.set_form.id;
-        AST_Node *expr = ast_node->contents.set_form.expr;
-
-        AST_Node *binding = search_binding_value(id);
-        AST_Node *expr_val = eval(expr, aux_data);
-
-        AST_Node *old_value = binding->contents.binding.value;
-        ast_node_free(old_value);
-
-        binding->contents.binding.value = ast_node_deep_copy(expr_val, aux_data);
-        binding->contents.binding.value->tag = IN_AST;
-        if (binding->contents.binding.value->type == Procedure)
-        {
-            AST_Node *procedure = binding->contents.binding.value;
-            procedure->contents.procedure.name = malloc(strlen(TYPECAST(const char *, binding->contents.binding.name)) + 1);
-            strcpy(TYPECAST(char *, procedure->contents.procedure.name), TYPECAST(const char *, binding->contents.binding.name));
-        }
-        generate_context(binding->contents.binding.value, ast_node, aux_data);
-
-        result = NULL;
-    } 
 
-    if (ast_node->type == Conditional_Form)
-    {
-        Conditional_Form_Type conditional_form_type = ast_node->contents.conditional_form.type;
-
-        if (conditional_form_type == IF)
-        {
-            matched = true;
-            AST_Node *test_expr = ast_node->contents.conditional_form.contents.if_expression.test_expr;
-            AST_Node *then_expr = ast_node->contents.conditional_form.contents.if_expression.then_expr;
-            AST_Node *else_expr = ast_node->contents.conditional_form.contents.if_expression.else_expr;
-
-            AST_Node *test_val = eval(test_expr, aux_data);
-            if (test_val == NULL)
+            if (conditional_form_type == NOT)
             {
-                fprintf(stderr, "eval(): if: bad syntax\n");
-                exit(EXIT_FAILURE); 
-            }
-
-            Boolean_Type val = R_TRUE; // true by default
-            if (test_val->type == Boolean_Literal &&
-               *(Boolean_Type *)(test_val->contents.literal.value) == R_FALSE)
-            {
-                val = R_FALSE;
-            }
+                matched = true;
 
-            if (ast_node_get_tag(test_val) == NOT_IN_AST)
-            {
-                ast_node_free(test_val);
-            }
+                AST_Node *expr = ast_node->contents.conditional_form.contents.not_expression.expr;
+                AST_Node *expr_val = eval(expr, env, aux_data);            
 
-            if (val == R_TRUE)
-            {
-                // excute then expr
-                // only (define) will work out NULL, and (define) can not be in (if)
-                result = eval(then_expr, aux_data);
-                if (result == NULL)
-                {
-                    fprintf(stderr, "eval(): if: bad syntax\n");
-                    exit(EXIT_FAILURE);
-                }
+                result = value_from_boolean(is_false(expr_val) ? R_TRUE : R_FALSE);
             }
 
-            if (val == R_FALSE)
+            if (conditional_form_type == OR)
             {
-                // excute else expr
-                // only (define) will work out NULL, and (define) can not be in (if)
-                result = eval(else_expr, aux_data);
-                if (result == NULL)
+                matched = true;
+                Vector *exprs = ast_node->contents.conditional_form.contents.or_expression.exprs;
+                size_t length = VectorLength(exprs);
+                
+                if (length == 0)
                 {
-                    fprintf(stderr, "eval(): if: bad syntax\n");
-                    exit(EXIT_FAILURE);
+                    result = value_from_boolean(R_FALSE);
                 }
-            }
-        }
-
-        if (conditional_form_type == COND)
-        {
-            matched = true;
-            Vector *cond_clauses = ast_node->contents.conditional_form.contents.cond_expression.cond_clauses;
-
-            for (size_t i = 0; i < VectorLength(cond_clauses); i++)
-            {
-                AST_Node *cond_clause = *(AST_Node **)VectorNth(cond_clauses, i);
-
-                if (cond_clause->contents.cond_clause.type == TEST_EXPR_WITH_THENBODY)
+                else
                 {
-                    // [test-expr then-body ...+]
-                    AST_Node *test_expr = cond_clause->contents.cond_clause.test_expr;
-
-                    AST_Node *test_val = eval(test_expr, aux_data);
-                    if (test_val == NULL)
+                    // the first value which is not #f, or the value of the last expr which is a tail position
+                    tail_expr = *(AST_Node **)VectorNth(exprs, length - 1);
+                    for (size_t i = 0; i + 1 < length; i++)
                     {
-                        fprintf(stderr, "eval(): cond: bad syntax\n");
-                        exit(EXIT_FAILURE); 
-                    }
-
-                    if (test_val->type != Boolean_Literal ||
-                        (test_val->type == Boolean_Literal && (*(Boolean_Type *)(test_val->contents.literal.value) == R_TRUE)))
-
-                    {
-                        Vector *then_bodies = cond_clause->contents.cond_clause.then_bodies;
-                        for (size_t j = 0; j < VectorLength(then_bodies); j++)
+                        AST_Node *expr = *(AST_Node **)VectorNth(exprs, i);
+                        AST_Node *expr_val = eval(expr, env, aux_data);
+                        if (!is_false(expr_val))
                         {
-                            AST_Node *then_body = *(AST_Node **)VectorNth(then_bodies, j);
-                            result = eval(then_body, aux_data);
+                            result = expr_val;
+                            tail_expr = NULL;
+                            break;
                         }
-                        break;
-                    }
-
-                    if (ast_node_get_tag(test_val) == NOT_IN_AST)
-                    {
-                        ast_node_free(test_val);
-                    } 
-                }
-                else if (cond_clause->contents.cond_clause.type == ELSE_STATEMENT)
-                {
-                    // [else then-body ...+]
-                    Vector *then_bodies = cond_clause->contents.cond_clause.then_bodies;
-                    for (size_t j = 0; j < VectorLength(then_bodies); j++)
-                    {
-                        AST_Node *then_body = *(AST_Node **)VectorNth(then_bodies, j);
-                        result = eval(then_body, aux_data);
                     }
-                    break;
-                }
-                else if (cond_clause->contents.cond_clause.type == TEST_EXPR_WITH_PROC)
-                {
-                }
-                else if (cond_clause->contents.cond_clause.type == SINGLE_TEST_EXPR)
-                {
-                }
-                else
-                {
-                    // something wrong here
-                    fprintf(stderr, "eval(): can not handle Cond_Clause_Type: %d\n", cond_clause->contents.cond_clause.type);
-                    exit(EXIT_FAILURE);
                 }
             }
         }
 
-        if (conditional_form_type == AND)
-        {
+        if (ast_node->type == Binding)
+        { 
+            // return the value of Binding
             matched = true;
-            Vector *exprs = ast_node->contents.conditional_form.contents.and_expression.exprs;
-
-            if (VectorLength(exprs) == 0)
+            AST_Node *value = ast_node->contents.binding.value;
+            if (value == NULL)
             {
-                Boolean_Type *value = malloc(sizeof(Boolean_Type)); 
-                *value = R_TRUE;
-                result = ast_node_new(NOT_IN_AST, Boolean_Literal, value);
+                // shared with the environment, nothing is copied
+                result = lookup_value(env, ast_node->contents.binding.address, ast_node->contents.binding.name);
             }
-
-            if (VectorLength(exprs) > 0)
+            else
             {
-                for (size_t i = 0; i < VectorLength(exprs); i++)
-                {
-                    AST_Node *expr = *(AST_Node **)VectorNth(exprs, i);
-                    AST_Node *expr_val = eval(expr, aux_data);
-
-                    if (expr_val->type == Boolean_Literal &&
-                        *(Boolean_Type *)(expr_val->contents.literal.value) == R_FALSE)
-                    {
-                        Boolean_Type *value = malloc(sizeof(Boolean_Type)); 
-                        *value = R_FALSE;
-                        result = ast_node_new(NOT_IN_AST, Boolean_Literal, value);
-                        break;
-                    }
-
-                    result = expr_val;
-                }
+                result = eval(value, env, aux_data);
             }
         }
 
-        if (conditional_form_type == NOT)
+        // these kind of AST_Node_Type works out them self
+        // numbers, booleans, characters and '() work out immediates, others a constant shared by every evaluation
+        if (ast_node->type == Number_Literal ||
+            ast_node->type == String_Literal ||
+            ast_node->type == Character_Literal ||
+            ast_node->type == Boolean_Literal ||
+            ast_node->type == List_Literal ||
+            ast_node->type == Pair_Literal ||
+            ast_node->type == Vector_Literal ||
+            ast_node->type == NULL_Expression ||
+            ast_node->type == EMPTY_Expression)
         {
             matched = true;
-
-            AST_Node *expr = ast_node->contents.conditional_form.contents.not_expression.expr;
-            AST_Node *expr_val = eval(expr, aux_data);            
-
-            Boolean_Type *value = malloc(sizeof(Boolean_Type));
-
-            if (expr_val->type == Boolean_Literal && *(Boolean_Type *)(expr_val->contents.literal.value) == R_FALSE)
-                *value = R_TRUE; 
-            else
-                *value = R_FALSE; 
-
-            result = ast_node_new(NOT_IN_AST, Boolean_Literal, value);
+            result = value_from_constant(ast_node);
         }
 
-        if (conditional_form_type == OR)
+        // Procedure works out itself
+        if (ast_node->type == Procedure)
         {
             matched = true;
-            Vector *exprs = ast_node->contents.conditional_form.contents.or_expression.exprs;
-            
-            if (VectorLength(exprs) == 0)
-            {
-                Boolean_Type *value = malloc(sizeof(Boolean_Type));
-                *value = R_FALSE;
-                result = ast_node_new(NOT_IN_AST, Boolean_Literal, value);
-            }
-            else if (VectorLength(exprs) == 1)
-            {
-                AST_Node *expr = *(AST_Node **)VectorNth(exprs, 0);
-                AST_Node *expr_val = eval(expr, aux_data);
-                result = expr_val;
-            }
-            else if (VectorLength(exprs) > 1)
-            {
-                for (size_t i = 0; i < VectorLength(exprs); i++)
-                {
-                    AST_Node *expr = *(AST_Node **)VectorNth(exprs, i);
-                    AST_Node *expr_val = eval(expr, aux_data);
-
-                    if (expr_val->type != Boolean_Literal ||
-                        (expr_val->type == Boolean_Literal && *(Boolean_Type *)(expr_val->contents.literal.value) == R_TRUE))
-                    {
-                        result = expr_val;
-                        break;
-                    } 
-
-                    result = expr_val;
-                }
-            }
+            result = ast_node;
         }
-    }
 
-    if (ast_node->type == Binding)
-    { 
-        // return the value of Binding
-        matched = true;
-        AST_Node *value = ast_node->contents.binding.value;
-        if (value == NULL)
+        // Lambda_Form works out a closure, it shares params and body_exprs with the Lambda_Form
+        if (ast_node->type == Lambda_Form)
         {
-            AST_Node *binding_contains_value = search_binding_value(ast_node);
-            if (binding_contains_value == NULL)
-            {
-                fprintf(stderr, "eval(): unbound identifier: %s\n", ast_node->contents.binding.name);
-                exit(EXIT_FAILURE);
-            }
-            value = binding_contains_value->contents.binding.value;
-        }
-        // make sure the return value of eval() will be absolutely NOT_IN_AST
-        result = eval(value, aux_data);
-    }
-
-    // these kind of AST_Node_Type works out them self
-    if (ast_node->type == Number_Literal ||
-        ast_node->type == String_Literal ||
-        ast_node->type == Character_Literal ||
-        ast_node->type == Boolean_Literal)
-    {
-        matched = true;
-        result = ast_node_deep_copy(ast_node, NULL);
-        ast_node_set_tag_recursive(result, NOT_IN_AST);
-    }
-
-    if (ast_node->type == NULL_Expression ||
-        ast_node->type == EMPTY_Expression)
-    {
-        // return '()
-        // the element's size in list means nothing, so use 1 byte(sizeof(unsigned char))
-        Vector *empty_vector = VectorNew(sizeof(unsigned char));
-        AST_Node *empty_list = ast_node_new(NOT_IN_AST, List_Literal, empty_vector);
-        return empty_list;
-    }
-
-    // List_Literal works out itself
-    if (ast_node->type == List_Literal)
-    {
-        matched = true;
-        result = ast_node_deep_copy(ast_node, NULL);
-        ast_node_set_tag_recursive(result, NOT_IN_AST);
-    }
-
-    // Pair_Literal works out itself
-    if (ast_node->type == Pair_Literal)
-    {
-        matched = true;
-        result = ast_node_deep_copy(ast_node, NULL);
-        ast_node_set_tag_recursive(result, NOT_IN_AST);
-    }
-
-    // Procedure works out itself
-    if (ast_node->type == Procedure)
-    {
-        matched = true;
-        result = ast_node;
-    }
-
-    if (ast_node->type == Lambda_Form)
-    {
-        matched = true;
-        Vector *params = ast_node->contents.lambda_form.params;
-        Vector *body_exprs = ast_node->contents.lambda_form.body_exprs;
-
-        // init an empty procedure
-        result = ast_node_new(NOT_IN_AST, Procedure, NULL, 0, NULL, NULL, NULL);
-
-        Vector *params_copy = VectorNew(sizeof(AST_Node *));
-        Vector *body_exprs_copy = VectorNew(sizeof(AST_Node *));
+            matched = true;
+            Vector *params = ast_node->contents.lambda_form.params;
+            Vector *body_exprs = ast_node->contents.lambda_form.body_exprs;
 
-        for (size_t i = 0; i < VectorLength(params); i++)
-        {
-            AST_Node *node = *(AST_Node **)VectorNth(params, i);
-            AST_Node *node_copy = ast_node_deep_copy(node, aux_data);
-            if (node->context != NULL)
-            {
-                Vector *context_copy = VectorCopy(node->context, context_simple_copy_helper, NULL);
-                node_copy->context = context_copy;
-            }
-            generate_context(node_copy, result, NULL);
-            VectorAppend(params_copy, &node_copy);
+            result = ast_node_new(NOT_IN_AST, Procedure, NULL, VectorLength(params), params, body_exprs, NULL);
+            result->contents.procedure.environment = environment_retain(env);
+            result->contents.procedure.code = ast_node->contents.lambda_form.code;
+            result->contents.procedure.frame_length = VectorLength(ast_node->context);
         }
 
-        for (size_t i = 0; i < VectorLength(body_exprs); i++)
+        if (matched == false)
         {
-            AST_Node *node = *(AST_Node **)VectorNth(body_exprs, i);
-            AST_Node *node_copy = ast_node_deep_copy(node, aux_data);
-            if (node_copy->context == NULL)
-            {
-                node_copy->context = VectorNew(sizeof(AST_Node *));
-            }
-            for(size_t j = 0; j < VectorLength(params_copy); j++)
-            {
-                AST_Node *param_copy = *(AST_Node **)VectorNth(params_copy, j);
-                VectorAppend(node_copy->context, &param_copy);
-            }
-            generate_context(node_copy, result, NULL);
-            VectorAppend(body_exprs_copy, &node_copy);
+            // when no matches any AST_Node_Type
+            fprintf(stderr, "eval(): can not eval AST_Node_Type: %d\n", ast_node->type);
+            exit(EXIT_FAILURE);
         }
 
-        result->contents.procedure.required_params_count = VectorLength(params_copy);
-        result->contents.procedure.params = params_copy;
-        result->contents.procedure.body_exprs = body_exprs_copy;
-
-        // if lambda_form itself has context, it should be inherit to the procedure
-        if (ast_node->context != NULL)
-        {
-            result->context = VectorCopy(ast_node->context, context_simple_copy_helper, NULL);
-        }
+        if (tail_expr == NULL) break;
+        ast_node = tail_expr;
     }
 
-    if (matched == false)
-    {
-        // when no matches any AST_Node_Type
-        fprintf(stderr, "eval(): can not eval AST_Node_Type: %d\n", ast_node->type);
-        exit(EXIT_FAILURE);
-    }
+    // the result may be held by frame only, it is not collected before the caller keeps it, nothing allocates in between
+    environment_release(frame);
+    gc_pop(1);
 
     return result;
 }
 
-// return: Vector *(Result)
-Vector *calculator(AST ast, void *aux_data)
+// engine: AST_ENGINE walks the ast by eval(), VM_ENGINE compiles every top level form and runs it by vm_run()
+// function: called with every result which is not void, with aux_data, before the next form runs,
+// so a vector or a hash table is shown as it is then, a later form may still change it
+void calculator(AST ast, Engine engine, Result_Function function, void *aux_data)
 {
     generate_context(ast, NULL, NULL); // generate context 
+    resolve_addresses(ast, NULL); // no name is searched after this
 
-    Vector *body = ast->contents.program.body;
-    Vector *results = VectorNew(sizeof(AST_Node *));
+    // the global environment, every environment chain ends here, laid out by Program's context
+    Environment *global = environment_new(NULL, VectorLength(ast->context));
+    ast->contents.program.environment = global;
 
-    for (size_t i = 0; i < VectorLength(body); i++)
+    for (size_t i = 0; i < VectorLength(ast->context); i++)
     {
-        AST_Node *sub_node = *(AST_Node **)VectorNth(body, i);
-        Result result = eval(sub_node, aux_data);
-        if (result != NULL)
+        AST_Node *binding = *(AST_Node **)VectorNth(ast->context, i);
+        if (binding->tag == BUILT_IN_BINDING || binding->tag == ADDON_BINDING)
         {
-            VectorAppend(results, &result);
+            global->slots[i] = binding->contents.binding.value;
         }
     }
 
-    return results;
-}
+    Vector *body = ast->contents.program.body;
+    scratch = arena_new();
 
-int results_free(Vector *results)
-{
-    int error = 0;
+    // gc roots: the global table, eval() and vm_run() push the rest
+    gc_push_environment(&global);
 
-    for (size_t i = 0; i < VectorLength(results); i++)
+    for (size_t i = 0; i < VectorLength(body); i++)
     {
-        AST_Node *result = *(AST_Node **)VectorNth(results, i);
-        error = error | middle_thing_free(result, NULL);
-    }
+        AST_Node *sub_node = *(AST_Node **)VectorNth(body, i);
+        Result result = NULL;
+
+        if (engine == AST_ENGINE)
+        {
+            result = eval(sub_node, global, aux_data);
+        }
+        else if (engine == VM_ENGINE)
+        {
+            Chunk *chunk = compile(sub_node, aux_data);
+            result = vm_run(chunk, global, aux_data);
+            chunk_free(chunk);
+        }
 
-    error = error | VectorFree(results, NULL, NULL);
+        // output allocates nothing, so the result needs no root
+        if (result != NULL) function(result, aux_data);
 
-    return error;
+        // results and defined values never live in the scratch arena, nothing of this form is left there
+        arena_reset(scratch);
+    }
+
+    gc_pop(1);
+    arena_free(scratch);
+    scratch = NULL;
 }
 
-void output_results(Vector *results, void *aux_data)
+// Result_Function of calculator(), one result on its own line
+void output_result_line(Result result, void *aux_data)
 {
-    for (size_t i = 0; i < VectorLength(results); i++)
-    {
-        Result result = *(AST_Node **)VectorNth(results, i);
-        output_result(result, aux_data);
-        fprintf(stdout, "\n");
-    }
+    output_result(result, aux_data);
+    fprintf(stdout, "\n");
 }
 
 // find the nearly parent contextable node
@@ -1199,145 +904,40 @@ static AST_Node *find_contextable_node(AST_Node *current_node)
 
 // param: AST_Node *(type: Binding) has just a name
 // return: AST_Node *(type: Binding) contains value
-static AST_Node *search_binding_value(AST_Node *binding)
+static void output_result(Result result, void *aux_data)
 {
-    if (binding == NULL)
-    {
-        fprintf(stderr, "can not search binding value for NULL\n");
-        exit(EXIT_FAILURE);
-    }
-
-    // if current binding node has value
-    if (binding->contents.binding.value != NULL) return binding;
-
-    AST_Node *binding_contains_value = NULL;
-    AST_Node *contextable = find_contextable_node(binding);
-
-    // search binding's value by 'name'
-    while (contextable != NULL)
+    // void is never a result by itself, but a list or a vector may hold it
+    if (result == NULL)
     {
-        Vector *context = contextable->context;
-        Vector *built_in_bindings = NULL;
-        Vector *addon_bindings = NULL;
-
-        if (contextable->type == Program) built_in_bindings = contextable->contents.program.built_in_bindings;
-        if (contextable->type == Program) addon_bindings = contextable->contents.program.addon_bindings; 
-        
-        for (size_t i = VectorLength(context); i > 0; i--)
-        {
-            AST_Node *node = *(AST_Node **)VectorNth(context, i - 1);
-            #ifdef DEBUG_MODE
-            printf("searching for name: %s, cur node's name: %s\n", binding->contents.binding.name, node->contents.binding.name);
-            #endif
-            if (strcmp(TYPECAST(const char *, binding->contents.binding.name), TYPECAST(const char *, node->contents.binding.name)) == 0)
-            {
-                binding_contains_value = node;
-
-                // check value
-                AST_Node *value = binding_contains_value->contents.binding.value;
-                if (value == NULL)
-                {
-                    fprintf(stderr, "search_binding_value(): unbound identifier: %s\n", binding->contents.binding.name);
-                    exit(EXIT_FAILURE);
-                }
-
-                goto found;
-            }
-        }
-
-        if (built_in_bindings != NULL)
-        {
-            for (size_t i = VectorLength(built_in_bindings); i > 0; i--)
-            {
-                AST_Node *node = *(AST_Node **)VectorNth(built_in_bindings, i - 1);
-                #ifdef DEBUG_MODE
-                printf("searching for name: %s, cur node's name: %s\n", binding->contents.binding.name, node->contents.binding.name);
-                #endif
-                if (strcmp(TYPECAST(const char *, binding->contents.binding.name), TYPECAST(const char *, node->contents.binding.name)) == 0)
-                {
-                    binding_contains_value = node;
-
-                    // check value
-                    AST_Node *value = binding_contains_value->contents.binding.value;
-                    if (value == NULL)
-                    {
-                        fprintf(stderr, "search_binding_value(): unbound identifier: %s\n", binding->contents.binding.name);
-                        exit(EXIT_FAILURE);
-                    }
-
-                    goto found;
-                }
-            }
-        }
-
-        if (addon_bindings != NULL)
-        {
-            for (size_t i = VectorLength(addon_bindings); i > 0; i--)
-            {
-                AST_Node *node = *(AST_Node **)VectorNth(addon_bindings, i - 1);
-                #ifdef DEBUG_MODE
-                printf("searching for name: %s, cur node's name: %s\n", binding->contents.binding.name, node->contents.binding.name);
-                #endif
-                if (strcmp(TYPECAST(const char *, binding->contents.binding.name), TYPECAST(const char *, node->contents.binding.name)) == 0)
-                {
-                    binding_contains_value = node;
-
-                    // check value
-                    AST_Node *value = binding_contains_value->contents.binding.value;
-                    if (value == NULL)
-                    {
-                        fprintf(stderr, "search_binding_value(): unbound identifier: %s\n", binding->contents.binding.name);
-                        exit(EXIT_FAILURE);
-                    }
-
-                    goto found;
-                }
-            }
-        }
-
-        contextable = find_contextable_node(contextable->parent);
-    }
-
-    if (binding_contains_value == NULL)
-    {
-        fprintf(stderr, "search_binding_value(): unbound identifier: %s\n", binding->contents.binding.name);
-        exit(EXIT_FAILURE);
+        fprintf(stdout, "#<void>");
+        return;
     }
 
-    found: return binding_contains_value;
-}
-
-static void output_result(Result result, void *aux_data)
-{
     bool matched = false;
+    AST_Node_Type type = value_type(result);
 
-    if (result->type == Number_Literal)
+    if (type == Number_Literal)
     {
         matched = true;
-        fprintf(stdout, "%s", TYPECAST(unsigned char *, result->contents.literal.value));
+        output_number(result);
     }
 
-    if (result->type ==  String_Literal)
+    if (type == String_Literal)
     {
         matched = true;
         fprintf(stdout, "\"%s\"", TYPECAST(unsigned char *, result->contents.literal.value));
     }
 
-    if (result->type ==  Character_Literal)
+    if (type == Character_Literal)
     {
         matched = true;
-        fprintf(stdout, "#\\%c", *(unsigned char *)(result->contents.literal.value));
+        fprintf(stdout, "#\\%c", value_to_character(result));
     }
 
-    if (result->type ==  List_Literal)
+    if (type == List_Literal || type == Pair)
     {
         matched = true;
 
-        Vector *value = TYPECAST(Vector *, result->contents.literal.value);
-
-        size_t length = VectorLength(value);
-        size_t last = length - 1;
-
         if (aux_data != NULL && strcmp(aux_data, "in_list_or_in_pair") == 0)
         {
             fprintf(stdout, "(");
@@ -1346,53 +946,84 @@ static void output_result(Result result, void *aux_data)
         {
             fprintf(stdout, "'(");
         }
-        
-        for (size_t i = 0; i < length; i++)
+
+        // walk the cdr chain, a tail which is not '() makes an improper list
+        AST_Node *list = result;
+        while (value_is_pair(list))
+        {
+            output_result(value_car(list), "in_list_or_in_pair");
+            list = value_cdr(list);
+            if (value_is_pair(list)) fprintf(stdout, " ");
+        }
+        if (list != value_empty_list())
         {
-            AST_Node *node = *(AST_Node **)VectorNth(value, i);
-            output_result(node, "in_list_or_in_pair");
-            if (i != last) fprintf(stdout, " ");
+            fprintf(stdout, " . ");
+            output_result(list, "in_list_or_in_pair");
         }
         fprintf(stdout, ")");
     }
 
-    if (result->type == Pair_Literal)
+    if (type == Racket_Vector)
     {
         matched = true;
 
-        Vector *value = TYPECAST(Vector *, result->contents.literal.value);
-        AST_Node *car = *(AST_Node **)VectorNth(value, 0);
-        AST_Node *cdr = *(AST_Node **)VectorNth(value, 1);
-
-        int length = 2; // a dot pair always has two elements
-
         if (aux_data != NULL && strcmp(aux_data, "in_list_or_in_pair") == 0)
         {
-            fprintf(stdout, "(");
+            fprintf(stdout, "#(");
         }
         else
         {
-            fprintf(stdout, "'(");
+            fprintf(stdout, "'#(");
+        }
+
+        for (size_t i = 0; i < result->contents.racket_vector.length; i++)
+        {
+            if (i > 0) fprintf(stdout, " ");
+            output_result(result->contents.racket_vector.elements[i], "in_list_or_in_pair");
         }
-        output_result(car, "in_list_or_in_pair");
-        fprintf(stdout, " . ");
-        output_result(cdr, "in_list_or_in_pair");
         fprintf(stdout, ")");
     }
 
-    if (result->type == Boolean_Literal)
+    if (type == Racket_Hash)
+    {
+        matched = true;
+
+        Hash_Table *table = result->contents.racket_hash.table;
+        if (aux_data == NULL || strcmp(aux_data, "in_list_or_in_pair") != 0) fprintf(stdout, "'");
+        fprintf(stdout, table != NULL && table->equality == HASH_EQ ? "#hasheq(" : "#hash(");
+        bool first = true;
+        if (table != NULL)
+            hash_table_for_each(table, output_hash_entry, &first);
+        else
+            hamt_for_each(result->contents.racket_hash.root, output_hash_entry, &first);
+        fprintf(stdout, ")");
+    }
+
+    if (type == Flvector)
     {
         matched = true;
 
-        Boolean_Type *value = TYPECAST(Boolean_Type *, result->contents.literal.value);
+        fprintf(stdout, "(flvector");
+        for (size_t i = 0; i < result->contents.flvector.length; i++)
+        {
+            char buffer[FORMAT_DOUBLE_LENGTH];
+            fputc(' ', stdout);
+            fwrite(buffer, 1, format_double(result->contents.flvector.elements[i], buffer), stdout);
+        }
+        fprintf(stdout, ")");
+    }
 
-        if (*value == R_TRUE)
+    if (type == Boolean_Literal)
+    {
+        matched = true;
+
+        if (value_to_boolean(result) == R_TRUE)
             fprintf(stdout, "#t");
-        else if (*value == R_FALSE)
+        else
             fprintf(stdout, "#f");
     }
 
-    if (result->type == Procedure)
+    if (type == Procedure)
     {
         matched = true;
 
@@ -1407,33 +1038,331 @@ static void output_result(Result result, void *aux_data)
     if (matched == false)
     {
         // when no matches any AST_Node_Type
-        fprintf(stderr, "output_result(): can not output AST_Node_Type: %d\n", result->type);
+        fprintf(stderr, "output_result(): can not output AST_Node_Type: %d\n", type);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// (key . value) of a hash table, aux_data is whether it is the first one
+static void output_hash_entry(Hash_Table_Entry *entry, void *aux_data)
+{
+    bool *first = TYPECAST(bool *, aux_data);
+    if (*first == false) fprintf(stdout, " ");
+    *first = false;
+
+    fprintf(stdout, "(");
+    output_result(entry->key, "in_list_or_in_pair");
+    fprintf(stdout, " . ");
+    output_result(entry->value, "in_list_or_in_pair");
+    fprintf(stdout, ")");
+}
+
+// fixnums and flonums are formatted on the stack, the common case of printing never allocates
+static void output_number(AST_Node *number)
+{
+    if (value_is_fixnum(number))
+    {
+        char buffer[FORMAT_INTEGER_LENGTH];
+        fwrite(buffer, 1, format_integer(value_to_fixnum(number), buffer), stdout);
+        return;
+    }
+
+    if (!value_is_exact(number))
+    {
+        char buffer[FORMAT_DOUBLE_LENGTH];
+        fwrite(buffer, 1, format_double(value_to_double(number), buffer), stdout);
+        return;
+    }
+
+    char *text = number_to_string(number);
+    fputs(text, stdout);
+    free(text);
+}
+
+// any value other than #f counts as true
+bool is_false(AST_Node *value)
+{
+    return value == value_from_boolean(R_FALSE);
+}
+
+// (define fn (lambda ...)) gives the procedure its name, a named procedure keeps its name
+void set_procedure_name(AST_Node *procedure, const unsigned char *name)
+{
+    if (procedure == NULL || value_type(procedure) != Procedure) return;
+    if (procedure->contents.procedure.name != NULL) return;
+
+    procedure->contents.procedure.name = malloc(strlen(TYPECAST(const char *, name)) + 1);
+    strcpy(TYPECAST(char *, procedure->contents.procedure.name), TYPECAST(const char *, name));
+}
+
+/*
+    call procedure with argc values already evaluated, for built-ins which call back, such as map
+    argv must be rooted by the caller, a built-in gets it in place, no call expression is made
+    a closure runs its bytecode when compile() has made it, otherwise its body is evaled
+*/
+Result apply_procedure(AST_Node *procedure, size_t argc, AST_Node **argv)
+{
+    if (procedure->contents.procedure.c_native_function != NULL)
+    {
+        Vector operands = { argv, sizeof(AST_Node *), argc, argc };
+        Function c_native_function = procedure->contents.procedure.c_native_function;
+        return ((AST_Node *(*)(AST_Node *procedure, Vector *operands))c_native_function)(procedure, &operands);
+    }
+
+    // check arity
+    size_t required_params_count = procedure->contents.procedure.required_params_count;
+    if (argc != required_params_count)
+    {
+        if (procedure->contents.procedure.name == NULL)
+        {
+            fprintf(stderr, "anomyous procedure: arity mismatch;\n"
+                            "the expected number of arguments does not match the given number\n"
+                            "expected: %zu\n"
+                            "given: %zu\n", required_params_count, argc);
+        }
+        else
+        {
+            fprintf(stderr, "%s: arity mismatch;\n"
+                            "the expected number of arguments does not match the given number\n"
+                            "expected: %zu\n"
+                            "given: %zu\n", procedure->contents.procedure.name, required_params_count, argc);
+        }
+        exit(EXIT_FAILURE);
+    }
+
+    // the same environment eval() and vm_run() make for a call, the operands in the first slots
+    Environment *inner = environment_new(procedure->contents.procedure.environment, procedure->contents.procedure.frame_length);
+    for (size_t i = 0; i < argc; i++)
+    {
+        inner->slots[i] = argv[i];
+    }
+
+    Result result = NULL;
+    if (procedure->contents.procedure.code != NULL)
+    {
+        result = vm_run(procedure->contents.procedure.code, inner, NULL);
+    }
+    else
+    {
+        gc_push_environment(&inner);
+        AST_Node *tail_expr = eval_leading_body(procedure->contents.procedure.body_exprs, inner, NULL);
+        result = eval(tail_expr, inner, NULL);
+        gc_pop(1);
+    }
+    environment_release(inner);
+    return result;
+}
+
+// return: the value at address, shared with the environment, name is only for errors
+AST_Node *lookup_value(Environment *env, Lexical_Address address, const unsigned char *name)
+{
+    if (address.resolved == false)
+    {
+        fprintf(stderr, "eval(): unbound identifier: %s\n", name);
+        exit(EXIT_FAILURE);
+    }
+
+    AST_Node *value = *environment_slot(env, address);
+    if (value == NULL)
+    {
+        fprintf(stderr, "%s: undefined;\ncannot use before initialization\n", name);
         exit(EXIT_FAILURE);
     }
+
+    return value;
 }
 
-static void *context_simple_copy_helper(void *value_addr, size_t index, Vector *original_vector, Vector *new_vector, void *aux_data)
+// eval body_exprs except the last one, the last body_expr is a tail position and returned to eval()
+static AST_Node *eval_leading_body(Vector *body_exprs, Environment *env, void *aux_data)
 {
-    return value_addr;
+    size_t length = VectorLength(body_exprs);
+    if (length == 0) return NULL;
+
+    for (size_t i = 0; i + 1 < length; i++)
+    {
+        AST_Node *body_expr = *(AST_Node **)VectorNth(body_exprs, i);
+        eval(body_expr, env, aux_data);
+    }
+
+    return *(AST_Node **)VectorNth(body_exprs, length - 1);
+}
+
+// return: the index of the last binding named name in context[0, visible_length), -1 if none
+// names are interned, so they are compared by pointer, table is the index of a large context
+static long context_index(Vector *context, Symbol_Table *table, const unsigned char *name, size_t visible_length)
+{
+    if (table != NULL)
+    {
+        Symbol_Table_Entry *entry = symbol_table_get(table, name);
+        return entry == NULL ? -1 : (long)entry->value;
+    }
+
+    for (size_t i = visible_length; i > 0; i--)
+    {
+        AST_Node *binding = *(AST_Node **)VectorNth(context, i - 1);
+        if (binding->contents.binding.name == name) return i - 1;
+    }
+
+    return -1;
 }
 
-static void middle_thing_free_helper(void *value_addr, size_t index, Vector *vector, void *aux_data)
+// search name from the innermost scope to the global one, not resolved when unbound
+static Lexical_Address scope_lookup(Scope *scope, const unsigned char *name)
 {
-    AST_Node *ast_node = *(AST_Node **)value_addr;
-    middle_thing_free(ast_node, aux_data);
+    Lexical_Address address = { false, 0, 0 };
+
+    for (size_t depth = 0; scope != NULL; scope = scope->parent, depth++)
+    {
+        long index = context_index(scope->context, scope->table, name, scope->visible_length);
+        if (index != -1)
+        {
+            address.resolved = true;
+            address.depth = depth;
+            address.index = index;
+            break;
+        }
+    }
+
+    return address;
 }
 
-static int middle_thing_free(AST_Node *ast_node, void *aux_data)
+// node is an expression evaluated in scope
+static void resolve_addresses_helper(AST_Node *node, Scope *scope)
 {
-    if (ast_node != NULL &&
-        ast_node_get_tag(ast_node) == NOT_IN_AST &&
-        ast_node->type != Procedure)
+    if (node->type == Local_Binding_Form)
+    {
+        Local_Binding_Form_Type local_binding_form_type = node->contents.local_binding_form.type;
+
+        if (local_binding_form_type == DEFINE)
+        {
+            // the slot was recorded by generate_context() in the context of the nearest contextable node
+            AST_Node *binding = node->contents.local_binding_form.contents.define.binding;
+            Scope whole = { NULL, scope->context, scope->table, VectorLength(scope->context) };
+            binding->contents.binding.address = scope_lookup(&whole, binding->contents.binding.name);
+            resolve_addresses_helper(binding->contents.binding.value, scope);
+        }
+
+        if (local_binding_form_type == LET ||
+            local_binding_form_type == LET_STAR ||
+            local_binding_form_type == LETREC)
+        {
+            Vector *bindings = node->contents.local_binding_form.contents.lets.bindings;
+            Vector *body_exprs = node->contents.local_binding_form.contents.lets.body_exprs;
+            Scope inner = { scope, node->context, NULL, VectorLength(node->context) };
+
+            for (size_t i = 0; i < VectorLength(bindings); i++)
+            {
+                AST_Node *binding = *(AST_Node **)VectorNth(bindings, i);
+                binding->contents.binding.address = (Lexical_Address){ true, 0, i };
+
+                // let: init values are evaled in the outer environment
+                // let*: in the new environment, seeing the bindings before
+                // letrec: in the new environment, seeing all of them
+                if (local_binding_form_type == LET)
+                {
+                    resolve_addresses_helper(binding->contents.binding.value, scope);
+                }
+                else if (local_binding_form_type == LET_STAR)
+                {
+                    inner.visible_length = i;
+                    resolve_addresses_helper(binding->contents.binding.value, &inner);
+                }
+                else if (local_binding_form_type == LETREC)
+                {
+                    resolve_addresses_helper(binding->contents.binding.value, &inner);
+                }
+            }
+
+            inner.visible_length = VectorLength(node->context);
+            resolve_body(body_exprs, &inner);
+        }
+    }
+
+    if (node->type == Set_Form)
+    {
+        AST_Node *id = node->contents.set_form.id;
+        id->contents.binding.address = scope_lookup(scope, id->contents.binding.name);
+        resolve_addresses_helper(node->contents.set_form.expr, scope);
+    }
+
+    if (node->type == Conditional_Form)
+    {
+        Conditional_Form_Type conditional_form_type = node->contents.conditional_form.type;
+
+        if (conditional_form_type == IF)
+        {
+            resolve_addresses_helper(node->contents.conditional_form.contents.if_expression.test_expr, scope);
+            resolve_addresses_helper(node->contents.conditional_form.contents.if_expression.then_expr, scope);
+            resolve_addresses_helper(node->contents.conditional_form.contents.if_expression.else_expr, scope);
+        }
+
+        if (conditional_form_type == COND)
+        {
+            Vector *cond_clauses = node->contents.conditional_form.contents.cond_expression.cond_clauses;
+            for (size_t i = 0; i < VectorLength(cond_clauses); i++)
+            {
+                AST_Node *cond_clause = *(AST_Node **)VectorNth(cond_clauses, i);
+                if (cond_clause->contents.cond_clause.test_expr != NULL)
+                    resolve_addresses_helper(cond_clause->contents.cond_clause.test_expr, scope);
+                if (cond_clause->contents.cond_clause.then_bodies != NULL)
+                    resolve_body(cond_clause->contents.cond_clause.then_bodies, scope);
+            }
+        }
+
+        if (conditional_form_type == AND)
+            resolve_body(node->contents.conditional_form.contents.and_expression.exprs, scope);
+
+        if (conditional_form_type == OR)
+            resolve_body(node->contents.conditional_form.contents.or_expression.exprs, scope);
+
+        if (conditional_form_type == NOT)
+            resolve_addresses_helper(node->contents.conditional_form.contents.not_expression.expr, scope);
+    }
+
+    if (node->type == Call_Expression)
+    {
+        const unsigned char *name = node->contents.call_expression.name;
+        AST_Node *anonymous_procedure = node->contents.call_expression.anonymous_procedure;
+
+        if (name != NULL)
+            node->contents.call_expression.address = scope_lookup(scope, name);
+        else if (anonymous_procedure != NULL && anonymous_procedure->type == Lambda_Form)
+            resolve_addresses_helper(anonymous_procedure, scope);
+
+        resolve_body(node->contents.call_expression.params, scope);
+    }
+
+    if (node->type == Binding)
+    {
+        AST_Node *value = node->contents.binding.value;
+        if (value != NULL)
+            resolve_addresses_helper(value, scope);
+        else
+            node->contents.binding.address = scope_lookup(scope, node->contents.binding.name);
+    }
+
+    if (node->type == Lambda_Form)
     {
-        ast_node_free(ast_node);
-        return 0;
+        // params are the first slots of the environment of a call
+        Vector *params = node->contents.lambda_form.params;
+        for (size_t i = 0; i < VectorLength(params); i++)
+        {
+            AST_Node *param = *(AST_Node **)VectorNth(params, i);
+            param->contents.binding.address = (Lexical_Address){ true, 0, i };
+        }
+
+        Scope inner = { scope, node->context, NULL, VectorLength(node->context) };
+        resolve_body(node->contents.lambda_form.body_exprs, &inner);
     }
-    else 
+
+    // literals, '() and procedures have no identifier in them
+}
+
+static void resolve_body(Vector *body_exprs, Scope *scope)
+{
+    for (size_t i = 0; i < VectorLength(body_exprs); i++)
     {
-        return 1;
+        AST_Node *body_expr = *(AST_Node **)VectorNth(body_exprs, i);
+        resolve_addresses_helper(body_expr, scope);
     }
-}
\ No newline at end of file
+}
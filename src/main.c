@@ -2,22 +2,25 @@
 #include "../include/load_racket_file.h"
 #include "../include/tokenizer.h"
 #include "../include/parser.h"
+#include "../include/optimizer.h"
 #include "../include/interpreter.h"
+#include "../include/gc.h"
+#include "../include/symbol.h"
 #include "../include/debug.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+static const char *parse_arguments(int argc, char *argv[], Engine *engine, bool *print_gc_stats);
 
 int main(int argc, char *argv[])
 {
     #ifdef RELEASE_MODE
-    // check rkt file argument
-    if (argc != 2)
-    {
-        perror("miss .rkt file.");
-        exit(EXIT_FAILURE);
-    }
-    // get the path from command arg
-    const char *path = argv[1];
+    // check rkt file argument and get the path from command arg
+    Engine engine = AST_ENGINE;
+    bool print_gc_stats = false;
+    const char *path = parse_arguments(argc, argv, &engine, &print_gc_stats);
 
     // load racket file content into memory
     Raw_Code *raw_code = racket_file_load(TYPECAST(const unsigned char *, path));
@@ -28,28 +31,30 @@ int main(int argc, char *argv[])
     // parser
     AST ast = parser(tokens);
 
-    // calculator
-    Vector *results = calculator(ast, NULL);
+    // optimizer
+    optimizer(ast);
 
-    // output results
-    output_results(results, NULL);
+    // calculator, every result is output as soon as its form is done
+    calculator(ast, engine, output_result_line, NULL);
 
     // release memory
     racket_file_free(raw_code);
     tokens_free(tokens);
-    results_free(results); // first
+    if (print_gc_stats == true)
+    {
+        fflush(stdout); // after the results
+        gc_print_stats(stderr);
+    }
+    gc_free(); // first, closures release their environments
     ast_free(ast); // second
+    symbols_free(); // last, names in the ast are interned
     #endif
 
     #ifdef TEST_MODE 
-    // check rkt file argument
-    if (argc != 2)
-    {
-        perror("miss .rkt file.");
-        exit(EXIT_FAILURE);
-    }
-    // get the path from command arg
-    const char *path = argv[1];
+    // check rkt file argument and get the path from command arg
+    Engine engine = AST_ENGINE;
+    bool print_gc_stats = false;
+    const char *path = parse_arguments(argc, argv, &engine, &print_gc_stats);
 
     // load racket file content into memory
     Raw_Code *raw_code = racket_file_load(TYPECAST(const unsigned char *, path));
@@ -60,28 +65,30 @@ int main(int argc, char *argv[])
     // parser
     AST ast = parser(tokens);
 
-    // calculator
-    Vector *results = calculator(ast, NULL);
+    // optimizer
+    optimizer(ast);
 
-    // output results
-    output_results(results, NULL);
+    // calculator, every result is output as soon as its form is done
+    calculator(ast, engine, output_result_line, NULL);
 
     // release memory
     racket_file_free(raw_code);
     tokens_free(tokens);
-    results_free(results); // first
+    if (print_gc_stats == true)
+    {
+        fflush(stdout); // after the results
+        gc_print_stats(stderr);
+    }
+    gc_free(); // first, closures release their environments
     ast_free(ast); // second
+    symbols_free(); // last, names in the ast are interned
     #endif
 
     #ifdef DEBUG_MODE
-    // check rkt file argument
-    if (argc != 2)
-    {
-        perror("miss .rkt file.");
-        exit(EXIT_FAILURE);
-    }
-    // get the path from command arg
-    const char *path = argv[1];
+    // check rkt file argument and get the path from command arg
+    Engine engine = AST_ENGINE;
+    bool print_gc_stats = false;
+    const char *path = parse_arguments(argc, argv, &engine, &print_gc_stats);
 
     // load racket file content into memory
     Raw_Code *raw_code = racket_file_load(TYPECAST(const unsigned char *, path));
@@ -99,6 +106,9 @@ int main(int argc, char *argv[])
     // parser
     AST ast = parser(tokens);
 
+    // optimizer
+    optimizer(ast);
+
     // show ast by traverser
     Visitor custom_visitor = get_custom_visitor();
     traverser(ast, custom_visitor, NULL);
@@ -109,26 +119,74 @@ int main(int argc, char *argv[])
     printf("\n");
     ast_node_set_tag_recursive(ast_copy, NOT_IN_AST);
 
-    // calculator
-    Vector *results = calculator(ast, NULL);
-
-    // show result by traverser
+    // calculator, show every result as soon as its form is done, runtime values are not ast, so not by traverser
     printf("\nResult:\n");
-    for (size_t i = 0; i < VectorLength(results); i++)
-    {
-        Result result = *(AST_Node **)VectorNth(results, i);
-        traverser(result, custom_visitor, NULL);
-        printf("\n");
-    }
+    calculator(ast, engine, output_result_line, NULL);
     
     // release memory
     racket_file_free(raw_code);
     tokens_free(tokens);
-    results_free(results); // first
+    if (print_gc_stats == true)
+    {
+        fflush(stdout); // after the results
+        gc_print_stats(stderr);
+    }
+    gc_free(); // first, closures release their environments
     ast_free(ast); // second
     ast_free(ast_copy);
     visitor_free(custom_visitor);
+    symbols_free(); // last, names in the ast are interned
     #endif
 
     return 0;
-}
\ No newline at end of file
+}
+
+// usage: racket [--engine=ast|vm] [--gc-stats] [--gc-nursery=cells] file.rkt
+static const char *parse_arguments(int argc, char *argv[], Engine *engine, bool *print_gc_stats)
+{
+    const char *path = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--engine=ast") == 0)
+        {
+            *engine = AST_ENGINE;
+        }
+        else if (strcmp(argv[i], "--engine=vm") == 0)
+        {
+            *engine = VM_ENGINE;
+        }
+        else if (strcmp(argv[i], "--gc-stats") == 0)
+        {
+            *print_gc_stats = true; // printed to stderr at exit
+        }
+        else if (strncmp(argv[i], "--gc-nursery=", strlen("--gc-nursery=")) == 0)
+        {
+            char *end = NULL;
+            long long int length = strtoll(argv[i] + strlen("--gc-nursery="), &end, 10);
+            if (*end != '\0' || length <= 0)
+            {
+                fprintf(stderr, "bad nursery length: %s\n", argv[i]);
+                exit(EXIT_FAILURE);
+            }
+            gc_set_nursery_length(TYPECAST(size_t, length));
+        }
+        else if (path == NULL)
+        {
+            path = argv[i];
+        }
+        else
+        {
+            fprintf(stderr, "unknown argument: %s\n", argv[i]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (path == NULL)
+    {
+        perror("miss .rkt file.");
+        exit(EXIT_FAILURE);
+    }
+
+    return path;
+}
@@ -0,0 +1,673 @@
+#include "../include/global.h"
+#include "../include/number.h"
+#include "../include/value.h"
+#include "../include/bignum.h"
+#include "../include/gc.h"
+#include "../include/format.h"
+#include <stdlib.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+typedef Bignum *(*Bignum_Operation)(const Bignum *a, const Bignum *b);
+
+static AST_Node *exact_operation(AST_Node *a, AST_Node *b, Bignum_Operation operation);
+static Bignum *exact_to_bignum(AST_Node *n, bool *borrowed);
+static bool multiply_overflows(long long int a, long long int b, long long int *product);
+static bool add_overflows(long long int a, long long int b, long long int *sum);
+static AST_Node *rational_add(AST_Node *a, AST_Node *b, bool subtract);
+static AST_Node *rational_multiply(AST_Node *a, AST_Node *b, bool divide);
+static int rational_compare(AST_Node *a, AST_Node *b);
+static AST_Node *rational_normalize(AST_Node *numerator, AST_Node *denominator);
+static AST_Node *rational_from_integers(long long int numerator, long long int denominator);
+static AST_Node *rational_new(AST_Node *numerator, AST_Node *denominator);
+static AST_Node *numerator_of(AST_Node *n);
+static AST_Node *denominator_of(AST_Node *n);
+static AST_Node *integer_gcd(AST_Node *a, AST_Node *b);
+static AST_Node *integer_sqrt(AST_Node *n, bool *perfect);
+static unsigned long long int binary_gcd(unsigned long long int a, unsigned long long int b);
+
+AST_Node *number_add(AST_Node *a, AST_Node *b)
+{
+    // fixnums have 48 bits, their sum always fits in long long int
+    if (value_is_fixnum(a) && value_is_fixnum(b)) return value_from_integer(value_to_fixnum(a) + value_to_fixnum(b));
+    if (!value_is_exact(a) || !value_is_exact(b)) return value_from_double(value_to_double(a) + value_to_double(b));
+    if (value_is_rational(a) || value_is_rational(b)) return rational_add(a, b, false);
+    return exact_operation(a, b, bignum_add);
+}
+
+AST_Node *number_subtract(AST_Node *a, AST_Node *b)
+{
+    if (value_is_fixnum(a) && value_is_fixnum(b)) return value_from_integer(value_to_fixnum(a) - value_to_fixnum(b));
+    if (!value_is_exact(a) || !value_is_exact(b)) return value_from_double(value_to_double(a) - value_to_double(b));
+    if (value_is_rational(a) || value_is_rational(b)) return rational_add(a, b, true);
+    return exact_operation(a, b, bignum_subtract);
+}
+
+AST_Node *number_multiply(AST_Node *a, AST_Node *b)
+{
+    if (value_is_fixnum(a) && value_is_fixnum(b))
+    {
+        long long int product = 0;
+        if (multiply_overflows(value_to_fixnum(a), value_to_fixnum(b), &product) == false) return value_from_integer(product);
+        return exact_operation(a, b, bignum_multiply);
+    }
+    if (!value_is_exact(a) || !value_is_exact(b)) return value_from_double(value_to_double(a) * value_to_double(b));
+    if (value_is_rational(a) || value_is_rational(b)) return rational_multiply(a, b, false);
+    return exact_operation(a, b, bignum_multiply);
+}
+
+// b must not be 0, exact operands give an exact quotient, 1/3 instead of 0.333333
+AST_Node *number_divide(AST_Node *a, AST_Node *b)
+{
+    if (value_is_fixnum(a) && value_is_fixnum(b)) return rational_from_integers(value_to_fixnum(a), value_to_fixnum(b));
+    if (!value_is_exact(a) || !value_is_exact(b)) return value_from_double(value_to_double(a) / value_to_double(b));
+    return rational_multiply(a, b, true);
+}
+
+// an inexact a is negated as a double, 0 - a would turn -0.0 and 0.0 both into 0.0
+AST_Node *number_negate(AST_Node *a)
+{
+    if (!value_is_exact(a)) return value_from_double(-value_to_double(a));
+    return number_subtract(value_from_fixnum(0), a);
+}
+
+// return: -1, 0 or 1 as a < b, a = b or a > b, NUMBER_UNORDERED when either is NaN
+int number_compare(AST_Node *a, AST_Node *b)
+{
+    if (value_is_fixnum(a) && value_is_fixnum(b))
+    {
+        long long int x = value_to_fixnum(a);
+        long long int y = value_to_fixnum(b);
+        return (x > y) - (x < y);
+    }
+
+    if (!value_is_exact(a) || !value_is_exact(b))
+    {
+        double x = value_to_double(a);
+        double y = value_to_double(b);
+        if (x != x || y != y) return NUMBER_UNORDERED;
+        return (x > y) - (x < y);
+    }
+
+    if (value_is_rational(a) || value_is_rational(b)) return rational_compare(a, b);
+
+    bool a_borrowed = false;
+    bool b_borrowed = false;
+    Bignum *x = exact_to_bignum(a, &a_borrowed);
+    Bignum *y = exact_to_bignum(b, &b_borrowed);
+    int order = bignum_compare(x, y);
+    if (a_borrowed == false) free(x);
+    if (b_borrowed == false) free(y);
+
+    return (order > 0) - (order < 0);
+}
+
+// an exact integer or a finite flonum without a fraction, such as 2.0
+bool number_is_integer(AST_Node *n)
+{
+    if (value_is_rational(n)) return false;
+    if (value_is_exact(n)) return true;
+
+    double x = value_to_double(n);
+    return isfinite(x) && floor(x) == x;
+}
+
+// a and b are integers, b is not 0, inexact when either is
+AST_Node *number_integer_divide(AST_Node *a, AST_Node *b, Number_Division division)
+{
+    if (value_is_fixnum(a) && value_is_fixnum(b))
+    {
+        // fixnums have 48 bits, so the quotient never overflows
+        long long int x = value_to_fixnum(a);
+        long long int y = value_to_fixnum(b);
+        long long int remainder = x % y;
+        if (division == NUMBER_QUOTIENT) return value_from_integer(x / y);
+        if (division == NUMBER_MODULO && remainder != 0 && (remainder < 0) != (y < 0)) remainder += y;
+        return value_from_integer(remainder);
+    }
+
+    if (!value_is_exact(a) || !value_is_exact(b))
+    {
+        double x = value_to_double(a);
+        double y = value_to_double(b);
+        double remainder = fmod(x, y);
+        if (division == NUMBER_QUOTIENT) return value_from_double((x - remainder) / y);
+        if (division == NUMBER_MODULO && remainder != 0 && (remainder < 0) != (y < 0)) remainder += y;
+        return value_from_double(remainder);
+    }
+
+    bool a_borrowed = false;
+    bool b_borrowed = false;
+    Bignum *x = exact_to_bignum(a, &a_borrowed);
+    Bignum *y = exact_to_bignum(b, &b_borrowed);
+    Bignum *result = NULL;
+    if (division == NUMBER_QUOTIENT)
+    {
+        bignum_divide(x, y, &result, NULL);
+    }
+    else
+    {
+        bignum_divide(x, y, NULL, &result);
+        if (division == NUMBER_MODULO && result->length != 0 && result->negative != y->negative)
+        {
+            Bignum *remainder = result;
+            result = bignum_add(remainder, y);
+            free(remainder);
+        }
+    }
+    if (a_borrowed == false) free(x);
+    if (b_borrowed == false) free(y);
+
+    return value_from_bignum(result);
+}
+
+// to an integer of the same exactness
+AST_Node *number_round(AST_Node *a, Number_Rounding rounding)
+{
+    if (!value_is_exact(a))
+    {
+        double x = value_to_double(a);
+        if (rounding == NUMBER_FLOOR) x = floor(x);
+        if (rounding == NUMBER_CEILING) x = ceil(x);
+        if (rounding == NUMBER_ROUND) x = nearbyint(x); // the default rounding mode breaks ties to even
+        if (rounding == NUMBER_TRUNCATE) x = trunc(x);
+        return value_from_double(x);
+    }
+
+    if (!value_is_rational(a)) return a;
+
+    // the denominator is above 1, so the truncated quotient is never a itself and the fraction left is never 0
+    AST_Node *values[3] = { a, NULL, NULL };
+    gc_push_values(values, 3);
+    long long int sign = number_compare(a->contents.rational.numerator, value_from_fixnum(0));
+    values[1] = number_integer_divide(a->contents.rational.numerator, a->contents.rational.denominator, NUMBER_QUOTIENT);
+    bool away_from_zero = false;
+    if (rounding == NUMBER_FLOOR) away_from_zero = sign < 0;
+    if (rounding == NUMBER_CEILING) away_from_zero = sign > 0;
+    if (rounding == NUMBER_ROUND)
+    {
+        // compare twice the fraction left with 1, a tie goes to the even neighbour
+        values[2] = number_abs(number_multiply(number_subtract(a, values[1]), value_from_fixnum(2)));
+        int order = number_compare(values[2], value_from_fixnum(1));
+        values[2] = number_integer_divide(values[1], value_from_fixnum(2), NUMBER_REMAINDER);
+        away_from_zero = order > 0 || (order == 0 && values[2] != value_from_fixnum(0));
+    }
+    if (away_from_zero == true) values[1] = number_add(values[1], value_from_fixnum(sign));
+    AST_Node *result = values[1];
+    gc_pop(1);
+
+    return result;
+}
+
+// an exact base to a fixnum power is exact, by squaring, anything else goes through pow()
+// 0, 1 and -1 stay exact to a bignum power too, which a double would round, -1 by the parity of the power
+AST_Node *number_expt(AST_Node *base, AST_Node *exponent)
+{
+    if (exponent == value_from_fixnum(0)) return value_from_fixnum(1); // even for an inexact base, like racket
+
+    if (value_is_exact(base) && value_is_bignum(exponent))
+    {
+        if (base != value_from_fixnum(-1)) return base;
+        bool odd = number_integer_divide(exponent, value_from_fixnum(2), NUMBER_REMAINDER) != value_from_fixnum(0);
+        return odd == true ? base : value_from_fixnum(1);
+    }
+
+    if (!value_is_exact(base) || !value_is_fixnum(exponent))
+        return value_from_double(pow(value_to_double(base), value_to_double(exponent)));
+
+    long long int power = value_to_fixnum(exponent);
+    unsigned long long int bits = power < 0 ? -(unsigned long long int)power : (unsigned long long int)power;
+    AST_Node *values[2] = { base, value_from_fixnum(1) }; // the square so far and the result
+    gc_push_values(values, 2);
+    while (bits != 0)
+    {
+        if ((bits & 1) != 0) values[1] = number_multiply(values[1], values[0]);
+        bits >>= 1;
+        if (bits != 0) values[0] = number_multiply(values[0], values[0]);
+    }
+    if (power < 0) values[1] = number_divide(value_from_fixnum(1), values[1]);
+    AST_Node *result = values[1];
+    gc_pop(1);
+
+    return result;
+}
+
+// exact when a is an exact square, such as 4 or 9/16
+AST_Node *number_sqrt(AST_Node *a)
+{
+    if (value_is_exact(a) && number_compare(a, value_from_fixnum(0)) >= 0)
+    {
+        AST_Node *values[3] = { a, NULL, NULL };
+        gc_push_values(values, 3);
+        bool numerator_perfect = false;
+        bool denominator_perfect = false;
+        values[1] = integer_sqrt(numerator_of(a), &numerator_perfect);
+        values[2] = integer_sqrt(denominator_of(a), &denominator_perfect);
+        AST_Node *result = NULL;
+        if (numerator_perfect == true && denominator_perfect == true) result = number_divide(values[1], values[2]);
+        gc_pop(1);
+        if (result != NULL) return result;
+    }
+
+    return value_from_double(sqrt(value_to_double(a)));
+}
+
+AST_Node *number_abs(AST_Node *a)
+{
+    if (!value_is_exact(a)) return value_from_double(fabs(value_to_double(a)));
+    if (number_compare(a, value_from_fixnum(0)) < 0) return number_negate(a);
+    return a;
+}
+
+// a and b are exact integers, the result of two fixnums is a fixnum too
+AST_Node *number_bitwise(AST_Node *a, AST_Node *b, Bignum_Bitwise operation)
+{
+    if (value_is_fixnum(a) && value_is_fixnum(b))
+    {
+        long long int x = value_to_fixnum(a);
+        long long int y = value_to_fixnum(b);
+        if (operation == BIGNUM_AND) return value_from_fixnum(x & y);
+        if (operation == BIGNUM_IOR) return value_from_fixnum(x | y);
+        return value_from_fixnum(x ^ y);
+    }
+
+    bool a_borrowed = false;
+    bool b_borrowed = false;
+    Bignum *x = exact_to_bignum(a, &a_borrowed);
+    Bignum *y = exact_to_bignum(b, &b_borrowed);
+    Bignum *result = bignum_bitwise(x, y, operation);
+    if (a_borrowed == false) free(x);
+    if (b_borrowed == false) free(y);
+
+    return value_from_bignum(result);
+}
+
+// -a - 1, a is an exact integer
+AST_Node *number_bitwise_not(AST_Node *a)
+{
+    if (value_is_fixnum(a)) return value_from_fixnum(~value_to_fixnum(a));
+    return number_subtract(value_from_fixnum(-1), a);
+}
+
+// a * 2^shift rounded down, a is an exact integer
+AST_Node *number_arithmetic_shift(AST_Node *a, long long int shift)
+{
+    if (value_is_fixnum(a))
+    {
+        long long int x = value_to_fixnum(a);
+        if (shift <= 0) return value_from_integer(shift <= -63 ? (x < 0 ? -1 : 0) : x >> -shift);
+
+        long long int product = 0;
+        if (shift < 63 && multiply_overflows(x, 1LL << shift, &product) == false) return value_from_integer(product);
+    }
+
+    bool borrowed = false;
+    Bignum *x = exact_to_bignum(a, &borrowed);
+    Bignum *result = bignum_shift(x, shift);
+    if (borrowed == false) free(x);
+
+    return value_from_bignum(result);
+}
+
+// bits needed by a in two's complement without the sign bit, a is an exact integer
+size_t number_integer_length(AST_Node *a)
+{
+    if (value_is_bignum(a)) return bignum_bit_length(value_to_bignum(a));
+
+    long long int x = value_to_fixnum(a);
+    unsigned long long int bits = (unsigned long long int)(x < 0 ? ~x : x);
+    size_t length = 0;
+    while (bits != 0)
+    {
+        length++;
+        bits >>= 1;
+    }
+    return length;
+}
+
+// racket's notation: 42, 1/3, 0.1, 1e+21, the text is malloc'd and owned by the caller
+char *number_to_string(AST_Node *n)
+{
+    if (value_is_rational(n))
+    {
+        char *numerator = number_to_string(n->contents.rational.numerator);
+        char *denominator = number_to_string(n->contents.rational.denominator);
+        size_t numerator_length = strlen(numerator);
+        size_t denominator_length = strlen(denominator);
+        char *text = (char *)malloc(numerator_length + denominator_length + 2);
+        if (text == NULL)
+        {
+            perror("number_to_string(): malloc failed");
+            exit(EXIT_FAILURE);
+        }
+        memcpy(text, numerator, numerator_length);
+        text[numerator_length] = '/';
+        memcpy(text + numerator_length + 1, denominator, denominator_length + 1);
+        free(numerator);
+        free(denominator);
+        return text;
+    }
+
+    if (value_is_bignum(n)) return bignum_to_string(value_to_bignum(n));
+
+    char buffer[FORMAT_DOUBLE_LENGTH];
+    if (value_is_fixnum(n)) format_integer(value_to_fixnum(n), buffer);
+    else format_double(value_to_double(n), buffer);
+
+    char *text = (char *)malloc(strlen(buffer) + 1);
+    if (text == NULL)
+    {
+        perror("number_to_string(): malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    strcpy(text, buffer);
+    return text;
+}
+
+// the result is made before anything is allocated from the collector, so a and b need no rooting in between
+static AST_Node *exact_operation(AST_Node *a, AST_Node *b, Bignum_Operation operation)
+{
+    bool a_borrowed = false;
+    bool b_borrowed = false;
+    Bignum *x = exact_to_bignum(a, &a_borrowed);
+    Bignum *y = exact_to_bignum(b, &b_borrowed);
+    Bignum *result = operation(x, y);
+    if (a_borrowed == false) free(x);
+    if (b_borrowed == false) free(y);
+
+    return value_from_bignum(result);
+}
+
+// a bignum value lends its own, a fixnum gets a new one to be freed
+static Bignum *exact_to_bignum(AST_Node *n, bool *borrowed)
+{
+    *borrowed = value_is_bignum(n);
+    if (*borrowed == true) return value_to_bignum(n);
+    return bignum_from_integer(value_to_fixnum(n));
+}
+
+// checked multiplication, the product is only valid when it does not overflow
+static bool multiply_overflows(long long int a, long long int b, long long int *product)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_mul_overflow(a, b, product);
+#else
+    // conservative around LLONG_MIN, a false overflow only costs the slow path
+    if (a == LLONG_MIN || b == LLONG_MIN) return true;
+    if (a != 0 && (b > LLONG_MAX / (a < 0 ? -a : a) || b < -(LLONG_MAX / (a < 0 ? -a : a)))) return true;
+    *product = a * b;
+    return false;
+#endif
+}
+
+static bool add_overflows(long long int a, long long int b, long long int *sum)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_add_overflow(a, b, sum);
+#else
+    if ((b > 0 && a > LLONG_MAX - b) || (b < 0 && a < LLONG_MIN - b)) return true;
+    *sum = a + b;
+    return false;
+#endif
+}
+
+// a/b + c/d = (ad + cb) / bd, or (ad - cb) / bd
+static AST_Node *rational_add(AST_Node *a, AST_Node *b, bool subtract)
+{
+    AST_Node *an = numerator_of(a);
+    AST_Node *ad = denominator_of(a);
+    AST_Node *bn = numerator_of(b);
+    AST_Node *bd = denominator_of(b);
+
+    if (value_is_fixnum(an) && value_is_fixnum(ad) && value_is_fixnum(bn) && value_is_fixnum(bd))
+    {
+        long long int left = 0;
+        long long int right = 0;
+        long long int numerator = 0;
+        long long int denominator = 0;
+        if (multiply_overflows(value_to_fixnum(an), value_to_fixnum(bd), &left) == false &&
+            multiply_overflows(subtract ? -value_to_fixnum(bn) : value_to_fixnum(bn), value_to_fixnum(ad), &right) == false &&
+            add_overflows(left, right, &numerator) == false &&
+            multiply_overflows(value_to_fixnum(ad), value_to_fixnum(bd), &denominator) == false)
+        {
+            return rational_from_integers(numerator, denominator);
+        }
+    }
+
+    // a and b may be held by nothing else, every step below can collect
+    AST_Node *values[5] = { a, b, NULL, NULL, NULL };
+    gc_push_values(values, 5);
+    values[2] = number_multiply(an, bd);
+    values[3] = number_multiply(bn, ad);
+    values[2] = subtract ? number_subtract(values[2], values[3]) : number_add(values[2], values[3]);
+    values[4] = number_multiply(ad, bd);
+    AST_Node *result = rational_normalize(values[2], values[4]);
+    gc_pop(1);
+
+    return result;
+}
+
+// a/b * c/d = ac / bd, a/b / c/d = ad / bc, c is not 0 when dividing
+static AST_Node *rational_multiply(AST_Node *a, AST_Node *b, bool divide)
+{
+    AST_Node *an = numerator_of(a);
+    AST_Node *ad = denominator_of(a);
+    AST_Node *bn = divide ? denominator_of(b) : numerator_of(b);
+    AST_Node *bd = divide ? numerator_of(b) : denominator_of(b);
+
+    if (value_is_fixnum(an) && value_is_fixnum(ad) && value_is_fixnum(bn) && value_is_fixnum(bd))
+    {
+        long long int numerator = 0;
+        long long int denominator = 0;
+        if (multiply_overflows(value_to_fixnum(an), value_to_fixnum(bn), &numerator) == false &&
+            multiply_overflows(value_to_fixnum(ad), value_to_fixnum(bd), &denominator) == false)
+        {
+            return rational_from_integers(numerator, denominator);
+        }
+    }
+
+    AST_Node *values[4] = { a, b, NULL, NULL };
+    gc_push_values(values, 4);
+    values[2] = number_multiply(an, bn);
+    values[3] = number_multiply(ad, bd);
+    AST_Node *result = rational_normalize(values[2], values[3]);
+    gc_pop(1);
+
+    return result;
+}
+
+// denominators are positive, so a/b < c/d exactly when ad < cb
+static int rational_compare(AST_Node *a, AST_Node *b)
+{
+    AST_Node *values[4] = { a, b, NULL, NULL };
+    gc_push_values(values, 4);
+    values[2] = number_multiply(numerator_of(a), denominator_of(b));
+    values[3] = number_multiply(numerator_of(b), denominator_of(a));
+    int order = number_compare(values[2], values[3]);
+    gc_pop(1);
+
+    return order;
+}
+
+// numerator / denominator in lowest terms, both exact integers, denominator is not 0
+static AST_Node *rational_normalize(AST_Node *numerator, AST_Node *denominator)
+{
+    if (value_is_fixnum(numerator) && value_is_fixnum(denominator))
+        return rational_from_integers(value_to_fixnum(numerator), value_to_fixnum(denominator));
+
+    AST_Node *values[3] = { numerator, denominator, NULL };
+    gc_push_values(values, 3);
+
+    if (number_compare(values[1], value_from_fixnum(0)) < 0)
+    {
+        values[0] = number_negate(values[0]);
+        values[1] = number_negate(values[1]);
+    }
+
+    values[2] = integer_gcd(values[0], values[1]);
+    if (values[2] != value_from_fixnum(1))
+    {
+        values[0] = number_integer_divide(values[0], values[2], NUMBER_QUOTIENT);
+        values[1] = number_integer_divide(values[1], values[2], NUMBER_QUOTIENT);
+    }
+
+    AST_Node *result = values[1] == value_from_fixnum(1) ? values[0] : rational_new(values[0], values[1]);
+    gc_pop(1);
+
+    return result;
+}
+
+// the fast path of rational_normalize(), numerator / denominator in lowest terms
+static AST_Node *rational_from_integers(long long int numerator, long long int denominator)
+{
+    // LLONG_MIN has no positive counterpart, such a rare ratio takes the bignum path
+    if (numerator == LLONG_MIN || denominator == LLONG_MIN)
+    {
+        AST_Node *values[2] = { value_from_integer(numerator), NULL };
+        gc_push_values(values, 2);
+        values[1] = value_from_integer(denominator);
+        AST_Node *result = rational_normalize(values[0], values[1]);
+        gc_pop(1);
+        return result;
+    }
+
+    if (denominator < 0)
+    {
+        numerator = -numerator;
+        denominator = -denominator;
+    }
+
+    unsigned long long int divisor = binary_gcd(numerator < 0 ? -(unsigned long long int)numerator : (unsigned long long int)numerator,
+                                                (unsigned long long int)denominator);
+    numerator /= (long long int)divisor;
+    denominator /= (long long int)divisor;
+
+    if (denominator == 1) return value_from_integer(numerator);
+
+    AST_Node *values[2] = { value_from_integer(numerator), NULL };
+    gc_push_values(values, 2);
+    values[1] = value_from_integer(denominator);
+    AST_Node *result = rational_new(values[0], values[1]);
+    gc_pop(1);
+    return result;
+}
+
+// numerator and denominator are already in lowest terms
+static AST_Node *rational_new(AST_Node *numerator, AST_Node *denominator)
+{
+    AST_Node *values[2] = { numerator, denominator };
+    gc_push_values(values, 2);
+    AST_Node *rational = ast_node_new(NOT_IN_AST, Rational, numerator, denominator);
+    gc_pop(1);
+    return rational;
+}
+
+static AST_Node *numerator_of(AST_Node *n)
+{
+    return value_is_rational(n) ? n->contents.rational.numerator : n;
+}
+
+static AST_Node *denominator_of(AST_Node *n)
+{
+    return value_is_rational(n) ? n->contents.rational.denominator : value_from_fixnum(1);
+}
+
+// the greatest common divisor of two exact integers, never negative, euclid on bignums, binary gcd on fixnums
+static AST_Node *integer_gcd(AST_Node *a, AST_Node *b)
+{
+    if (value_is_fixnum(a) && value_is_fixnum(b))
+    {
+        long long int x = value_to_fixnum(a);
+        long long int y = value_to_fixnum(b);
+        return value_from_integer((long long int)binary_gcd(x < 0 ? -x : x, y < 0 ? -y : y));
+    }
+
+    bool a_borrowed = false;
+    bool b_borrowed = false;
+    Bignum *x = exact_to_bignum(a, &a_borrowed);
+    Bignum *y = exact_to_bignum(b, &b_borrowed);
+    Bignum *larger = bignum_copy(x);
+    Bignum *smaller = bignum_copy(y);
+    larger->negative = false;
+    smaller->negative = false;
+    if (a_borrowed == false) free(x);
+    if (b_borrowed == false) free(y);
+
+    while (smaller->length != 0)
+    {
+        Bignum *remainder = NULL;
+        bignum_divide(larger, smaller, NULL, &remainder);
+        free(larger);
+        larger = smaller;
+        smaller = remainder;
+    }
+    free(smaller);
+
+    return value_from_bignum(larger);
+}
+
+// the square root rounded down of an exact integer >= 0, newton's method from above on bignums
+static AST_Node *integer_sqrt(AST_Node *n, bool *perfect)
+{
+    if (value_is_fixnum(n))
+    {
+        // a fixnum has 48 bits, the root of its double is at most one off
+        long long int x = value_to_fixnum(n);
+        long long int root = (long long int)sqrt((double)x);
+        while (root * root > x) root--;
+        while ((root + 1) * (root + 1) <= x) root++;
+        *perfect = root * root == x;
+        return value_from_integer(root);
+    }
+
+    // 2^(16 * limbs) is above the root, every step of newton's method comes closer until it stops going down
+    AST_Node *values[4] = { n, NULL, NULL, NULL };
+    gc_push_values(values, 4);
+    values[1] = number_expt(value_from_fixnum(2), value_from_integer(16 * (long long int)value_to_bignum(n)->length));
+    while (true)
+    {
+        values[3] = number_integer_divide(values[0], values[1], NUMBER_QUOTIENT);
+        values[2] = number_integer_divide(number_add(values[1], values[3]), value_from_fixnum(2), NUMBER_QUOTIENT);
+        if (number_compare(values[2], values[1]) >= 0) break;
+        values[1] = values[2];
+    }
+    values[2] = number_multiply(values[1], values[1]);
+    *perfect = number_compare(values[2], values[0]) == 0;
+    AST_Node *root = values[1];
+    gc_pop(1);
+
+    return root;
+}
+
+// stein's algorithm: shifts and subtractions only, gcd(0, b) = b
+static unsigned long long int binary_gcd(unsigned long long int a, unsigned long long int b)
+{
+    if (a == 0) return b;
+    if (b == 0) return a;
+
+    int shift = 0;
+    while (((a | b) & 1) == 0)
+    {
+        a >>= 1;
+        b >>= 1;
+        shift++;
+    }
+    while ((a & 1) == 0) a >>= 1;
+
+    do
+    {
+        while ((b & 1) == 0) b >>= 1;
+        if (a > b)
+        {
+            unsigned long long int t = a;
+            a = b;
+            b = t;
+        }
+        b -= a;
+    } while (b != 0);
+
+    return a << shift;
+}
@@ -0,0 +1,399 @@
+#include "../include/global.h"
+#include "../include/optimizer.h"
+#include "../include/parser.h"
+#include "../include/value.h"
+#include "../include/number.h"
+#include "../include/bignum.h"
+#include "../include/gc.h"
+#include "../include/symbol.h"
+#include "../include/vector.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef enum _z_fold_operator {
+    FOLD_ADD, FOLD_SUBTRACT, FOLD_MULTIPLY, FOLD_DIVIDE,
+    FOLD_EQUAL, FOLD_LESS, FOLD_MORE, FOLD_LESS_OR_EQUAL, FOLD_MORE_OR_EQUAL,
+    FOLD_NONE // sign for iterate
+} Fold_Operator;
+typedef struct _z_foldable {
+    const char *name;
+    size_t arity; // at least, as the built-in checks, fewer operands are left to raise the error
+    const unsigned char *symbol; // interned by optimizer()
+    bool shadowed; // bound somewhere in the program, never folded
+} Foldable;
+typedef void (*Slot_Function)(AST_Node **slot);
+
+// in the order of Fold_Operator
+static Foldable foldables[FOLD_NONE] = {
+    { "+", 0, NULL, false }, { "-", 1, NULL, false }, { "*", 0, NULL, false }, { "/", 1, NULL, false },
+    { "=", 1, NULL, false }, { "<", 1, NULL, false }, { ">", 1, NULL, false }, { "<=", 1, NULL, false }, { ">=", 1, NULL, false }
+};
+
+static void children_map(AST_Node *node, Slot_Function function);
+static void vector_slots_map(Vector *nodes, Slot_Function function);
+static void find_shadowed(AST_Node **slot);
+static void shadow(const unsigned char *name);
+static void fold(AST_Node **slot);
+static Fold_Operator fold_operator(AST_Node *call);
+static AST_Node *fold_call(AST_Node *call);
+static AST_Node *fold_arithmetic(Fold_Operator operator, Vector *params);
+static AST_Node *fold_comparison(Fold_Operator operator, Vector *params);
+static AST_Node *fold_identity(Fold_Operator operator, AST_Node *call);
+static AST_Node *fold_not(AST_Node *not_form);
+static AST_Node *number_node_from_value(AST_Node *value);
+static bool is_literal(AST_Node *node);
+static bool is_number(AST_Node *node);
+static bool is_exact_integer(AST_Node *node, long long int n);
+static Vector *call_take_params(AST_Node *call);
+
+void optimizer(AST ast)
+{
+    for (Fold_Operator operator = FOLD_ADD; operator != FOLD_NONE; operator++)
+    {
+        foldables[operator].symbol = symbol_intern(TYPECAST(const unsigned char *, foldables[operator].name));
+        foldables[operator].shadowed = false;
+    }
+
+    // a name bound anywhere is shadowed everywhere, scopes are not worth resolving for a handful of names
+    children_map(ast, find_shadowed);
+    children_map(ast, fold);
+}
+
+// calls function with the address of every child of node which is an expression or a binding
+static void children_map(AST_Node *node, Slot_Function function)
+{
+    if (node->type == Program)
+    {
+        vector_slots_map(node->contents.program.body, function);
+    }
+
+    if (node->type == Local_Binding_Form)
+    {
+        if (node->contents.local_binding_form.type == DEFINE)
+        {
+            function(&(node->contents.local_binding_form.contents.define.binding));
+        }
+        else
+        {
+            vector_slots_map(node->contents.local_binding_form.contents.lets.bindings, function);
+            vector_slots_map(node->contents.local_binding_form.contents.lets.body_exprs, function);
+        }
+    }
+
+    if (node->type == Binding)
+    {
+        if (node->contents.binding.value != NULL) function(&(node->contents.binding.value));
+    }
+
+    if (node->type == Set_Form)
+    {
+        function(&(node->contents.set_form.id));
+        function(&(node->contents.set_form.expr));
+    }
+
+    if (node->type == Conditional_Form)
+    {
+        Conditional_Form_Type type = node->contents.conditional_form.type;
+        if (type == IF)
+        {
+            function(&(node->contents.conditional_form.contents.if_expression.test_expr));
+            function(&(node->contents.conditional_form.contents.if_expression.then_expr));
+            function(&(node->contents.conditional_form.contents.if_expression.else_expr));
+        }
+        if (type == AND) vector_slots_map(node->contents.conditional_form.contents.and_expression.exprs, function);
+        if (type == OR) vector_slots_map(node->contents.conditional_form.contents.or_expression.exprs, function);
+        if (type == NOT) function(&(node->contents.conditional_form.contents.not_expression.expr));
+        if (type == COND) vector_slots_map(node->contents.conditional_form.contents.cond_expression.cond_clauses, function);
+    }
+
+    if (node->type == Cond_Clause)
+    {
+        if (node->contents.cond_clause.test_expr != NULL) function(&(node->contents.cond_clause.test_expr));
+        if (node->contents.cond_clause.then_bodies != NULL) vector_slots_map(node->contents.cond_clause.then_bodies, function);
+        if (node->contents.cond_clause.proc_expr != NULL) function(&(node->contents.cond_clause.proc_expr));
+    }
+
+    if (node->type == Lambda_Form)
+    {
+        vector_slots_map(node->contents.lambda_form.params, function);
+        vector_slots_map(node->contents.lambda_form.body_exprs, function);
+    }
+
+    if (node->type == Call_Expression)
+    {
+        if (node->contents.call_expression.anonymous_procedure != NULL)
+            function(&(node->contents.call_expression.anonymous_procedure));
+        vector_slots_map(node->contents.call_expression.params, function);
+    }
+
+    // literals are folded already, the rest have no children
+}
+
+static void vector_slots_map(Vector *nodes, Slot_Function function)
+{
+    for (size_t i = 0; i < VectorLength(nodes); i++)
+    {
+        function(TYPECAST(AST_Node **, VectorNth(nodes, i)));
+    }
+}
+
+static void find_shadowed(AST_Node **slot)
+{
+    AST_Node *node = *slot;
+
+    if (node->type == Local_Binding_Form)
+    {
+        if (node->contents.local_binding_form.type == DEFINE)
+        {
+            shadow(node->contents.local_binding_form.contents.define.binding->contents.binding.name);
+        }
+        else
+        {
+            Vector *bindings = node->contents.local_binding_form.contents.lets.bindings;
+            for (size_t i = 0; i < VectorLength(bindings); i++)
+            {
+                AST_Node *binding = *(AST_Node **)VectorNth(bindings, i);
+                shadow(binding->contents.binding.name);
+            }
+        }
+    }
+
+    if (node->type == Set_Form)
+    {
+        shadow(node->contents.set_form.id->contents.binding.name);
+    }
+
+    if (node->type == Lambda_Form)
+    {
+        Vector *params = node->contents.lambda_form.params;
+        for (size_t i = 0; i < VectorLength(params); i++)
+        {
+            AST_Node *param = *(AST_Node **)VectorNth(params, i);
+            shadow(param->contents.binding.name);
+        }
+    }
+
+    children_map(node, find_shadowed);
+}
+
+static void shadow(const unsigned char *name)
+{
+    for (Fold_Operator operator = FOLD_ADD; operator != FOLD_NONE; operator++)
+    {
+        if (foldables[operator].symbol == name) foldables[operator].shadowed = true;
+    }
+}
+
+// folds the children first, so (+ 1 (* 2 3)) becomes 7
+static void fold(AST_Node **slot)
+{
+    children_map(*slot, fold);
+
+    AST_Node *node = *slot;
+    AST_Node *folded = NULL;
+    if (node->type == Call_Expression) folded = fold_call(node);
+    else if (node->type == Conditional_Form && node->contents.conditional_form.type == NOT) folded = fold_not(node);
+    if (folded != NULL) *slot = folded;
+}
+
+// the unshadowed built-in called by name, or FOLD_NONE
+static Fold_Operator fold_operator(AST_Node *call)
+{
+    const unsigned char *name = call->contents.call_expression.name;
+    if (name == NULL) return FOLD_NONE;
+
+    for (Fold_Operator operator = FOLD_ADD; operator != FOLD_NONE; operator++)
+    {
+        if (foldables[operator].symbol == name)
+            return foldables[operator].shadowed == true ? FOLD_NONE : operator;
+    }
+    return FOLD_NONE;
+}
+
+// returns the node replacing call and frees call, or NULL when call stays, so do the other fold_xxx()
+static AST_Node *fold_call(AST_Node *call)
+{
+    Fold_Operator operator = fold_operator(call);
+    if (operator == FOLD_NONE) return NULL;
+
+    Vector *params = call->contents.call_expression.params;
+    if (VectorLength(params) < foldables[operator].arity) return NULL;
+
+    bool numbers = true;
+    for (size_t i = 0; i < VectorLength(params); i++)
+    {
+        AST_Node *param = *(AST_Node **)VectorNth(params, i);
+        if (param->type != Number_Literal) numbers = false;
+    }
+    if (numbers == false) return fold_identity(operator, call);
+
+    AST_Node *folded = NULL;
+    if (operator == FOLD_ADD || operator == FOLD_SUBTRACT || operator == FOLD_MULTIPLY || operator == FOLD_DIVIDE)
+        folded = fold_arithmetic(operator, params);
+    else
+        folded = fold_comparison(operator, params);
+
+    if (folded != NULL) ast_node_free(call);
+    return folded;
+}
+
+static AST_Node *fold_arithmetic(Fold_Operator operator, Vector *params)
+{
+    AST_Node *roots[2] = { NULL, NULL }; // the result so far and the next operand
+    gc_push_values(roots, 2);
+
+    size_t operands_count = VectorLength(params);
+    bool folded = true;
+    if (operands_count == 0)
+    {
+        roots[0] = value_from_fixnum(operator == FOLD_MULTIPLY ? 1 : 0);
+    }
+    else
+    {
+        roots[0] = value_from_literal(*(AST_Node **)VectorNth(params, 0));
+    }
+
+    if (operands_count == 1 && operator == FOLD_SUBTRACT) roots[0] = number_negate(roots[0]);
+    if (operands_count == 1 && operator == FOLD_DIVIDE)
+    {
+        // division by zero is raised when evaluated
+        if (value_to_double(roots[0]) == 0) folded = false;
+        else roots[0] = number_divide(value_from_fixnum(1), roots[0]);
+    }
+
+    for (size_t i = 1; i < operands_count && folded == true; i++)
+    {
+        roots[1] = value_from_literal(*(AST_Node **)VectorNth(params, i));
+        if (operator == FOLD_ADD) roots[0] = number_add(roots[0], roots[1]);
+        if (operator == FOLD_SUBTRACT) roots[0] = number_subtract(roots[0], roots[1]);
+        if (operator == FOLD_MULTIPLY) roots[0] = number_multiply(roots[0], roots[1]);
+        if (operator == FOLD_DIVIDE)
+        {
+            if (value_to_double(roots[1]) == 0) folded = false;
+            else roots[0] = number_divide(roots[0], roots[1]);
+        }
+    }
+
+    AST_Node *result = folded == true ? number_node_from_value(roots[0]) : NULL;
+    gc_pop(1);
+    return result;
+}
+
+static AST_Node *fold_comparison(Fold_Operator operator, Vector *params)
+{
+    AST_Node *roots[2] = { NULL, NULL }; // the previous operand and the current one
+    gc_push_values(roots, 2);
+
+    // every pair of neighbours must be in order, a NaN is in no order
+    Boolean_Type result = R_TRUE;
+    roots[0] = value_from_literal(*(AST_Node **)VectorNth(params, 0));
+    for (size_t i = 1; i < VectorLength(params); i++)
+    {
+        roots[1] = value_from_literal(*(AST_Node **)VectorNth(params, i));
+        int order = number_compare(roots[0], roots[1]);
+        bool holds = false;
+        if (operator == FOLD_EQUAL) holds = order == 0;
+        if (operator == FOLD_LESS) holds = order == -1;
+        if (operator == FOLD_MORE) holds = order == 1;
+        if (operator == FOLD_LESS_OR_EQUAL) holds = order == -1 || order == 0;
+        if (operator == FOLD_MORE_OR_EQUAL) holds = order == 1 || order == 0;
+        if (holds == false) result = R_FALSE;
+        roots[0] = roots[1];
+    }
+
+    gc_pop(1);
+    return ast_node_new(IN_AST, Boolean_Literal, &result);
+}
+
+static AST_Node *fold_identity(Fold_Operator operator, AST_Node *call)
+{
+    Vector *params = call->contents.call_expression.params;
+    if (VectorLength(params) != 2) return NULL;
+
+    AST_Node *left = *(AST_Node **)VectorNth(params, 0);
+    AST_Node *right = *(AST_Node **)VectorNth(params, 1);
+    AST_Node *kept = NULL;
+    AST_Node *identity = NULL;
+
+    if (operator == FOLD_ADD || operator == FOLD_SUBTRACT || operator == FOLD_MULTIPLY || operator == FOLD_DIVIDE)
+    {
+        long long int unit = operator == FOLD_ADD || operator == FOLD_SUBTRACT ? 0 : 1;
+        bool commutative = operator == FOLD_ADD || operator == FOLD_MULTIPLY;
+        if (is_exact_integer(right, unit) && is_number(left))
+        {
+            kept = left;
+            identity = right;
+        }
+        else if (commutative && is_exact_integer(left, unit) && is_number(right))
+        {
+            kept = right;
+            identity = left;
+        }
+    }
+
+    if (kept == NULL) return NULL;
+
+    VectorFree(call_take_params(call), NULL, NULL);
+    ast_node_free(identity);
+    ast_node_free(call);
+    return kept;
+}
+
+// (not expr) is a form, not a call of a built-in, so it can not be shadowed
+static AST_Node *fold_not(AST_Node *not_form)
+{
+    AST_Node *expr = not_form->contents.conditional_form.contents.not_expression.expr;
+    if (expr == NULL || is_literal(expr) == false) return NULL;
+
+    Boolean_Type result = R_FALSE;
+    if (expr->type == Boolean_Literal && *(Boolean_Type *)(expr->contents.literal.value) == R_FALSE) result = R_TRUE;
+    ast_node_free(not_form);
+    return ast_node_new(IN_AST, Boolean_Literal, &result);
+}
+
+// a literal for an integer or a flonum, NULL for a rational which has no literal
+static AST_Node *number_node_from_value(AST_Node *value)
+{
+    if (value_is_fixnum(value))
+        return ast_node_new(IN_AST, Number_Literal, NULL, EXACT, bignum_from_integer(value_to_fixnum(value)));
+    if (value_is_flonum(value))
+        return ast_node_new(IN_AST, Number_Literal, NULL, INEXACT, value_to_flonum(value));
+    if (value_is_bignum(value))
+        return ast_node_new(IN_AST, Number_Literal, NULL, EXACT, bignum_copy(value_to_bignum(value)));
+    return NULL;
+}
+
+static bool is_literal(AST_Node *node)
+{
+    return node->type == Number_Literal || node->type == String_Literal || node->type == Character_Literal ||
+           node->type == List_Literal || node->type == Pair_Literal || node->type == Vector_Literal ||
+           node->type == Boolean_Literal || node->type == NULL_Expression || node->type == EMPTY_Expression;
+}
+
+// evaluates to a number or raises the error of an arithmetic built-in, a variable may hold anything
+static bool is_number(AST_Node *node)
+{
+    if (node->type == Number_Literal) return true;
+    if (node->type != Call_Expression) return false;
+
+    Fold_Operator operator = fold_operator(node);
+    return operator == FOLD_ADD || operator == FOLD_SUBTRACT || operator == FOLD_MULTIPLY || operator == FOLD_DIVIDE;
+}
+
+static bool is_exact_integer(AST_Node *node, long long int n)
+{
+    if (node->type != Number_Literal || node->contents.literal.exactness != EXACT) return false;
+
+    long long int integer = 0;
+    return bignum_to_integer(TYPECAST(Bignum *, node->contents.literal.c_native_value), &integer) == true && integer == n;
+}
+
+// moves the params out of call, so they outlive it in the folded node
+static Vector *call_take_params(AST_Node *call)
+{
+    Vector *params = call->contents.call_expression.params;
+    call->contents.call_expression.params = VectorNew(sizeof(AST_Node *));
+    return params;
+}
@@ -1,7 +1,14 @@
 #include "../include/global.h"
 #include "../include/parser.h"
+#include "../include/environment.h"
+#include "../include/vm.h"
+#include "../include/value.h"
+#include "../include/gc.h"
 #include "../include/tokenizer.h"
 #include "../include/vector.h"
+#include "../include/bignum.h"
+#include "../include/flvector.h"
+#include "../include/hash_table.h"
 #include <stdlib.h>
 #include <stdarg.h>
 #include <string.h>
@@ -11,6 +18,11 @@ static AST_Node *walk(Tokens *tokens, size_t *current_p);
 static void visitor_free_helper(void *value_addr, size_t index, Vector *vector, void *aux_data);
 static void traverser_helper(AST_Node *node, AST_Node *parent, Visitor visitor, void *aux_data);
 static void set_tag_rec_visitor_helper(AST_Node *node, AST_Node *parent, void *aux);
+static void *node_alloc(AST_Node *ast_node, size_t size);
+static Bignum *node_copy_bignum(AST_Node *ast_node, Bignum *n);
+
+// set while parser() runs, every node it creates comes from here instead of malloc
+static Arena *node_arena = NULL;
 
 /*
     ast_node_new(tag, Program, body/NULL, built_in_bindings/NULL, addon_bindings/NULL)
@@ -19,8 +31,15 @@ static void set_tag_rec_visitor_helper(AST_Node *node, AST_Node *parent, void *a
     ast_node_new(tag, Local_Binding_Form, DEFINE, unsigned char *name, AST_Node *value)
     ast_node_new(tag, Local_Binding_Form, LET/LET_STAR/LETREC, bindings/NULL, body_exprs/NULL)
     ast_node_new(tag, Binding, name, AST_Node *value/NULL)
-    ast_node_new(tag, List or Pair, Vector *value/NULL)
+    ast_node_new(tag, List or Pair or Vector_Literal, Vector *value/NULL)
+    ast_node_new(tag, Pair, car, cdr)
+    ast_node_new(tag, Rational, numerator, denominator)
+    ast_node_new(tag, Flvector, size_t length), the elements are 0.0
+    ast_node_new(tag, Racket_Vector, size_t length, AST_Node *fill), fill must be rooted by the caller
+    ast_node_new(tag, Racket_Hash, Hash_Table *table, AST_Node *root, size_t length), the table is taken over, NULL for an immutable hash
+    ast_node_new(tag, Hash_Node, uint32_t bitmap, size_t length), the slots are NULL
     ast_node_new(tag, xxx_Literal, value)
+    ast_node_new(tag, Number_Literal, NULL, EXACT, Bignum *) or (tag, Number_Literal, NULL, INEXACT, double), the bignum is taken over
     ast_node_new(tag, Procedure, name/NULL, required_params_count, params, body_exprs, c_native_function/NULL)
     ast_node_new(tag, Conditional_Form, Conditional_Form_Type, ...)
     ast_node_new(tag, Conditional_Form, IF, test_expr, then_expr, else_expr)
@@ -38,7 +57,22 @@ static void set_tag_rec_visitor_helper(AST_Node *node, AST_Node *parent, void *a
 */
 AST_Node *ast_node_new(AST_Node_Tag tag, AST_Node_Type type, ...)
 {
-    AST_Node *ast_node = (AST_Node *)malloc(sizeof(AST_Node));
+    AST_Node *ast_node = NULL;
+    if (node_arena != NULL)
+    {
+        ast_node = (AST_Node *)arena_alloc(node_arena, sizeof(AST_Node));
+        ast_node->storage = ARENA_STORAGE;
+    }
+    else if (tag == NOT_IN_AST)
+    {
+        ast_node = gc_alloc();
+        ast_node->storage = GC_STORAGE;
+    }
+    else
+    {
+        ast_node = (AST_Node *)malloc(sizeof(AST_Node));
+        ast_node->storage = MALLOC_STORAGE;
+    }
     ast_node->tag = tag;
     ast_node->type = type;
     ast_node->parent = NULL;
@@ -61,6 +95,9 @@ AST_Node *ast_node_new(AST_Node_Tag tag, AST_Node_Type type, ...)
         ast_node->contents.program.body = body;
         ast_node->contents.program.built_in_bindings = built_in_bindings;
         ast_node->contents.program.addon_bindings = addon_bindings;
+        ast_node->contents.program.environment = NULL;
+        ast_node->contents.program.global_table = symbol_table_new();
+        ast_node->contents.program.arena = NULL;
     }
 
     if (ast_node->type == Call_Expression)
@@ -73,13 +110,13 @@ AST_Node *ast_node_new(AST_Node_Tag tag, AST_Node_Type type, ...)
         }
         else if (name != NULL)
         {
-            ast_node->contents.call_expression.name = (unsigned char *)malloc(strlen((const char *)name) + 1);
-            strcpy(TYPECAST(char *, ast_node->contents.call_expression.name), TYPECAST(const char *, name));
+            ast_node->contents.call_expression.name = symbol_intern(name);
         }
         ast_node->contents.call_expression.anonymous_procedure = va_arg(ap, AST_Node *);
         Vector *params = va_arg(ap, Vector *);
         if (params == NULL) params = VectorNew(sizeof(AST_Node *));
         ast_node->contents.call_expression.params = params;
+        ast_node->contents.call_expression.address = (Lexical_Address){ false, 0, 0 };
     }
 
     if (ast_node->type == Procedure)
@@ -96,6 +133,10 @@ AST_Node *ast_node_new(AST_Node_Tag tag, AST_Node_Type type, ...)
         ast_node->contents.procedure.params = va_arg(ap, Vector *);
         ast_node->contents.procedure.body_exprs = va_arg(ap, Vector *);
         ast_node->contents.procedure.c_native_function = va_arg(ap, Function);
+        ast_node->contents.procedure.c_native_binary_function = NULL;
+        ast_node->contents.procedure.environment = NULL;
+        ast_node->contents.procedure.code = NULL;
+        ast_node->contents.procedure.frame_length = 0;
     }
 
     if (ast_node->type == Lambda_Form)
@@ -103,6 +144,7 @@ AST_Node *ast_node_new(AST_Node_Tag tag, AST_Node_Type type, ...)
         matched = true;
         ast_node->contents.lambda_form.params = va_arg(ap, Vector *);
         ast_node->contents.lambda_form.body_exprs = va_arg(ap, Vector *);
+        ast_node->contents.lambda_form.code = NULL;
     }
 
     if (ast_node->type == Local_Binding_Form)
@@ -190,9 +232,9 @@ AST_Node *ast_node_new(AST_Node_Tag tag, AST_Node_Type type, ...)
     {
         matched = true;
         const unsigned char *name = va_arg(ap, const unsigned char *);
-        ast_node->contents.binding.name = (unsigned char *)malloc(strlen((const char *)name) + 1);
-        strcpy(TYPECAST(char *, ast_node->contents.binding.name), TYPECAST(const char *, name));
+        ast_node->contents.binding.name = symbol_intern(name);
         ast_node->contents.binding.value = va_arg(ap, AST_Node *);
+        ast_node->contents.binding.address = (Lexical_Address){ false, 0, 0 };
     }
 
     if (ast_node->type == List_Literal)
@@ -202,6 +244,7 @@ AST_Node *ast_node_new(AST_Node_Tag tag, AST_Node_Type type, ...)
         if (value == NULL) value = VectorNew(sizeof(AST_Node *));
         ast_node->contents.literal.value = value; 
         ast_node->contents.literal.c_native_value = NULL;
+        ast_node->contents.literal.constant = NULL;
     }
 
     if (ast_node->type == Pair_Literal)
@@ -211,56 +254,152 @@ AST_Node *ast_node_new(AST_Node_Tag tag, AST_Node_Type type, ...)
         if (value == NULL) value = VectorNew(sizeof(AST_Node *));
         ast_node->contents.literal.value = value; 
         ast_node->contents.literal.c_native_value = NULL;
+        ast_node->contents.literal.constant = NULL;
+    }
+
+    if (ast_node->type == Vector_Literal)
+    {
+        matched = true;
+        Vector *value = va_arg(ap, Vector *);
+        if (value == NULL) value = VectorNew(sizeof(AST_Node *));
+        ast_node->contents.literal.value = value; 
+        ast_node->contents.literal.c_native_value = NULL;
+        ast_node->contents.literal.constant = NULL;
     }
 
     if (ast_node->type == Number_Literal)
     {
         matched = true;
         const unsigned char *value = va_arg(ap, const unsigned char *);
-        ast_node->contents.literal.value = malloc(strlen((const char *)value) + 1);
-        strcpy(TYPECAST(char *, ast_node->contents.literal.value), TYPECAST(const char *, value));
-        // check '.' to decide use int or double
-        if (strchr(ast_node->contents.literal.value, '.') == NULL)
+        if (value == NULL)
+        {
+            // native already, nothing is parsed
+            ast_node->contents.literal.value = NULL;
+            ast_node->contents.literal.exactness = va_arg(ap, Exactness_Type);
+            if (ast_node->contents.literal.exactness == EXACT)
+            {
+                Bignum *c_native_value = va_arg(ap, Bignum *);
+                ast_node->contents.literal.c_native_value = node_copy_bignum(ast_node, c_native_value);
+            }
+            else
+            {
+                double c_native_value = va_arg(ap, double);
+                ast_node->contents.literal.c_native_value = node_alloc(ast_node, sizeof(double));
+                memcpy(ast_node->contents.literal.c_native_value, &c_native_value, sizeof(double));
+            }
+        }
+        // check '.' to decide use int or double, the only time the text is looked at
+        else if (strchr(TYPECAST(const char *, value), '.') == NULL)
         {
-            // convert string to long long int
-            long long int c_native_value = strtoll(ast_node->contents.literal.value, (char **)NULL, 10);
-            ast_node->contents.literal.c_native_value = malloc(sizeof(long long int));
-            memcpy(ast_node->contents.literal.c_native_value, &c_native_value, sizeof(long long int));
+            ast_node->contents.literal.value = node_alloc(ast_node, strlen((const char *)value) + 1);
+            strcpy(TYPECAST(char *, ast_node->contents.literal.value), TYPECAST(const char *, value));
+            ast_node->contents.literal.exactness = EXACT;
+            // convert string to bignum, demoted to a fixnum by value_from_literal() when it fits
+            ast_node->contents.literal.c_native_value = node_copy_bignum(ast_node, bignum_from_string(ast_node->contents.literal.value));
         }
         else
         {
+            ast_node->contents.literal.value = node_alloc(ast_node, strlen((const char *)value) + 1);
+            strcpy(TYPECAST(char *, ast_node->contents.literal.value), TYPECAST(const char *, value));
+            ast_node->contents.literal.exactness = INEXACT;
             // convert string to double
             double c_native_value = strtod(ast_node->contents.literal.value, (char **)NULL);
-            ast_node->contents.literal.c_native_value = malloc(sizeof(double));
+            ast_node->contents.literal.c_native_value = node_alloc(ast_node, sizeof(double));
             memcpy(ast_node->contents.literal.c_native_value, &c_native_value, sizeof(double));
         }
+        ast_node->contents.literal.constant = NULL;
     }
 
     if (ast_node->type == String_Literal)
     {
         matched = true;
         const unsigned char *value = va_arg(ap, const unsigned char *);
-        ast_node->contents.literal.value = malloc(strlen((const char *)value) + 1);
+        ast_node->contents.literal.value = node_alloc(ast_node, strlen((const char *)value) + 1);
         strcpy(TYPECAST(char *, ast_node->contents.literal.value), TYPECAST(const char *, value));
         ast_node->contents.literal.c_native_value = NULL;
+        ast_node->contents.literal.constant = NULL;
     }
 
     if (ast_node->type == Character_Literal)
     {
         matched = true;
         const unsigned char *character = va_arg(ap, const unsigned char *);
-        ast_node->contents.literal.value = malloc(sizeof(unsigned char));
+        ast_node->contents.literal.value = node_alloc(ast_node, sizeof(unsigned char));
         memcpy(ast_node->contents.literal.value, character, sizeof(unsigned char));
         ast_node->contents.literal.c_native_value = NULL;
+        ast_node->contents.literal.constant = NULL;
     }
 
     if (ast_node->type == Boolean_Literal)
     {
         matched = true;
         Boolean_Type *value = va_arg(ap, Boolean_Type *);
-        ast_node->contents.literal.value = malloc(sizeof(Boolean_Type));
+        ast_node->contents.literal.value = node_alloc(ast_node, sizeof(Boolean_Type));
         memcpy(ast_node->contents.literal.value, value, sizeof(Boolean_Type));
         ast_node->contents.literal.c_native_value = NULL;
+        ast_node->contents.literal.constant = NULL;
+    }
+
+    if (ast_node->type == Pair)
+    {
+        matched = true;
+        ast_node->contents.pair.car = va_arg(ap, AST_Node *);
+        ast_node->contents.pair.cdr = va_arg(ap, AST_Node *);
+    }
+
+    if (ast_node->type == Rational)
+    {
+        matched = true;
+        ast_node->contents.rational.numerator = va_arg(ap, AST_Node *);
+        ast_node->contents.rational.denominator = va_arg(ap, AST_Node *);
+    }
+
+    if (ast_node->type == Flvector)
+    {
+        matched = true;
+        ast_node->contents.flvector.length = va_arg(ap, size_t);
+        ast_node->contents.flvector.elements = flvector_elements_new(ast_node->contents.flvector.length);
+    }
+
+    if (ast_node->type == Racket_Vector)
+    {
+        matched = true;
+        size_t length = va_arg(ap, size_t);
+        AST_Node *fill = va_arg(ap, AST_Node *);
+        AST_Node **elements = NULL;
+        if (length > 0)
+        {
+            elements = (AST_Node **)malloc(sizeof(AST_Node *) * length);
+            if (elements == NULL)
+            {
+                perror("ast_node_new(): malloc failed");
+                exit(EXIT_FAILURE);
+            }
+            for (size_t i = 0; i < length; i++) elements[i] = fill;
+        }
+        ast_node->contents.racket_vector.length = length;
+        ast_node->contents.racket_vector.elements = elements;
+    }
+
+    if (ast_node->type == Racket_Hash)
+    {
+        matched = true;
+        ast_node->contents.racket_hash.table = va_arg(ap, Hash_Table *);
+        ast_node->contents.racket_hash.root = va_arg(ap, AST_Node *);
+        ast_node->contents.racket_hash.length = va_arg(ap, size_t);
+    }
+
+    if (ast_node->type == Hash_Node)
+    {
+        matched = true;
+        ast_node->contents.hash_node.bitmap = TYPECAST(uint32_t, va_arg(ap, unsigned int));
+        ast_node->contents.hash_node.length = va_arg(ap, size_t);
+        ast_node->contents.hash_node.slots = (AST_Node **)calloc(ast_node->contents.hash_node.length * 2 + 1, sizeof(AST_Node *));
+        if (ast_node->contents.hash_node.slots == NULL)
+        {
+            perror("ast_node_new(): calloc failed");
+            exit(EXIT_FAILURE);
+        }
     }
 
     if (ast_node->type == NULL_Expression)
@@ -290,6 +429,8 @@ AST_Node *ast_node_new(AST_Node_Tag tag, AST_Node_Type type, ...)
 int ast_node_free(AST_Node *ast_node)
 {
     if (ast_node == NULL) return 1;
+    if (value_is_immediate(ast_node)) return 0; // nothing on the heap
+    if (ast_node->storage == GC_STORAGE) return 0; // may be shared, only the collector knows when it is dead
 
     bool matched = false;
 
@@ -308,6 +449,8 @@ int ast_node_free(AST_Node *ast_node)
         }
         VectorFree(body, NULL, NULL);
 
+        environment_release(ast_node->contents.program.environment);
+
         Vector *built_in_bindings = ast_node->contents.program.built_in_bindings;
         for (size_t i = 0; i < VectorLength(built_in_bindings); i++)
         {
@@ -323,6 +466,8 @@ int ast_node_free(AST_Node *ast_node)
             ast_node_free(binding);
         }
         VectorFree(addon_bindings, NULL, NULL);
+
+        symbol_table_free(ast_node->contents.program.global_table);
     }
 
     if (ast_node->type == Call_Expression)
@@ -337,8 +482,7 @@ int ast_node_free(AST_Node *ast_node)
         }
         VectorFree(params, NULL, NULL);
 
-        unsigned char *name = ast_node->contents.call_expression.name;
-        if (name != NULL) free(ast_node->contents.call_expression.name);
+        // name is interned, freed by symbols_free()
 
         AST_Node *anonymous_procedure = ast_node->contents.call_expression.anonymous_procedure;
         if (anonymous_procedure != NULL) ast_node_free(anonymous_procedure);
@@ -349,26 +493,8 @@ int ast_node_free(AST_Node *ast_node)
         matched = true;
         unsigned char *name = ast_node->contents.procedure.name;
         if (name != NULL) free(ast_node->contents.procedure.name);
-        Vector *params = ast_node->contents.procedure.params;
-        if (params != NULL)
-        {
-            for (size_t i = 0; i < VectorLength(params); i++)
-            {
-                AST_Node *param = *(AST_Node **)VectorNth(params, i);
-                ast_node_free(param);
-            }
-            VectorFree(params, NULL, NULL);
-        }
-        Vector *body_exprs = ast_node->contents.procedure.body_exprs;
-        if (body_exprs != NULL)
-        {
-            for (size_t i = 0; i < VectorLength(body_exprs); i++)
-            {
-                AST_Node *body_expr = *(AST_Node **)VectorNth(body_exprs, i);
-                ast_node_free(body_expr);
-            }
-            VectorFree(body_exprs, NULL, NULL);
-        }
+        // params and body_exprs are borrowed from the Lambda_Form, freed with it
+        environment_release(ast_node->contents.procedure.environment);
     }
 
     if (ast_node->type == Lambda_Form)
@@ -391,6 +517,8 @@ int ast_node_free(AST_Node *ast_node)
             ast_node_free(body_expr);
         }
         VectorFree(body_exprs, NULL, NULL);
+
+        chunk_free(ast_node->contents.lambda_form.code);
     }
 
     if (ast_node->type == Local_Binding_Form)
@@ -552,8 +680,7 @@ int ast_node_free(AST_Node *ast_node)
     if (ast_node->type == Binding)
     {
         matched = true;
-        unsigned char *name = ast_node->contents.binding.name;
-        if (name != NULL) free(name);
+        // name is interned, freed by symbols_free()
         AST_Node *value = ast_node->contents.binding.value;
         if (value != NULL) ast_node_free(value);
     }
@@ -582,29 +709,35 @@ int ast_node_free(AST_Node *ast_node)
         VectorFree(elements, NULL, NULL);
     }
 
-    if (ast_node->type == Number_Literal)
-    {
-        matched = true;
-        free(ast_node->contents.literal.value);
-        free(ast_node->contents.literal.c_native_value);
-    }
-
-    if (ast_node->type == String_Literal)
+    if (ast_node->type == Vector_Literal)
     {
         matched = true;
-        free(ast_node->contents.literal.value);
+        Vector *elements = TYPECAST(Vector *, ast_node->contents.literal.value);
+        for (size_t i = 0; i < VectorLength(elements); i++)
+        {
+            AST_Node *element = *(AST_Node **)VectorNth(elements, i);
+            ast_node_free(element);
+        }
+        VectorFree(elements, NULL, NULL);
     }
 
-    if (ast_node->type == Character_Literal)
+    // literal payloads of nodes in the AST arena are released with the arena
+    if (ast_node->type == Number_Literal)
     {
         matched = true;
-        free(ast_node->contents.literal.value);
+        if (ast_node->storage != ARENA_STORAGE)
+        {
+            free(ast_node->contents.literal.value);
+            free(ast_node->contents.literal.c_native_value);
+        }
     }
 
-    if (ast_node->type == Boolean_Literal)
+    if (ast_node->type == String_Literal ||
+        ast_node->type == Character_Literal ||
+        ast_node->type == Boolean_Literal)
     {
         matched = true;
-        free(ast_node->contents.literal.value);
+        if (ast_node->storage != ARENA_STORAGE) free(ast_node->contents.literal.value);
     }
 
     if (ast_node->type == NULL_Expression)
@@ -629,7 +762,7 @@ int ast_node_free(AST_Node *ast_node)
     }
 
     // free ast_node itself
-    free(ast_node);
+    if (ast_node->storage != ARENA_STORAGE) free(ast_node);
 
     return 0;
 }
@@ -648,13 +781,20 @@ AST_Node *ast_node_deep_copy(AST_Node *ast_node, void *aux_data)
         exit(EXIT_FAILURE); 
     }
 
+    if (value_is_immediate(ast_node)) return ast_node; // the word is the value
+
     AST_Node *copy = NULL;
     bool matched = false;
 
     if (ast_node->type == Number_Literal)
     {
         matched = true;
-        copy = ast_node_new(ast_node->tag, Number_Literal, ast_node->contents.literal.value);
+        if (ast_node->contents.literal.value != NULL)
+            copy = ast_node_new(ast_node->tag, Number_Literal, ast_node->contents.literal.value);
+        else if (ast_node->contents.literal.exactness == EXACT)
+            copy = ast_node_new(ast_node->tag, Number_Literal, NULL, EXACT, bignum_copy(ast_node->contents.literal.c_native_value));
+        else
+            copy = ast_node_new(ast_node->tag, Number_Literal, NULL, INEXACT, *(double *)(ast_node->contents.literal.c_native_value));
     }
 
     if (ast_node->type == String_Literal)
@@ -701,6 +841,22 @@ AST_Node *ast_node_deep_copy(AST_Node *ast_node, void *aux_data)
         copy = ast_node_new(ast_node->tag, Pair_Literal, value_copy);
     }
 
+    if (ast_node->type == Vector_Literal)
+    {
+        matched = true;
+        Vector *value = ast_node->contents.literal.value;
+        Vector *value_copy = VectorNew(sizeof(AST_Node *));
+
+        for (size_t i = 0; i < VectorLength(value); i++)
+        {
+            AST_Node *node = *(AST_Node **)VectorNth(value, i);
+            AST_Node *node_copy = ast_node_deep_copy(node, aux_data);
+            VectorAppend(value_copy, &node_copy);
+        }
+
+        copy = ast_node_new(ast_node->tag, Vector_Literal, value_copy);
+    }
+
     if (ast_node->type == Boolean_Literal)
     {
         matched = true;
@@ -733,7 +889,7 @@ AST_Node *ast_node_deep_copy(AST_Node *ast_node, void *aux_data)
         {
             matched = true;
             AST_Node *binding = ast_node->contents.local_binding_form.contents.define.binding;
-            unsigned char *name = binding->contents.binding.name;
+            const unsigned char *name = binding->contents.binding.name;
             AST_Node *value = binding->contents.binding.value;
 
             AST_Node *value_copy = ast_node_deep_copy(value, aux_data);
@@ -955,17 +1111,19 @@ AST_Node *ast_node_deep_copy(AST_Node *ast_node, void *aux_data)
         }
 
         copy = ast_node_new(ast_node->tag, Call_Expression, name, anonymous_procedure, params_copy);
+        copy->contents.call_expression.address = ast_node->contents.call_expression.address;
     }
 
     if (ast_node->type == Binding)
     {
         matched = true;
-        unsigned char *name = ast_node->contents.binding.name;
+        const unsigned char *name = ast_node->contents.binding.name;
         AST_Node *value = ast_node->contents.binding.value;
         AST_Node *value_copy = NULL;
         if (value != NULL) value_copy = ast_node_deep_copy(value, aux_data);
 
         copy = ast_node_new(ast_node->tag, Binding, name, value_copy);
+        copy->contents.binding.address = ast_node->contents.binding.address;
     }
 
     if (ast_node->type == Procedure)
@@ -981,28 +1139,15 @@ AST_Node *ast_node_deep_copy(AST_Node *ast_node, void *aux_data)
         {
             // built-in or addon procedure
             copy = ast_node_new(ast_node->tag, Procedure, name, required_params_count, NULL, NULL, c_native_function);
+            copy->contents.procedure.c_native_binary_function = ast_node->contents.procedure.c_native_binary_function;
         }
         else if (params != NULL && body_exprs != NULL && c_native_function == NULL)
         {
-            // user defined procedure
-            Vector *params_copy = VectorNew(sizeof(AST_Node *));
-            Vector *body_exprs_copy = VectorNew(sizeof(AST_Node *));
-            
-            for (size_t i = 0; i < VectorLength(params); i++)
-            {
-                AST_Node *node = *(AST_Node **)VectorNth(params, i);
-                AST_Node *node_copy = ast_node_deep_copy(node, aux_data);
-                VectorAppend(params_copy, &node_copy);
-            }
-    
-            for (size_t i = 0; i < VectorLength(body_exprs); i++)
-            {
-                AST_Node *node = *(AST_Node **)VectorNth(body_exprs, i);
-                AST_Node *node_copy = ast_node_deep_copy(node, aux_data);
-                VectorAppend(body_exprs_copy, &node_copy);
-            }
-    
-            copy = ast_node_new(ast_node->tag, Procedure, name, required_params_count, params_copy, body_exprs_copy, NULL);
+            // user defined procedure, params and body_exprs are shared, the copy keeps the closure alive
+            copy = ast_node_new(ast_node->tag, Procedure, name, required_params_count, params, body_exprs, NULL);
+            copy->contents.procedure.environment = environment_retain(ast_node->contents.procedure.environment);
+            copy->contents.procedure.code = ast_node->contents.procedure.code;
+            copy->contents.procedure.frame_length = ast_node->contents.procedure.frame_length;
         }
         else
         {
@@ -1066,12 +1211,14 @@ void ast_node_set_tag(AST_Node *ast_node, AST_Node_Tag tag)
         exit(EXIT_FAILURE);
     }
 
+    if (value_is_immediate(ast_node)) return;
     ast_node->tag = tag;
 }
 
 void ast_node_set_tag_recursive(AST_Node *ast_node, AST_Node_Tag tag)
 {
     ast_node_set_tag(ast_node, tag);
+    if (value_is_immediate(ast_node)) return;
     Visitor visitor = visitor_new();
 
     // generate handler for all type
@@ -1093,12 +1240,15 @@ AST_Node_Tag ast_node_get_tag(AST_Node *ast_node)
         exit(EXIT_FAILURE);
     }
 
+    if (value_is_immediate(ast_node)) return NOT_IN_AST;
     return ast_node->tag;
 }
 
 AST parser(Tokens *tokens)
 {
+    node_arena = arena_new();
     AST ast = ast_node_new(IN_AST, Program, NULL, NULL, NULL);
+    ast->contents.program.arena = node_arena;
     size_t current = 0;
 
     while (current < tokens_length(tokens))
@@ -1108,13 +1258,20 @@ AST parser(Tokens *tokens)
         if (ast_node != NULL) VectorAppend(ast->contents.program.body, &ast_node);
         else continue;
     }
+
+    // nodes created after parsing come from malloc, such as built-in bindings, or from the collector, runtime values
+    node_arena = NULL;
     
     return ast;
 }
 
 int ast_free(AST ast)
 {
-    return ast_node_free(ast);
+    // the nodes release what they own outside the arena first, such as vectors and chunks
+    Arena *arena = ast->contents.program.arena;
+    int error = ast_node_free(ast);
+    arena_free(arena);
+    return error;
 }
 
 Visitor visitor_new()
@@ -1821,6 +1978,28 @@ static AST_Node *walk(Tokens *tokens, size_t *current_p)
             return ast_node;
         }
 
+        // '#(' vector literal, an immutable vector of its elements
+        if (token_value == POUND)
+        {
+            // move to first element of vector or ) for #()
+            (*current_p)++;
+            token = tokens_nth(tokens, *current_p);
+            Vector *value = VectorNew(sizeof(AST_Node *));
+
+            while ((token->type != PUNCTUATION) ||
+                   (token->type == PUNCTUATION && (token->value)[0] != RIGHT_PAREN)
+            )
+            {
+                AST_Node *element = walk(tokens, current_p);
+                if (element != NULL) VectorAppend(value, &element);
+                token = tokens_nth(tokens, *current_p);
+            }
+
+            AST_Node *ast_node = ast_node_new(IN_AST, Vector_Literal, value);
+            (*current_p)++; // skip ')'
+            return ast_node;
+        }
+
         // handle PUNCTUATION ...
 
     }
@@ -1847,6 +2026,9 @@ static void traverser_helper(AST_Node *node, AST_Node *parent, Visitor visitor,
         return;
     }
 
+    // immediates only live in runtime values, they have no sub nodes and no fields to visit
+    if (value_is_immediate(node)) return;
+
     AST_Node_Handler *handler = find_ast_node_handler(visitor, node->type);
 
     if (handler == NULL)
@@ -2044,6 +2226,16 @@ static void traverser_helper(AST_Node *node, AST_Node *parent, Visitor visitor,
         }
     }
 
+    if (node->type == Vector_Literal)
+    {
+        Vector *value = TYPECAST(Vector *, node->contents.literal.value);
+        for (size_t i = 0; i < VectorLength(value); i++)
+        {
+            AST_Node *ast_node = *(AST_Node **)VectorNth(value, i);
+            traverser_helper(ast_node, node, visitor, aux_data);
+        }
+    }
+
     if (node->type == Binding)
     {
         AST_Node *value = node->contents.binding.value;
@@ -2061,4 +2253,22 @@ static void set_tag_rec_visitor_helper(AST_Node *node, AST_Node *parent, void *a
 {
     // inherit tag from parent
     ast_node_set_tag(node, *(AST_Node_Tag *)aux);
-}
\ No newline at end of file
+}
+
+// payloads of a node live as long as the node, so a node in the AST arena keeps them there too
+static void *node_alloc(AST_Node *ast_node, size_t size)
+{
+    if (ast_node->storage == ARENA_STORAGE) return arena_alloc(node_arena, size);
+    return malloc(size);
+}
+
+// n is taken over, a node in the AST arena gets a copy in the arena instead
+static Bignum *node_copy_bignum(AST_Node *ast_node, Bignum *n)
+{
+    if (ast_node->storage != ARENA_STORAGE) return n;
+
+    Bignum *copy = (Bignum *)node_alloc(ast_node, bignum_size(n));
+    memcpy(copy, n, bignum_size(n));
+    free(n);
+    return copy;
+}
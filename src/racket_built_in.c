@@ -1,34 +1,18 @@
 #include "../include/global.h"
 #include "../include/racket_built_in.h"
 #include "../include/interpreter.h"
+#include "../include/value.h"
+#include "../include/gc.h"
+#include "../include/number.h"
+#include "../include/flvector.h"
+#include "../include/hash_table.h"
+#include "../include/hamt.h"
+#include "../include/racket_unsafe.h"
 #include <stdio.h>
 #include <stdlib.h>
-#include <math.h>
 #include <string.h>
 #include <stdbool.h>
-
-#define DOUBLE_MAX_DIGIT_LENGTH ((size_t)512)
-
-static size_t int_digit_count(int num)
-{
-    size_t digit_count = 0;
-
-    if (num > 0)
-    {
-        digit_count = TYPECAST(size_t, (ceil(log10(num)) + 1) * sizeof(unsigned char));
-    }
-    else if (num < 0)
-    {
-        num = -num;
-        digit_count = 1 + TYPECAST(size_t, (ceil(log10(num)) + 1) * sizeof(unsigned char));
-    }
-    else if(num == 0)
-    {
-        digit_count = 1;
-    }
-    
-    return digit_count;
-}
+#include <math.h>
 
 static AST_Node *racket_native_addition(AST_Node *procedure, Vector *operands)
 {
@@ -44,75 +28,23 @@ static AST_Node *racket_native_addition(AST_Node *procedure, Vector *operands)
         exit(EXIT_FAILURE); 
     }
 
-    struct {
-        bool is_int;
-        union {
-            long long int iv;
-            double dv;
-        } value;
-    } result = {
-        .is_int = true,
-        .value.iv = 0
-    };
+    // fixnums and flonums are immediates, no allocation unless the integer leaves the fixnum range
+    AST_Node *result = value_from_fixnum(0);
 
     for (size_t i = 0; i < operands_count; i++)
     {
-        const AST_Node *operand = *(AST_Node **)VectorNth(operands, i);
+        AST_Node *operand = *(AST_Node **)VectorNth(operands, i);
 
-        if (operand->type != Number_Literal)
+        if (value_type(operand) != Number_Literal)
         {
             fprintf(stderr, "#<procedure:%s>: operands must be number\n", procedure->contents.procedure.name);
             exit(EXIT_FAILURE); 
         }
 
-        bool cur_operand_is_int = false;
-        if (strchr(operand->contents.literal.value, '.') == NULL) cur_operand_is_int = true;
-
-        if (cur_operand_is_int == true)
-        {
-            long long int c_native_value = *(long long int *)(operand->contents.literal.c_native_value);
-            if (result.is_int == true)
-            {
-                result.value.iv += c_native_value;
-            }
-            else
-            {
-                result.value.dv += c_native_value;
-            }
-        }
-        else
-        {
-            double c_native_value = *(double *)(operand->contents.literal.c_native_value);
-            if (result.is_int == true)
-            {
-                result.is_int = false;
-                double tmp = TYPECAST(double, result.value.iv);
-                result.value.dv = tmp + c_native_value;
-            }
-            else
-            {
-                result.value.dv += c_native_value;
-            }
-        }
+        result = number_add(result, operand);
     }
 
-    unsigned char *value = NULL;
-    if (result.is_int == true)
-    {
-        // convert int to string.
-        value = malloc(int_digit_count(result.value.iv) + 1);
-        sprintf(TYPECAST(char *, value), "%lld", result.value.iv);
-    }
-    else
-    {
-        // convert double to string
-        value = malloc(DOUBLE_MAX_DIGIT_LENGTH + 1);
-        sprintf(TYPECAST(char *, value), "%lf", result.value.dv);
-    }
-    
-    AST_Node *ast_node = ast_node_new(NOT_IN_AST, Number_Literal, value);
-    free(value);
-    return ast_node;
+    return result;
 }
 
 static AST_Node *racket_native_subtraction(AST_Node *procedure, Vector *operands)
@@ -129,110 +61,31 @@ static AST_Node *racket_native_subtraction(AST_Node *procedure, Vector *operands
         exit(EXIT_FAILURE); 
     }
 
-    const AST_Node *minuend = *(AST_Node **)VectorNth(operands, 0);
-    if (minuend->type != Number_Literal)
+    AST_Node *minuend = *(AST_Node **)VectorNth(operands, 0);
+    if (value_type(minuend) != Number_Literal)
     {
         fprintf(stderr, "#<procedure:%s>: operands must be number\n", procedure->contents.procedure.name);
         exit(EXIT_FAILURE); 
     }
 
-    struct {
-        bool is_int;
-        union {
-            long long int iv;
-            double dv;
-        } value;
-    } result = {
-        .is_int = true,
-        .value.iv = 0
-    };
+    if (operands_count == 1) return number_negate(minuend);
 
-    if (strchr(minuend->contents.literal.value, '.') == NULL)
-    {
-        // minuend is int.
-        long long int c_native_value = *(long long int *)(minuend->contents.literal.c_native_value);
-        if (operands_count != 1)
-        {
-            result.value.iv = c_native_value;
-        }
-        else
-        {
-            result.value.iv = 0 - c_native_value;
-        }
-    }
-    else
-    {
-        // minuend is double.
-        result.is_int = false;
-        double c_native_value = *(double *)(minuend->contents.literal.c_native_value);
-        if (operands_count != 1)
-        {
-            result.value.dv = c_native_value;
-        }
-        else
-        {
-            result.value.dv = -c_native_value;
-        }
-    }
+    AST_Node *result = minuend;
 
     for (size_t i = 1; i < operands_count; i++)
     {
-        const AST_Node *subtrahend = *(AST_Node **)VectorNth(operands, i); 
+        AST_Node *subtrahend = *(AST_Node **)VectorNth(operands, i); 
 
-        if (subtrahend->type != Number_Literal)
+        if (value_type(subtrahend) != Number_Literal)
         {
             fprintf(stderr, "#<procedure:%s>: operands must be number\n", procedure->contents.procedure.name);
             exit(EXIT_FAILURE); 
         }
 
-        bool cur_operand_is_int = false;
-        if (strchr(subtrahend->contents.literal.value, '.') == NULL) cur_operand_is_int = true;
-
-        if (cur_operand_is_int == true)
-        {
-            long long int c_native_value = *(long long int *)(subtrahend->contents.literal.c_native_value);
-            if (result.is_int == true)
-            {
-                result.value.iv -= c_native_value;
-            }
-            else
-            {
-                result.value.dv -= c_native_value;
-            }
-        }
-        else
-        {
-            double c_native_value = *(double *)(subtrahend->contents.literal.c_native_value);
-            if (result.is_int == true)
-            {
-                result.is_int = false;
-                double tmp = TYPECAST(double, result.value.iv);
-                result.value.dv = tmp - c_native_value;
-            }
-            else
-            {
-                result.value.dv -= c_native_value;
-            }
-        }
+        result = number_subtract(result, subtrahend);
     }
 
-    unsigned char *value = NULL;
-    if (result.is_int == true)
-    {
-        // convert int to string.
-        value = malloc(int_digit_count(result.value.iv) + 1);
-        sprintf(TYPECAST(char *, value), "%lld", result.value.iv);
-    }
-    else
-    {
-        // convert double to string
-        value = malloc(DOUBLE_MAX_DIGIT_LENGTH + 1);
-        sprintf(TYPECAST(char *, value), "%lf", result.value.dv);
-    }
-    
-    AST_Node *ast_node = ast_node_new(NOT_IN_AST, Number_Literal, value);
-    free(value);
-    return ast_node;
+    return result;
 }
 
 static AST_Node *racket_native_multiplication(AST_Node *procedure, Vector *operands)
@@ -249,75 +102,23 @@ static AST_Node *racket_native_multiplication(AST_Node *procedure, Vector *opera
         exit(EXIT_FAILURE); 
     }
 
-    struct {
-        bool is_int;
-        union {
-            long long int iv;
-            double dv;
-        } value;
-    } result = {
-        .is_int = true,
-        .value.iv = 1 
-    };
+    AST_Node *result = value_from_fixnum(1);
 
     for (size_t i = 0; i < operands_count; i++)
     {
-        const AST_Node *operand = *(AST_Node **)VectorNth(operands, i);
+        AST_Node *operand = *(AST_Node **)VectorNth(operands, i);
 
-        if (operand->type != Number_Literal)
+        if (value_type(operand) != Number_Literal)
         {
             fprintf(stderr, "#<procedure:%s>: operands must be number\n", procedure->contents.procedure.name);
             exit(EXIT_FAILURE); 
         }
 
-        bool cur_operand_is_int = false;
-        if (strchr(operand->contents.literal.value, '.') == NULL) cur_operand_is_int = true;
-
-        if (cur_operand_is_int == true)
-        {
-            long long int c_native_value = *(long long int *)(operand->contents.literal.c_native_value);
-            if (result.is_int == true)
-            {
-                result.value.iv *= c_native_value;
-            }
-            else
-            {
-                result.value.dv *= c_native_value;
-            }
-        }
-        else
-        {
-            double c_native_value = *(double *)(operand->contents.literal.c_native_value);
-            if (result.is_int == true)
-            {
-                result.is_int = false;
-                double tmp = TYPECAST(double, result.value.iv);
-                result.value.dv = tmp * c_native_value;
-            }
-            else
-            {
-                result.value.dv *= c_native_value;
-            }
-        }
+        // the product is checked, it becomes a bignum instead of overflowing
+        result = number_multiply(result, operand);
     }
 
-    unsigned char *value = NULL;
-    if (result.is_int == true)
-    {
-        // convert int to string.
-        value = malloc(int_digit_count(result.value.iv) + 1);
-        sprintf(TYPECAST(char *, value), "%lld", result.value.iv);
-    }
-    else
-    {
-        // convert double to string
-        value = malloc(DOUBLE_MAX_DIGIT_LENGTH + 1);
-        sprintf(TYPECAST(char *, value), "%lf", result.value.dv);
-    }
-    
-    AST_Node *ast_node = ast_node_new(NOT_IN_AST, Number_Literal, value);
-    free(value);
-    return ast_node;
+    return result;
 }
 
 static AST_Node *racket_native_division(AST_Node *procedure, Vector *operands)
@@ -334,78 +135,47 @@ static AST_Node *racket_native_division(AST_Node *procedure, Vector *operands)
         exit(EXIT_FAILURE); 
     }
 
-    const AST_Node *dividend = *(AST_Node **)VectorNth(operands, 0);
-    if (dividend->type != Number_Literal)
+    AST_Node *dividend = *(AST_Node **)VectorNth(operands, 0);
+    if (value_type(dividend) != Number_Literal)
     {
         fprintf(stderr, "#<procedure:%s>: operands must be number\n", procedure->contents.procedure.name);
         exit(EXIT_FAILURE); 
     }
     
-    double result = 0.0;
-
-    double dividend_value = 0.0;
-    if (strchr(dividend->contents.literal.value, '.') == NULL)
-    {
-        dividend_value = *(long long int *)(dividend->contents.literal.c_native_value);
-    }
-    else
-    {
-        dividend_value = *(double *)(dividend->contents.literal.c_native_value);
-    }
-
     if (operands_count == 1)
     {
-        if (dividend_value == 0)
+        if (value_to_double(dividend) == 0)
         {
             fprintf(stderr, "/: division by zero\n");
             exit(EXIT_FAILURE); 
         }
 
-        result = 1 / dividend_value;
-    }
-    else
-    {
-        result = dividend_value;
+        return number_divide(value_from_fixnum(1), dividend);
     }
-    
+
+    AST_Node *result = dividend;
 
     for (size_t i = 1; i < operands_count; i++)
     {
-        const AST_Node *divisor = *(AST_Node **)VectorNth(operands, i); 
+        AST_Node *divisor = *(AST_Node **)VectorNth(operands, i); 
 
-        if (divisor->type != Number_Literal)
+        if (value_type(divisor) != Number_Literal)
         {
             fprintf(stderr, "#<procedure:%s>: operands must be number\n", procedure->contents.procedure.name);
             exit(EXIT_FAILURE); 
         }
 
-        double c_native_value = 0.0;
-        if (strchr(divisor->contents.literal.value, '.') == NULL)
-        {
-            c_native_value = *(long long int *)(divisor->contents.literal.c_native_value);
-        }
-        else
-        {
-            c_native_value = *(double *)(divisor->contents.literal.c_native_value);
-        }
-
-        if (c_native_value == 0)
+        if (value_to_double(divisor) == 0)
         {
             fprintf(stderr, "/: division by zero\n");
             exit(EXIT_FAILURE); 
         }
 
-        result /= c_native_value;
+        // exact operands stay exact, (/ 1 3) is 1/3
+        result = number_divide(result, divisor);
     }
 
-    unsigned char *value = NULL;
-    // convert double to string
-    value = malloc(DOUBLE_MAX_DIGIT_LENGTH + 1);
-    sprintf(TYPECAST(char *, value), "%lf", result);
-    
-    AST_Node *ast_node = ast_node_new(NOT_IN_AST, Number_Literal, value);
-    free(value);
-    return ast_node;
+    return result;
 }
 
 // (= z w ...) -> boolean?
@@ -423,95 +193,32 @@ static AST_Node *racket_native_number_equal(AST_Node *procedure, Vector *operand
         exit(EXIT_FAILURE); 
     }
 
-    const AST_Node *pre_number = *(AST_Node **)VectorNth(operands, 0); 
-    if (pre_number->type != Number_Literal)
+    AST_Node *pre_number = *(AST_Node **)VectorNth(operands, 0); 
+    if (value_type(pre_number) != Number_Literal)
     {
         fprintf(stderr, "#<procedure:%s>: operands must be number\n", procedure->contents.procedure.name);
         exit(EXIT_FAILURE); 
     }
 
-    struct {
-        union {
-            int int_val;
-            double double_val;
-        } contents;
-        bool is_int;
-    } pre, cur;
-    
-    if (strchr(pre_number->contents.literal.value, '.') == NULL)
-    {
-        pre.contents.int_val = *(int *)(pre_number->contents.literal.c_native_value);
-        pre.is_int = true;
-    }
-    else
-    {
-        pre.contents.double_val = *(double *)(pre_number->contents.literal.c_native_value);
-        pre.is_int = false;
-    }
-
-    Boolean_Type *result = malloc(sizeof(Boolean_Type));
-    *result = R_TRUE; // true by default.
+    Boolean_Type result = R_TRUE; // true by default.
 
     for (size_t i = 1; i < VectorLength(operands); i++)
     {
         AST_Node *cur_number = *(AST_Node **)VectorNth(operands, i); 
 
-        if (cur_number->type != Number_Literal)
+        if (value_type(cur_number) != Number_Literal)
         {
             fprintf(stderr, "#<procedure:%s>: operands must be number\n", procedure->contents.procedure.name);
             exit(EXIT_FAILURE); 
         }
 
-        if (strchr(cur_number->contents.literal.value, '.') == NULL)
-        {
-            cur.contents.int_val = *(int *)(cur_number->contents.literal.c_native_value);
-            cur.is_int = true;
-        }
-        else
-        {
-            cur.contents.double_val = *(double *)(cur_number->contents.literal.c_native_value);
-            cur.is_int = false;
-        }
-
-        if (cur.is_int == true && pre.is_int == true)
-        {
-            if (cur.contents.int_val != pre.contents.int_val) *result = R_FALSE;
-            #ifdef DEBUG_MODE
-            // printf("pre: %d, cur: %d\n", pre.contents.int_val, cur.contents.int_val);
-            #endif
-            pre.contents.int_val = cur.contents.int_val;
-        }
-        else if (cur.is_int == true && pre.is_int == false)
-        {
-            if (cur.contents.int_val != pre.contents.double_val) *result = R_FALSE;
-            #ifdef DEBUG_MODE
-            // printf("pre: %f, cur: %d\n", pre.contents.double_val, cur.contents.int_val);
-            #endif
-            pre.contents.int_val = cur.contents.int_val;
-        }
-        else if (cur.is_int == false && pre.is_int == true)
-        {
-            if (cur.contents.double_val != pre.contents.int_val) *result = R_FALSE;
-            #ifdef DEBUG_MODE
-            // printf("pre: %d, cur: %f\n", pre.contents.int_val, cur.contents.double_val);
-            #endif
-            pre.contents.double_val = cur.contents.double_val;
-        }
-        else if (cur.is_int == false && pre.is_int == false)
-        {
-            if (cur.contents.double_val != pre.contents.double_val) *result = R_FALSE;
-            #ifdef DEBUG_MODE
-            // printf("pre: %f, cur: %f\n", pre.contents.double_val, cur.contents.double_val);
-            #endif
-            pre.contents.double_val = cur.contents.double_val;
-        }
-
-        pre.is_int = cur.is_int;
+        // NaN is unordered, it equals nothing
+        int order = number_compare(pre_number, cur_number);
+        if (order != 0) result = R_FALSE;
+        pre_number = cur_number;
     }
 
-    AST_Node *ast_node = ast_node_new(NOT_IN_AST, Boolean_Literal, result);
-    free(result);
-    return ast_node;
+    return value_from_boolean(result);
 }
 
 // (map fn list ...)
@@ -531,7 +238,7 @@ static AST_Node *racket_native_map(AST_Node *procedure, Vector *operands)
 
     // check procedure
     AST_Node *fn = *(AST_Node **)VectorNth(operands, 0);
-    if (fn->type != Procedure)
+    if (value_type(fn) != Procedure)
     {
         fprintf(stderr, "%s: parameter's type is incorrecly\n", procedure->contents.procedure.name);
         exit(EXIT_FAILURE); 
@@ -539,26 +246,26 @@ static AST_Node *racket_native_map(AST_Node *procedure, Vector *operands)
 
     // the rest of operands must be list
     AST_Node *first_list = *(AST_Node **)VectorNth(operands, 1); 
-    if (first_list->type != List_Literal)
+    if (value_is_list(first_list) == false)
     {
         fprintf(stderr, "%s: parameter's type is incorrecly\n", procedure->contents.procedure.name);
         exit(EXIT_FAILURE); 
     }
 
-    size_t list_length = VectorLength(TYPECAST(Vector *, first_list->contents.literal.value));
+    size_t list_length = value_list_length(first_list);
 
     for (size_t i = 1; i < VectorLength(operands); i++)
     {
         // check list
         AST_Node *list = *(AST_Node **)VectorNth(operands, i);
-        if (list->type != List_Literal)
+        if (value_is_list(list) == false)
         {
             fprintf(stderr, "%s: parameter's type is incorrecly\n", procedure->contents.procedure.name);
             exit(EXIT_FAILURE); 
         }
 
         // check list size
-        size_t cur_list_length = VectorLength(TYPECAST(Vector *, list->contents.literal.value));
+        size_t cur_list_length = value_list_length(list);
         if (list_length != cur_list_length)
         {
             fprintf(stderr, "%s: all lists must have same size\n", procedure->contents.procedure.name);
@@ -567,6 +274,7 @@ static AST_Node *racket_native_map(AST_Node *procedure, Vector *operands)
     }
 
     Vector *results = VectorNew(sizeof(AST_Node *));
+    gc_push_vector(results); // held by nothing else until the list is made
 
     if (list_length == 0)
     {
@@ -583,47 +291,41 @@ static AST_Node *racket_native_map(AST_Node *procedure, Vector *operands)
         }
     }
 
-    for (size_t i = 0; i < list_length; i++)
+    // one cursor per list, walked in step, the cells stay reachable from operands
+    Vector *cursors = VectorNew(sizeof(AST_Node *));
+    for (size_t j = 1; j < VectorLength(operands); j++)
     {
-        Vector *column = VectorNew(sizeof(AST_Node *));
+        VectorAppend(cursors, VectorNth(operands, j));
+    }
 
-        for (size_t j = 1; j < VectorLength(operands); j++)
-        {
-            AST_Node *list = *(AST_Node **)VectorNth(operands, j);
-            Vector *value = (Vector *)(list->contents.literal.value);
-            AST_Node *item = *(AST_Node **)VectorNth(value, i);
-            VectorAppend(column, &item);
-        }
+    // one row of items at a time, fn is called on them in place, the items are held by operands
+    Vector *column = VectorNew(sizeof(AST_Node *));
+    for (size_t j = 0; j < VectorLength(cursors); j++)
+    {
+        AST_Node *item = NULL;
+        VectorAppend(column, &item);
+    }
 
-        // execute fn
-        // constructe a call expression and call the eval().
-        AST_Node *call_expression = NULL;
-        // named procedure
-        if (fn->contents.procedure.name != NULL)
-        {
-            call_expression = ast_node_new(NOT_IN_AST, Call_Expression, fn->contents.procedure.name, NULL, column);
-        }
-        // anonymous procedure
-        else if (fn->contents.procedure.name == NULL)
+    for (size_t i = 0; i < list_length; i++)
+    {
+        for (size_t j = 0; j < VectorLength(cursors); j++)
         {
-            call_expression = ast_node_new(NOT_IN_AST, Call_Expression, NULL, fn, column);
+            AST_Node **cursor = (AST_Node **)VectorNth(cursors, j);
+            *(AST_Node **)VectorNth(column, j) = value_car(*cursor);
+            *cursor = value_cdr(*cursor);
         }
 
-        generate_context(call_expression, fn, NULL);
-        Result result = eval(call_expression, NULL);
-
-        // append to results
-        if (ast_node_get_tag(result) == IN_AST)
-        {
-            result = ast_node_deep_copy(result, NULL);
-        }
+        // the procedure is called directly, it may be a local procedure which can not be found by name
+        Result result = apply_procedure(fn, VectorLength(column), (AST_Node **)VectorNth(column, 0));
         VectorAppend(results, &result);
-
-        VectorFree(column, NULL, NULL);
     }
+    VectorFree(column, NULL, NULL);
+    VectorFree(cursors, NULL, NULL);
 
-    AST_Node *ast_node = ast_node_new(NOT_IN_AST, List_Literal, results);
-    return ast_node;
+    AST_Node *list = value_list_from_array((AST_Node **)VectorNth(results, 0), VectorLength(results), value_empty_list());
+    gc_pop(1);
+    VectorFree(results, NULL, NULL);
+    return list;
 }
 
 // (list? v) -> boolean?
@@ -643,15 +345,10 @@ static AST_Node *racket_native_is_list(AST_Node *procedure, Vector *operands)
 
     // get single v for operands
     AST_Node *v = *(AST_Node **)VectorNth(operands, 0);
-    Boolean_Type *value = malloc(sizeof(Boolean_Type)); 
-
-    if (v->type == List_Literal)
-        *value = R_TRUE;
-    else if (v->type != List_Literal)
-        *value = R_FALSE;
-
-    AST_Node *ast_node = ast_node_new(NOT_IN_AST, Boolean_Literal, value);
-    return ast_node;
+    if (value_is_list(v) == true)
+        return value_from_boolean(R_TRUE);
+    else
+        return value_from_boolean(R_FALSE);
 }
 
 // (filter pred lst) -> list?
@@ -671,165 +368,124 @@ static AST_Node *racket_native_filter(AST_Node *procedure, Vector *operands)
 
     // check procedure
     AST_Node *pred = *(AST_Node **)VectorNth(operands, 0);
-    if (pred->type != Procedure)
+    if (value_type(pred) != Procedure)
     {
         fprintf(stderr, "%s: parameter's type is incorrecly\n", procedure->contents.procedure.name);
         exit(EXIT_FAILURE); 
     }
 
     // the second item of operands must be list
-    AST_Node *list_literal = *(AST_Node **)VectorNth(operands, 1); 
-    if (list_literal->type != List_Literal)
+    AST_Node *list = *(AST_Node **)VectorNth(operands, 1); 
+    if (value_is_list(list) == false)
     {
         fprintf(stderr, "%s: parameter's type is incorrecly\n", procedure->contents.procedure.name);
         exit(EXIT_FAILURE); 
     }
 
-    Vector *list = TYPECAST(Vector *, list_literal->contents.literal.value);
+    // kept items stay reachable from the list in operands
     Vector *value = VectorNew(sizeof(AST_Node *));
 
-    for (size_t i = 0; i < VectorLength(list); i++)
+    for (; value_is_pair(list); list = value_cdr(list))
     {
-        Vector *column = VectorNew(sizeof(AST_Node *));
-        AST_Node *item = *(AST_Node **)VectorNth(list, i);
-        VectorAppend(column, &item);
-        
-        // execute fn
-        // constructe a call expression and call the eval().
-        AST_Node *call_expression = NULL;
-        // named procedure
-        if (pred->contents.procedure.name != NULL)
-        {
-            call_expression = ast_node_new(NOT_IN_AST, Call_Expression, pred->contents.procedure.name, NULL, column);
-        }
-        // anonymous procedure
-        else if (pred->contents.procedure.name == NULL)
-        {
-            call_expression = ast_node_new(NOT_IN_AST, Call_Expression, NULL, pred, column);
-        }
-
-        generate_context(call_expression, pred, NULL);
-        Result result = eval(call_expression, NULL); 
-
-        VectorFree(column, NULL, NULL);
+        // the procedure is called directly, it may be a local procedure which can not be found by name
+        AST_Node *item = value_car(list);
+        Result result = apply_procedure(pred, 1, &item);
 
         // check Boolean_Literal
-        if (result->type != Boolean_Literal)
+        if (value_type(result) != Boolean_Literal)
         {
             fprintf(stderr, "%s, racket_native_filter(): something wrong here\n", procedure->contents.procedure.name);
             exit(EXIT_FAILURE); 
         }
 
-        // if #t append item to value
-        Boolean_Type *is_true = TYPECAST(Boolean_Type *, result->contents.literal.value);
-
-        if (*is_true == R_TRUE)
+        // if #t append item to value, values are shared
+        if (value_to_boolean(result) == R_TRUE)
         {
-            AST_Node *item_copy = ast_node_deep_copy(item, NULL);
-            VectorAppend(value, &item_copy);
+            VectorAppend(value, &item);
         }
     }
 
-    AST_Node *result = ast_node_new(NOT_IN_AST, List_Literal, value);
+    AST_Node *result = value_list_from_array((AST_Node **)VectorNth(value, 0), VectorLength(value), value_empty_list());
+    VectorFree(value, NULL, NULL);
     return result;
 }
 
-// (> x y ...+) -> boolean?
-static AST_Node *racket_native_number_more_than(AST_Node *procedure, Vector *operands)
+// a procedure operand, or exit with racket's complaint
+static AST_Node *procedure_operand(AST_Node *procedure, Vector *operands, size_t i)
 {
-    // check arity
-    size_t arity = procedure->contents.procedure.required_params_count;
-    size_t operands_count = VectorLength(operands);
-    if (operands_count < arity)
+    AST_Node *operand = *(AST_Node **)VectorNth(operands, i);
+    if (value_type(operand) != Procedure)
     {
-        fprintf(stderr, "%s: arity mismatch;\n"
-                        "the expected number of arguments does not match the given number\n"
-                        "expected: at least %zu\n"
-                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
-        exit(EXIT_FAILURE); 
+        fprintf(stderr, "#<procedure:%s>: operands must be procedure\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
     }
+    return operand;
+}
 
-    const AST_Node *pre_number = *(AST_Node **)VectorNth(operands, 0); 
-    if (pre_number->type != Number_Literal)
+// a proper list operand, or exit with racket's complaint
+static AST_Node *list_operand(AST_Node *procedure, Vector *operands, size_t i)
+{
+    AST_Node *operand = *(AST_Node **)VectorNth(operands, i);
+    if (value_is_list(operand) == false)
     {
-        fprintf(stderr, "#<procedure:%s>: operands must be number\n", procedure->contents.procedure.name);
-        exit(EXIT_FAILURE); 
+        fprintf(stderr, "%s: contract violation\n"
+                        "expected: list?\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
     }
+    return operand;
+}
 
-    struct {
-        union {
-            long long int int_val;
-            double double_val;
-        } contents;
-        bool is_int;
-    } pre, cur;
-    
-    if (strchr(pre_number->contents.literal.value, '.') == NULL)
+// the length of the lists operands[first ...], they must all be proper lists of the same length, like map
+static size_t lists_operand(AST_Node *procedure, Vector *operands, size_t first)
+{
+    size_t list_length = value_list_length(list_operand(procedure, operands, first));
+    for (size_t i = first + 1; i < VectorLength(operands); i++)
     {
-        pre.contents.int_val = *(long long int *)(pre_number->contents.literal.c_native_value);
-        pre.is_int = true;
+        if (value_list_length(list_operand(procedure, operands, i)) != list_length)
+        {
+            fprintf(stderr, "%s: all lists must have same size\n", procedure->contents.procedure.name);
+            exit(EXIT_FAILURE);
+        }
     }
-    else
+    return list_length;
+}
+
+// cursors for the lists operands[first ...], walked in step by lists_next(), the cells stay reachable from operands
+static Vector *lists_cursors(Vector *operands, size_t first)
+{
+    Vector *cursors = VectorNew(sizeof(AST_Node *));
+    for (size_t i = first; i < VectorLength(operands); i++)
     {
-        pre.contents.double_val = *(double *)(pre_number->contents.literal.c_native_value);
-        pre.is_int = false;
+        VectorAppend(cursors, VectorNth(operands, i));
     }
+    return cursors;
+}
 
-    Boolean_Type *result = malloc(sizeof(Boolean_Type));
-    *result = R_TRUE; // true by default.
-
-    for (size_t i = 1; i < VectorLength(operands); i++)
+// a row of length values for apply_procedure(), NULL until filled
+static Vector *row_new(size_t length)
+{
+    Vector *row = VectorNew(sizeof(AST_Node *));
+    AST_Node *nothing = NULL;
+    for (size_t i = 0; i < length; i++)
     {
-        AST_Node *cur_number = *(AST_Node **)VectorNth(operands, i); 
-
-        if (cur_number->type != Number_Literal)
-        {
-            fprintf(stderr, "#<procedure:%s>: operands must be number\n", procedure->contents.procedure.name);
-            exit(EXIT_FAILURE); 
-        }
-
-        if (strchr(cur_number->contents.literal.value, '.') == NULL)
-        {
-            cur.contents.int_val = *(long long int *)(cur_number->contents.literal.c_native_value);
-            cur.is_int = true;
-        }
-        else
-        {
-            cur.contents.double_val = *(double *)(cur_number->contents.literal.c_native_value);
-            cur.is_int = false;
-        }
-
-        if (cur.is_int == true && pre.is_int == true)
-        {
-            if ((cur.contents.int_val > pre.contents.int_val) || (cur.contents.int_val == pre.contents.int_val)) *result = R_FALSE;
-            pre.contents.int_val = cur.contents.int_val;
-        }
-        else if (cur.is_int == true && pre.is_int == false)
-        {
-            if ((cur.contents.int_val > pre.contents.double_val) || (cur.contents.int_val == pre.contents.double_val)) *result = R_FALSE;
-            pre.contents.int_val = cur.contents.int_val;
-        }
-        else if (cur.is_int == false && pre.is_int == true)
-        {
-            if ((cur.contents.double_val > pre.contents.int_val) || (cur.contents.double_val == pre.contents.int_val)) *result = R_FALSE;
-            pre.contents.double_val = cur.contents.double_val;
-        }
-        else if (cur.is_int == false && pre.is_int == false)
-        {
-            if ((cur.contents.double_val > pre.contents.double_val) || (cur.contents.double_val == pre.contents.double_val)) *result = R_FALSE;
-            pre.contents.double_val = cur.contents.double_val;
-        }
-
-        pre.is_int = cur.is_int;
+        VectorAppend(row, &nothing);
     }
+    return row;
+}
 
-    AST_Node *ast_node = ast_node_new(NOT_IN_AST, Boolean_Literal, result);
-    free(result);
-    return ast_node;
+// the cars of the cursors go to the front of row, the cursors move to the cdrs
+static void lists_next(Vector *cursors, Vector *row)
+{
+    for (size_t j = 0; j < VectorLength(cursors); j++)
+    {
+        AST_Node **cursor = (AST_Node **)VectorNth(cursors, j);
+        *(AST_Node **)VectorNth(row, j) = value_car(*cursor);
+        *cursor = value_cdr(*cursor);
+    }
 }
 
-// (< x y ...) -> boolean?
-static AST_Node *racket_native_number_less_than(AST_Node *procedure, Vector *operands)
+// (foldl proc init lst ...+) -> any/c, proc is called with the items of every list and the result so far, from the left
+static AST_Node *racket_native_foldl(AST_Node *procedure, Vector *operands)
 {
     // check arity
     size_t arity = procedure->contents.procedure.required_params_count;
@@ -843,116 +499,82 @@ static AST_Node *racket_native_number_less_than(AST_Node *procedure, Vector *ope
         exit(EXIT_FAILURE); 
     }
 
-    const AST_Node *pre_number = *(AST_Node **)VectorNth(operands, 0); 
-    if (pre_number->type != Number_Literal)
-    {
-        fprintf(stderr, "#<procedure:%s>: operands must be number\n", procedure->contents.procedure.name);
-        exit(EXIT_FAILURE); 
-    }
-
-    struct {
-        union {
-            long long int int_val;
-            double double_val;
-        } contents;
-        bool is_int;
-    } pre, cur;
-    
-    if (strchr(pre_number->contents.literal.value, '.') == NULL)
-    {
-        pre.contents.int_val = *(long long int *)(pre_number->contents.literal.c_native_value);
-        pre.is_int = true;
-    }
-    else
-    {
-        pre.contents.double_val = *(double *)(pre_number->contents.literal.c_native_value);
-        pre.is_int = false;
-    }
+    AST_Node *fn = procedure_operand(procedure, operands, 0);
+    size_t list_length = lists_operand(procedure, operands, 2);
+    Vector *cursors = lists_cursors(operands, 2);
+    size_t lists_count = VectorLength(cursors);
 
-    Boolean_Type *result = malloc(sizeof(Boolean_Type));
-    *result = R_TRUE; // true by default.
+    // the result so far is the last of the row, held by nothing else
+    Vector *row = row_new(lists_count + 1);
+    AST_Node **acc = (AST_Node **)VectorNth(row, lists_count);
+    *acc = *(AST_Node **)VectorNth(operands, 1);
+    gc_push_vector(row);
 
-    for (size_t i = 1; i < VectorLength(operands); i++)
+    for (size_t i = 0; i < list_length; i++)
     {
-        AST_Node *cur_number = *(AST_Node **)VectorNth(operands, i); 
-
-        if (cur_number->type != Number_Literal)
-        {
-            fprintf(stderr, "#<procedure:%s>: operands must be number\n", procedure->contents.procedure.name);
-            exit(EXIT_FAILURE); 
-        }
-
-        if (strchr(cur_number->contents.literal.value, '.') == NULL)
-        {
-            cur.contents.int_val = *(long long int *)(cur_number->contents.literal.c_native_value);
-            cur.is_int = true;
-        }
-        else
-        {
-            cur.contents.double_val = *(double *)(cur_number->contents.literal.c_native_value);
-            cur.is_int = false;
-        }
-
-        if (cur.is_int == true && pre.is_int == true)
-        {
-            if ((cur.contents.int_val < pre.contents.int_val) || (cur.contents.int_val == pre.contents.int_val)) *result = R_FALSE;
-            pre.contents.int_val = cur.contents.int_val;
-        }
-        else if (cur.is_int == true && pre.is_int == false)
-        {
-            if ((cur.contents.int_val < pre.contents.double_val) || (cur.contents.int_val == pre.contents.double_val)) *result = R_FALSE;
-            pre.contents.int_val = cur.contents.int_val;
-        }
-        else if (cur.is_int == false && pre.is_int == true)
-        {
-            if ((cur.contents.double_val < pre.contents.int_val) || (cur.contents.double_val == pre.contents.int_val)) *result = R_FALSE;
-            pre.contents.double_val = cur.contents.double_val;
-        }
-        else if (cur.is_int == false && pre.is_int == false)
-        {
-            if ((cur.contents.double_val < pre.contents.double_val) || (cur.contents.double_val == pre.contents.double_val)) *result = R_FALSE;
-            pre.contents.double_val = cur.contents.double_val;
-        }
-
-        pre.is_int = cur.is_int;
+        lists_next(cursors, row);
+        *acc = apply_procedure(fn, lists_count + 1, (AST_Node **)VectorNth(row, 0));
     }
 
-    AST_Node *ast_node = ast_node_new(NOT_IN_AST, Boolean_Literal, result);
-    free(result);
-    return ast_node;
+    AST_Node *result = *acc;
+    gc_pop(1);
+    VectorFree(row, NULL, NULL);
+    VectorFree(cursors, NULL, NULL);
+    return result;
 }
 
-// (pair? v) -> boolean?
-static AST_Node *racket_native_is_pair(AST_Node *procedure, Vector *operands)
+// (foldr proc init lst ...+) -> any/c, the same as foldl from the right
+static AST_Node *racket_native_foldr(AST_Node *procedure, Vector *operands)
 {
     // check arity
     size_t arity = procedure->contents.procedure.required_params_count;
     size_t operands_count = VectorLength(operands);
-    if (operands_count != arity)
+    if (operands_count < arity)
     {
         fprintf(stderr, "%s: arity mismatch;\n"
                         "the expected number of arguments does not match the given number\n"
-                        "expected: %zu\n"
+                        "expected: at least %zu\n"
                         "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
         exit(EXIT_FAILURE); 
     }
 
-    AST_Node *v = *(AST_Node **)VectorNth(operands, 0);
-    Boolean_Type *value = malloc(sizeof(Boolean_Type));
+    AST_Node *fn = procedure_operand(procedure, operands, 0);
+    size_t list_length = lists_operand(procedure, operands, 2);
+    Vector *cursors = lists_cursors(operands, 2);
+    size_t lists_count = VectorLength(cursors);
 
-    if (v->type == Pair_Literal)
-        *value = R_TRUE;
-    else if (v->type == List_Literal && VectorLength(TYPECAST(Vector *, v->contents.literal.value)) != 0)
-        *value = R_TRUE;
-    else
-        *value = R_FALSE;
+    // the rows are taken from the left once, then called from the right, the items are held by operands
+    Vector *items = VectorNew(sizeof(AST_Node *));
+    Vector *row = row_new(lists_count + 1);
+    for (size_t i = 0; i < list_length; i++)
+    {
+        lists_next(cursors, row);
+        for (size_t j = 0; j < lists_count; j++)
+        {
+            VectorAppend(items, VectorNth(row, j));
+        }
+    }
+
+    AST_Node **acc = (AST_Node **)VectorNth(row, lists_count);
+    *acc = *(AST_Node **)VectorNth(operands, 1);
+    gc_push_vector(row);
+
+    for (size_t i = list_length; i > 0; i--)
+    {
+        memcpy(VectorNth(row, 0), VectorNth(items, (i - 1) * lists_count), sizeof(AST_Node *) * lists_count);
+        *acc = apply_procedure(fn, lists_count + 1, (AST_Node **)VectorNth(row, 0));
+    }
 
-    AST_Node *ast_node = ast_node_new(NOT_IN_AST, Boolean_Literal, value);
-    return ast_node;
+    AST_Node *result = *acc;
+    gc_pop(1);
+    VectorFree(row, NULL, NULL);
+    VectorFree(items, NULL, NULL);
+    VectorFree(cursors, NULL, NULL);
+    return result;
 }
 
-// (list v ...) -> list?
-static AST_Node *racket_native_list(AST_Node *procedure, Vector *operands)
+// (for-each proc lst ...+) -> void?
+static AST_Node *racket_native_for_each(AST_Node *procedure, Vector *operands)
 {
     // check arity
     size_t arity = procedure->contents.procedure.required_params_count;
@@ -961,126 +583,228 @@ static AST_Node *racket_native_list(AST_Node *procedure, Vector *operands)
     {
         fprintf(stderr, "%s: arity mismatch;\n"
                         "the expected number of arguments does not match the given number\n"
-                        "expected: %zu\n"
+                        "expected: at least %zu\n"
                         "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
         exit(EXIT_FAILURE); 
     }
 
-    Vector *value = VectorNew(sizeof(AST_Node *));
+    AST_Node *fn = procedure_operand(procedure, operands, 0);
+    size_t list_length = lists_operand(procedure, operands, 1);
+    Vector *cursors = lists_cursors(operands, 1);
+    Vector *row = row_new(VectorLength(cursors));
 
-    for (size_t i = 0; i < operands_count; i++)
+    for (size_t i = 0; i < list_length; i++)
     {
-        AST_Node *node = *(AST_Node **)VectorNth(operands, i);
-        AST_Node *node_copy = ast_node_deep_copy(node, NULL);
-        VectorAppend(value, &node_copy);
+        lists_next(cursors, row);
+        apply_procedure(fn, VectorLength(row), (AST_Node **)VectorNth(row, 0));
     }
 
-    AST_Node *ast_node = ast_node_new(NOT_IN_AST, List_Literal, value);
-    return ast_node;
+    VectorFree(row, NULL, NULL);
+    VectorFree(cursors, NULL, NULL);
+    return NULL;
 }
 
-// (car pair) -> any/c
-static AST_Node *racket_native_car(AST_Node *procedure, Vector *operands)
+// andmap and ormap, which stop at the first result that is #f, or is not #f, and return it
+static AST_Node *map_until(AST_Node *procedure, Vector *operands, bool until_false)
 {
     // check arity
     size_t arity = procedure->contents.procedure.required_params_count;
     size_t operands_count = VectorLength(operands);
-    if (operands_count != arity)
+    if (operands_count < arity)
     {
         fprintf(stderr, "%s: arity mismatch;\n"
                         "the expected number of arguments does not match the given number\n"
-                        "expected: %zu\n"
+                        "expected: at least %zu\n"
                         "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
         exit(EXIT_FAILURE); 
     }
 
-    // check if it is a pair
-    AST_Node *ast_node = *(AST_Node **)VectorNth(operands, 0);
-    bool is_pair = false;
+    AST_Node *fn = procedure_operand(procedure, operands, 0);
+    size_t list_length = lists_operand(procedure, operands, 1);
+    Vector *cursors = lists_cursors(operands, 1);
+    Vector *row = row_new(VectorLength(cursors));
 
-    if (ast_node->type == Pair_Literal)
-        is_pair = true;
-    else if (ast_node->type == List_Literal && VectorLength(TYPECAST(Vector *, ast_node->contents.literal.value)) != 0)
-        is_pair = true;
-    else
-        is_pair = false;
-
-    if (is_pair == false)
+    // the result of the last call, #t or #f when there is none
+    AST_Node *result = value_from_boolean(until_false == true ? R_TRUE : R_FALSE);
+    for (size_t i = 0; i < list_length; i++)
     {
-        fprintf(stderr, "%s: contract violation\n"
-                        "expected: pair?\n"
-                        "given: %zu\n", procedure->contents.procedure.name, operands_count);
-        exit(EXIT_FAILURE); 
+        lists_next(cursors, row);
+        result = apply_procedure(fn, VectorLength(row), (AST_Node **)VectorNth(row, 0));
+        if (is_false(result) == until_false) break;
     }
 
-    Vector *value = TYPECAST(Vector *, ast_node->contents.literal.value);
-    AST_Node *car = *(AST_Node **)VectorNth(value, 0);
-    return ast_node_deep_copy(car, NULL);
+    VectorFree(row, NULL, NULL);
+    VectorFree(cursors, NULL, NULL);
+    return result;
+}
+
+// (andmap proc lst ...+) -> any/c
+static AST_Node *racket_native_andmap(AST_Node *procedure, Vector *operands)
+{
+    return map_until(procedure, operands, true);
 }
 
-// (cdr pair) -> any/c
-static AST_Node *racket_native_cdr(AST_Node *procedure, Vector *operands)
+// (ormap proc lst ...+) -> any/c
+static AST_Node *racket_native_ormap(AST_Node *procedure, Vector *operands)
+{
+    return map_until(procedure, operands, false);
+}
+
+// (apply proc v ... lst) -> any/c, proc is called with the vs followed by the items of lst
+static AST_Node *racket_native_apply(AST_Node *procedure, Vector *operands)
 {
     // check arity
     size_t arity = procedure->contents.procedure.required_params_count;
     size_t operands_count = VectorLength(operands);
-    if (operands_count != arity)
+    if (operands_count < arity)
     {
         fprintf(stderr, "%s: arity mismatch;\n"
                         "the expected number of arguments does not match the given number\n"
-                        "expected: %zu\n"
+                        "expected: at least %zu\n"
                         "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
         exit(EXIT_FAILURE); 
     }
-    
-    // check if it is a pair
-    AST_Node *ast_node = *(AST_Node **)VectorNth(operands, 0);
-    bool is_pair = false;
 
-    if (ast_node->type == Pair_Literal)
-        is_pair = true;
-    else if (ast_node->type == List_Literal && VectorLength(TYPECAST(Vector *, ast_node->contents.literal.value)) != 0)
-        is_pair = true;
-    else
-        is_pair = false;
+    AST_Node *fn = procedure_operand(procedure, operands, 0);
+    AST_Node *list = list_operand(procedure, operands, operands_count - 1);
 
-    if (is_pair == false)
+    // every argument is held by operands
+    Vector *arguments = VectorNew(sizeof(AST_Node *));
+    for (size_t i = 1; i + 1 < operands_count; i++)
     {
-        fprintf(stderr, "%s: contract violation\n"
-                        "expected: pair?\n"
-                        "given: %zu\n", procedure->contents.procedure.name, operands_count);
-        exit(EXIT_FAILURE);
+        VectorAppend(arguments, VectorNth(operands, i));
     }
+    for (; value_is_pair(list); list = value_cdr(list))
+    {
+        AST_Node *item = value_car(list);
+        VectorAppend(arguments, &item);
+    }
+
+    size_t arguments_count = VectorLength(arguments);
+    AST_Node *result = apply_procedure(fn, arguments_count, arguments_count > 0 ? (AST_Node **)VectorNth(arguments, 0) : NULL);
+    VectorFree(arguments, NULL, NULL);
+    return result;
+}
 
-    Vector *value = TYPECAST(Vector *, ast_node->contents.literal.value);
+// (range end), (range start end [step]) -> list?, start is 0 and step is 1 by default
+static AST_Node *racket_native_range(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count < arity || operands_count > arity + 2)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu to %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, arity + 2, operands_count);
+        exit(EXIT_FAILURE); 
+    }
 
-    if (ast_node->type == Pair_Literal)
+    for (size_t i = 0; i < operands_count; i++)
+    {
+        if (value_type(*(AST_Node **)VectorNth(operands, i)) != Number_Literal)
+        {
+            fprintf(stderr, "#<procedure:%s>: operands must be number\n", procedure->contents.procedure.name);
+            exit(EXIT_FAILURE);
+        }
+    }
+    AST_Node *start = operands_count == 1 ? value_from_fixnum(0) : *(AST_Node **)VectorNth(operands, 0);
+    AST_Node *end = *(AST_Node **)VectorNth(operands, operands_count == 1 ? 0 : 1);
+    AST_Node *step = operands_count == 3 ? *(AST_Node **)VectorNth(operands, 2) : value_from_fixnum(1);
+    int direction = number_compare(step, value_from_fixnum(0));
+    if (direction == 0 || direction == NUMBER_UNORDERED)
     {
-        AST_Node *cdr = *(AST_Node **)VectorNth(value, 1);
-        return ast_node_deep_copy(cdr, NULL);
+        fprintf(stderr, "%s: contract violation\n"
+                        "expected: (and/c real? (not/c zero?))\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
     }
-    else if (ast_node->type == List_Literal)
+
+    AST_Node *list = value_empty_list();
+    gc_push_values(&list, 1); // the cells built so far are held by nothing else
+
+    // fixnums: the length is known, so the cells are built from the back, each allocated once
+    if (value_is_fixnum(start) && value_is_fixnum(end) && value_is_fixnum(step))
     {
-        Vector *list = VectorNew(sizeof(AST_Node *));
+        long long int from = value_to_fixnum(start);
+        long long int to = value_to_fixnum(end);
+        long long int by = value_to_fixnum(step);
+        long long int count = 0;
+        if (by > 0 && to > from) count = (to - from + by - 1) / by;
+        if (by < 0 && to < from) count = (from - to - by - 1) / -by;
 
-        for (size_t i = 1; i < VectorLength(value); i++)
+        for (long long int i = count; i > 0; i--)
         {
-            AST_Node *node = *(AST_Node **)VectorNth(value, i);
-            AST_Node *node_copy = ast_node_deep_copy(node, NULL);
-            VectorAppend(list, &node_copy);
+            list = value_cons(value_from_fixnum(from + (i - 1) * by), list);
         }
+        gc_pop(1);
+        return list;
+    }
 
-        AST_Node *cdr = ast_node_new(NOT_IN_AST, List_Literal, list);
-        return cdr;
+    // other numbers are added up like racket does, the exact sum of rationals or the rounded one of flonums
+    Vector *values = VectorNew(sizeof(AST_Node *));
+    gc_push_vector(values);
+    for (AST_Node *value = start; number_compare(value, end) == -direction; )
+    {
+        VectorAppend(values, &value);
+        value = number_add(value, step);
     }
-    else
+    if (VectorLength(values) > 0)
+    {
+        list = value_list_from_array((AST_Node **)VectorNth(values, 0), VectorLength(values), value_empty_list());
+    }
+    gc_pop(2);
+    VectorFree(values, NULL, NULL);
+    return list;
+}
+
+// (build-list n proc) -> list?, the items are (proc 0) ... (proc (- n 1)), called in order
+static AST_Node *racket_native_build_list(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
     {
-        fprintf(stderr, "something wrong in racket_native_cdr\n");
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *n = *(AST_Node **)VectorNth(operands, 0);
+    if (!value_is_fixnum(n) || value_to_fixnum(n) < 0)
+    {
+        fprintf(stderr, "#<procedure:%s>: size must be exact-nonnegative-integer\n", procedure->contents.procedure.name);
         exit(EXIT_FAILURE);
     }
+    AST_Node *fn = procedure_operand(procedure, operands, 1);
+
+    // one slot per item, allocated up front and rooted as a whole
+    size_t length = TYPECAST(size_t, value_to_fixnum(n));
+    AST_Node **items = (AST_Node **)calloc(length + 1, sizeof(AST_Node *));
+    if (items == NULL)
+    {
+        perror("racket_native_build_list(): calloc failed");
+        exit(EXIT_FAILURE);
+    }
+    gc_push_values(items, length);
+
+    for (size_t i = 0; i < length; i++)
+    {
+        AST_Node *index = value_from_fixnum(TYPECAST(long long int, i));
+        items[i] = apply_procedure(fn, 1, &index);
+    }
+
+    AST_Node *list = value_list_from_array(items, length, value_empty_list());
+    gc_pop(1);
+    free(items);
+    return list;
 }
 
-static AST_Node *racket_native_cons(AST_Node *procedure, Vector *operands)
+// (length lst) -> exact-nonnegative-integer?
+static AST_Node *racket_native_length(AST_Node *procedure, Vector *operands)
 {
     // check arity
     size_t arity = procedure->contents.procedure.required_params_count;
@@ -1094,42 +818,116 @@ static AST_Node *racket_native_cons(AST_Node *procedure, Vector *operands)
         exit(EXIT_FAILURE); 
     }
 
-    AST_Node *car = *(AST_Node **)VectorNth(operands, 0);
-    AST_Node *cdr = *(AST_Node **)VectorNth(operands, 1);
-    car = ast_node_deep_copy(car, NULL);
-    car->tag = NOT_IN_AST;
-    cdr = ast_node_deep_copy(cdr, NULL);
-    cdr->tag = NOT_IN_AST;
-    
-    if (cdr->type == List_Literal)
+    AST_Node *list = list_operand(procedure, operands, 0);
+    return value_from_integer(TYPECAST(long long int, value_list_length(list)));
+}
+
+// (reverse lst) -> list?
+static AST_Node *racket_native_reverse(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *list = list_operand(procedure, operands, 0);
+    AST_Node *reversed = value_empty_list();
+    gc_push_values(&reversed, 1);
+    for (; value_is_pair(list); list = value_cdr(list))
+    {
+        reversed = value_cons(value_car(list), reversed);
+    }
+    gc_pop(1);
+    return reversed;
+}
+
+// (append lst ... v) -> any/c, every list is copied but the last operand, which is shared as the tail
+static AST_Node *racket_native_append(AST_Node *procedure, Vector *operands)
+{
+    size_t operands_count = VectorLength(operands);
+    if (operands_count == 0) return value_empty_list();
+    for (size_t i = 0; i + 1 < operands_count; i++) list_operand(procedure, operands, i);
+
+    // the items of each list in an array, so its copy is built from the back onto the tail, the items are held by operands
+    AST_Node *tail = *(AST_Node **)VectorNth(operands, operands_count - 1);
+    gc_push_values(&tail, 1);
+    for (size_t i = operands_count - 1; i > 0; i--)
     {
-        Vector *value = VectorNew(sizeof(AST_Node *));
-        Vector *cdr_value = (Vector *)(cdr->contents.literal.value);
+        AST_Node *list = *(AST_Node **)VectorNth(operands, i - 1);
+        if (!value_is_pair(list)) continue;
 
-        VectorAppend(value, &car);
-        for (size_t i = 0; i < VectorLength(cdr_value); i++)
+        Vector *items = VectorNew(sizeof(AST_Node *));
+        for (; value_is_pair(list); list = value_cdr(list))
         {
-            AST_Node *node = *(AST_Node **)VectorNth(cdr_value, i);
-            VectorAppend(value, &node);
+            AST_Node *item = value_car(list);
+            VectorAppend(items, &item);
         }
+        tail = value_list_from_array((AST_Node **)VectorNth(items, 0), VectorLength(items), tail);
+        VectorFree(items, NULL, NULL);
+    }
+    gc_pop(1);
+    return tail;
+}
 
-        AST_Node *ast_node = ast_node_new(NOT_IN_AST, List_Literal, value);
-        return ast_node;
+// list-ref and list-tail, what is left after pos cdrs, a pair for list-ref, lst may be improper past it
+static AST_Node *list_nth_pair(AST_Node *procedure, Vector *operands, bool tail)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
     }
-    else
+
+    AST_Node *list = *(AST_Node **)VectorNth(operands, 0);
+    AST_Node *pos = *(AST_Node **)VectorNth(operands, 1);
+    if (!value_is_fixnum(pos) || value_to_fixnum(pos) < 0)
     {
-        Vector *value = VectorNew(sizeof(AST_Node *));
+        fprintf(stderr, "#<procedure:%s>: index must be exact-nonnegative-integer\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
+    }
 
-        VectorAppend(value, &car);
-        VectorAppend(value, &cdr);
-        
-        AST_Node *ast_node = ast_node_new(NOT_IN_AST, Pair_Literal, value);
-        return ast_node;
+    long long int index = value_to_fixnum(pos);
+    long long int i = 0;
+    for (; i < index && value_is_pair(list); i++)
+    {
+        list = value_cdr(list);
     }
+    if (i < index || (tail == false && !value_is_pair(list)))
+    {
+        fprintf(stderr, "%s: index too large for list\n"
+                        "index: %lld\n", procedure->contents.procedure.name, index);
+        exit(EXIT_FAILURE);
+    }
+    return list;
 }
 
-// (<= x y ...) -> boolean?
-static AST_Node *racket_native_less_or_equal_than(AST_Node *procedure, Vector *operands)
+// (list-ref lst pos) -> any/c
+static AST_Node *racket_native_list_ref(AST_Node *procedure, Vector *operands)
+{
+    return value_car(list_nth_pair(procedure, operands, false));
+}
+
+// (list-tail lst pos) -> any/c
+static AST_Node *racket_native_list_tail(AST_Node *procedure, Vector *operands)
+{
+    return list_nth_pair(procedure, operands, true);
+}
+
+// (> x y ...+) -> boolean?
+static AST_Node *racket_native_number_more_than(AST_Node *procedure, Vector *operands)
 {
     // check arity
     size_t arity = procedure->contents.procedure.required_params_count;
@@ -1143,86 +941,36 @@ static AST_Node *racket_native_less_or_equal_than(AST_Node *procedure, Vector *o
         exit(EXIT_FAILURE); 
     }
 
-    const AST_Node *pre_number = *(AST_Node **)VectorNth(operands, 0); 
-    if (pre_number->type != Number_Literal)
+    AST_Node *pre_number = *(AST_Node **)VectorNth(operands, 0); 
+    if (value_type(pre_number) != Number_Literal)
     {
         fprintf(stderr, "#<procedure:%s>: operands must be number\n", procedure->contents.procedure.name);
         exit(EXIT_FAILURE); 
     }
 
-    struct {
-        union {
-            long long int int_val;
-            double double_val;
-        } contents;
-        bool is_int;
-    } pre, cur;
-    
-    if (strchr(pre_number->contents.literal.value, '.') == NULL)
-    {
-        pre.contents.int_val = *(long long int *)(pre_number->contents.literal.c_native_value);
-        pre.is_int = true;
-    }
-    else
-    {
-        pre.contents.double_val = *(double *)(pre_number->contents.literal.c_native_value);
-        pre.is_int = false;
-    }
-
-    Boolean_Type *result = malloc(sizeof(Boolean_Type));
-    *result = R_TRUE; // true by default.
+    Boolean_Type result = R_TRUE; // true by default.
 
     for (size_t i = 1; i < VectorLength(operands); i++)
     {
         AST_Node *cur_number = *(AST_Node **)VectorNth(operands, i); 
 
-        if (cur_number->type != Number_Literal)
+        if (value_type(cur_number) != Number_Literal)
         {
             fprintf(stderr, "#<procedure:%s>: operands must be number\n", procedure->contents.procedure.name);
             exit(EXIT_FAILURE); 
         }
 
-        if (strchr(cur_number->contents.literal.value, '.') == NULL)
-        {
-            cur.contents.int_val = *(long long int *)(cur_number->contents.literal.c_native_value);
-            cur.is_int = true;
-        }
-        else
-        {
-            cur.contents.double_val = *(double *)(cur_number->contents.literal.c_native_value);
-            cur.is_int = false;
-        }
-
-        if (cur.is_int == true && pre.is_int == true)
-        {
-            if (cur.contents.int_val < pre.contents.int_val) *result = R_FALSE;
-            pre.contents.int_val = cur.contents.int_val;
-        }
-        else if (cur.is_int == true && pre.is_int == false)
-        {
-            if (cur.contents.int_val < pre.contents.double_val) *result = R_FALSE;
-            pre.contents.int_val = cur.contents.int_val;
-        }
-        else if (cur.is_int == false && pre.is_int == true)
-        {
-            if (cur.contents.double_val < pre.contents.int_val) *result = R_FALSE;
-            pre.contents.double_val = cur.contents.double_val;
-        }
-        else if (cur.is_int == false && pre.is_int == false)
-        {
-            if (cur.contents.double_val < pre.contents.double_val) *result = R_FALSE;
-            pre.contents.double_val = cur.contents.double_val;
-        }
-
-        pre.is_int = cur.is_int;
+        // every pair must be strictly decreasing
+        int order = number_compare(pre_number, cur_number);
+        if (order != 1) result = R_FALSE;
+        pre_number = cur_number;
     }
 
-    AST_Node *ast_node = ast_node_new(NOT_IN_AST, Boolean_Literal, result);
-    return ast_node;
+    return value_from_boolean(result);
 }
 
-// (>= x y ...) -> boolean?
-static AST_Node *racket_native_more_or_equal_than(AST_Node *procedure, Vector *operands)
+// (< x y ...) -> boolean?
+static AST_Node *racket_native_number_less_than(AST_Node *procedure, Vector *operands)
 {
     // check arity
     size_t arity = procedure->contents.procedure.required_params_count;
@@ -1236,115 +984,1678 @@ static AST_Node *racket_native_more_or_equal_than(AST_Node *procedure, Vector *o
         exit(EXIT_FAILURE); 
     }
 
-    const AST_Node *pre_number = *(AST_Node **)VectorNth(operands, 0); 
-    if (pre_number->type != Number_Literal)
+    AST_Node *pre_number = *(AST_Node **)VectorNth(operands, 0); 
+    if (value_type(pre_number) != Number_Literal)
     {
         fprintf(stderr, "#<procedure:%s>: operands must be number\n", procedure->contents.procedure.name);
         exit(EXIT_FAILURE); 
     }
 
-    struct {
-        union {
-            long long int int_val;
-            double double_val;
-        } contents;
-        bool is_int;
-    } pre, cur;
-    
-    if (strchr(pre_number->contents.literal.value, '.') == NULL)
-    {
-        pre.contents.int_val = *(long long int *)(pre_number->contents.literal.c_native_value);
-        pre.is_int = true;
-    }
-    else
-    {
-        pre.contents.double_val = *(double *)(pre_number->contents.literal.c_native_value);
-        pre.is_int = false;
-    }
-
-    Boolean_Type *result = malloc(sizeof(Boolean_Type));
-    *result = R_TRUE; // true by default.
+    Boolean_Type result = R_TRUE; // true by default.
 
     for (size_t i = 1; i < VectorLength(operands); i++)
     {
         AST_Node *cur_number = *(AST_Node **)VectorNth(operands, i); 
 
-        if (cur_number->type != Number_Literal)
+        if (value_type(cur_number) != Number_Literal)
         {
             fprintf(stderr, "#<procedure:%s>: operands must be number\n", procedure->contents.procedure.name);
             exit(EXIT_FAILURE); 
         }
 
-        if (strchr(cur_number->contents.literal.value, '.') == NULL)
-        {
-            cur.contents.int_val = *(long long int *)(cur_number->contents.literal.c_native_value);
-            cur.is_int = true;
-        }
-        else
-        {
-            cur.contents.double_val = *(double *)(cur_number->contents.literal.c_native_value);
-            cur.is_int = false;
-        }
+        // every pair must be strictly increasing
+        int order = number_compare(pre_number, cur_number);
+        if (order != -1) result = R_FALSE;
+        pre_number = cur_number;
+    }
 
-        if (cur.is_int == true && pre.is_int == true)
-        {
-            if (cur.contents.int_val > pre.contents.int_val) *result = R_FALSE;
-            pre.contents.int_val = cur.contents.int_val;
-        }
-        else if (cur.is_int == true && pre.is_int == false)
-        {
-            if (cur.contents.int_val > pre.contents.double_val) *result = R_FALSE;
-            pre.contents.int_val = cur.contents.int_val;
-        }
-        else if (cur.is_int == false && pre.is_int == true)
-        {
-            if (cur.contents.double_val > pre.contents.int_val) *result = R_FALSE;
-            pre.contents.double_val = cur.contents.double_val;
-        }
-        else if (cur.is_int == false && pre.is_int == false)
-        {
-            if (cur.contents.double_val > pre.contents.double_val) *result = R_FALSE;
-            pre.contents.double_val = cur.contents.double_val;
-        }
+    return value_from_boolean(result);
+}
 
-        pre.is_int = cur.is_int;
+// (pair? v) -> boolean?
+static AST_Node *racket_native_is_pair(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
     }
 
-    AST_Node *ast_node = ast_node_new(NOT_IN_AST, Boolean_Literal, result);
-    return ast_node;
+    AST_Node *v = *(AST_Node **)VectorNth(operands, 0);
+    if (value_is_pair(v) == true)
+        return value_from_boolean(R_TRUE);
+    else
+        return value_from_boolean(R_FALSE);
 }
 
-Vector *generate_built_in_bindings(void)
+// (list v ...) -> list?
+static AST_Node *racket_native_list(AST_Node *procedure, Vector *operands)
 {
-    Vector *built_in_bindings = VectorNew(sizeof(AST_Node *));
-    AST_Node *binding = NULL;
-    AST_Node *procedure = NULL;
-
-    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "+", 0, NULL, NULL, TYPECAST(void(*)(void), racket_native_addition)); 
-    binding = ast_node_new(BUILT_IN_BINDING, Binding, "+", procedure);
-    VectorAppend(built_in_bindings, &binding);
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count < arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
 
-    procedure = ast_node_new(BUILT_IN_PROCEDURE,Procedure,  "-", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_subtraction)); 
-    binding = ast_node_new(BUILT_IN_BINDING, Binding, "-", procedure);
-    VectorAppend(built_in_bindings, &binding);
+    // operands are rooted by the caller
+    return value_list_from_array((AST_Node **)VectorNth(operands, 0), operands_count, value_empty_list());
+}
 
-    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "*", 0, NULL, NULL, TYPECAST(void(*)(void), racket_native_multiplication)); 
-    binding = ast_node_new(BUILT_IN_BINDING, Binding, "*", procedure);
-    VectorAppend(built_in_bindings, &binding);
+// (car pair) -> any/c
+static AST_Node *racket_native_car(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
 
-    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "/", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_division)); 
-    binding = ast_node_new(BUILT_IN_BINDING, Binding, "/", procedure);
-    VectorAppend(built_in_bindings, &binding);
+    // check if it is a pair
+    AST_Node *ast_node = *(AST_Node **)VectorNth(operands, 0);
+    if (value_is_pair(ast_node) == false)
+    {
+        fprintf(stderr, "%s: contract violation\n"
+                        "expected: pair?\n"
+                        "given: %zu\n", procedure->contents.procedure.name, operands_count);
+        exit(EXIT_FAILURE); 
+    }
 
-    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "=", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_number_equal)); 
-    binding = ast_node_new(BUILT_IN_BINDING, Binding, "=", procedure);
-    VectorAppend(built_in_bindings, &binding);
+    return value_car(ast_node);
+}
 
-    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, ">", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_number_more_than)); 
+// (cdr pair) -> any/c
+static AST_Node *racket_native_cdr(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+    
+    // check if it is a pair
+    AST_Node *ast_node = *(AST_Node **)VectorNth(operands, 0);
+    if (value_is_pair(ast_node) == false)
+    {
+        fprintf(stderr, "%s: contract violation\n"
+                        "expected: pair?\n"
+                        "given: %zu\n", procedure->contents.procedure.name, operands_count);
+        exit(EXIT_FAILURE);
+    }
+
+    // the tail is shared, not copied
+    return value_cdr(ast_node);
+}
+
+static AST_Node *racket_native_cons(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *car = *(AST_Node **)VectorNth(operands, 0);
+    AST_Node *cdr = *(AST_Node **)VectorNth(operands, 1);
+    
+    // operands are rooted by the caller, the tail is shared
+    return value_cons(car, cdr);
+}
+
+// (<= x y ...) -> boolean?
+static AST_Node *racket_native_less_or_equal_than(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count < arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: at least %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *pre_number = *(AST_Node **)VectorNth(operands, 0); 
+    if (value_type(pre_number) != Number_Literal)
+    {
+        fprintf(stderr, "#<procedure:%s>: operands must be number\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE); 
+    }
+
+    Boolean_Type result = R_TRUE; // true by default.
+
+    for (size_t i = 1; i < VectorLength(operands); i++)
+    {
+        AST_Node *cur_number = *(AST_Node **)VectorNth(operands, i); 
+
+        if (value_type(cur_number) != Number_Literal)
+        {
+            fprintf(stderr, "#<procedure:%s>: operands must be number\n", procedure->contents.procedure.name);
+            exit(EXIT_FAILURE); 
+        }
+
+        // no pair may decrease, NaN is unordered
+        int order = number_compare(pre_number, cur_number);
+        if (order != -1 && order != 0) result = R_FALSE;
+        pre_number = cur_number;
+    }
+
+    return value_from_boolean(result);
+}
+
+// (>= x y ...) -> boolean?
+static AST_Node *racket_native_more_or_equal_than(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count < arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: at least %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *pre_number = *(AST_Node **)VectorNth(operands, 0); 
+    if (value_type(pre_number) != Number_Literal)
+    {
+        fprintf(stderr, "#<procedure:%s>: operands must be number\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE); 
+    }
+
+    Boolean_Type result = R_TRUE; // true by default.
+
+    for (size_t i = 1; i < VectorLength(operands); i++)
+    {
+        AST_Node *cur_number = *(AST_Node **)VectorNth(operands, i); 
+
+        if (value_type(cur_number) != Number_Literal)
+        {
+            fprintf(stderr, "#<procedure:%s>: operands must be number\n", procedure->contents.procedure.name);
+            exit(EXIT_FAILURE); 
+        }
+
+        // no pair may increase, NaN is unordered
+        int order = number_compare(pre_number, cur_number);
+        if (order != 1 && order != 0) result = R_FALSE;
+        pre_number = cur_number;
+    }
+
+    return value_from_boolean(result);
+}
+
+// (number->string z) -> string?
+static AST_Node *racket_native_number_to_string(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *z = *(AST_Node **)VectorNth(operands, 0);
+    if (value_type(z) != Number_Literal)
+    {
+        fprintf(stderr, "#<procedure:%s>: operands must be number\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE); 
+    }
+
+    char *text = number_to_string(z);
+    AST_Node *string = ast_node_new(NOT_IN_AST, String_Literal, text);
+    free(text);
+    return string;
+}
+
+/*
+    fixed-arity entry points of the arithmetic and comparison built-ins, see c_native_binary_function
+    (+ a b) and (= n 0) are most calls, they skip the operand array and the fold,
+    anything unusual, such as an operand which is not a number, is left to the variadic entry point to report
+*/
+static AST_Node *binary_fallback(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    AST_Node *operands_array[2] = { a, b };
+    Vector operands = { operands_array, sizeof(AST_Node *), 2, 2 };
+    Function c_native_function = procedure->contents.procedure.c_native_function;
+    return ((AST_Node *(*)(AST_Node *procedure, Vector *operands))c_native_function)(procedure, &operands);
+}
+
+static AST_Node *racket_native_binary_addition(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    if (value_type(a) != Number_Literal || value_type(b) != Number_Literal) return binary_fallback(procedure, a, b);
+    return number_add(a, b);
+}
+
+static AST_Node *racket_native_binary_subtraction(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    if (value_type(a) != Number_Literal || value_type(b) != Number_Literal) return binary_fallback(procedure, a, b);
+    return number_subtract(a, b);
+}
+
+static AST_Node *racket_native_binary_multiplication(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    if (value_type(a) != Number_Literal || value_type(b) != Number_Literal) return binary_fallback(procedure, a, b);
+    return number_multiply(a, b);
+}
+
+static AST_Node *racket_native_binary_division(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    if (value_type(a) != Number_Literal || value_type(b) != Number_Literal || value_to_double(b) == 0)
+        return binary_fallback(procedure, a, b);
+    return number_divide(a, b);
+}
+
+static AST_Node *racket_native_binary_number_equal(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    if (value_type(a) != Number_Literal || value_type(b) != Number_Literal) return binary_fallback(procedure, a, b);
+    return value_from_boolean(number_compare(a, b) == 0 ? R_TRUE : R_FALSE);
+}
+
+static AST_Node *racket_native_binary_number_less_than(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    if (value_type(a) != Number_Literal || value_type(b) != Number_Literal) return binary_fallback(procedure, a, b);
+    return value_from_boolean(number_compare(a, b) == -1 ? R_TRUE : R_FALSE);
+}
+
+static AST_Node *racket_native_binary_number_more_than(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    if (value_type(a) != Number_Literal || value_type(b) != Number_Literal) return binary_fallback(procedure, a, b);
+    return value_from_boolean(number_compare(a, b) == 1 ? R_TRUE : R_FALSE);
+}
+
+static AST_Node *racket_native_binary_less_or_equal_than(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    if (value_type(a) != Number_Literal || value_type(b) != Number_Literal) return binary_fallback(procedure, a, b);
+    int order = number_compare(a, b);
+    return value_from_boolean(order == -1 || order == 0 ? R_TRUE : R_FALSE);
+}
+
+static AST_Node *racket_native_binary_more_or_equal_than(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    if (value_type(a) != Number_Literal || value_type(b) != Number_Literal) return binary_fallback(procedure, a, b);
+    int order = number_compare(a, b);
+    return value_from_boolean(order == 1 || order == 0 ? R_TRUE : R_FALSE);
+}
+
+// an flvector operand, or exit with racket's complaint
+static AST_Node *flvector_operand(AST_Node *procedure, Vector *operands, size_t i)
+{
+    AST_Node *operand = *(AST_Node **)VectorNth(operands, i);
+    if (value_type(operand) != Flvector)
+    {
+        fprintf(stderr, "#<procedure:%s>: operands must be flvector\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
+    }
+    return operand;
+}
+
+// a flonum operand as a double, exact numbers are refused like racket does
+static double flonum_operand(AST_Node *procedure, Vector *operands, size_t i)
+{
+    AST_Node *operand = *(AST_Node **)VectorNth(operands, i);
+    if (value_type(operand) != Number_Literal || value_is_exact(operand))
+    {
+        fprintf(stderr, "#<procedure:%s>: operands must be flonum\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
+    }
+    return value_to_double(operand);
+}
+
+// an exact index below length
+static size_t index_operand(AST_Node *procedure, Vector *operands, size_t i, size_t length)
+{
+    AST_Node *operand = *(AST_Node **)VectorNth(operands, i);
+    if (!value_is_fixnum(operand) || value_to_fixnum(operand) < 0)
+    {
+        fprintf(stderr, "#<procedure:%s>: index must be exact-nonnegative-integer\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
+    }
+
+    long long int index = value_to_fixnum(operand);
+    if ((unsigned long long int)index >= length)
+    {
+        fprintf(stderr, "%s: index is out of range\n"
+                        "index: %lld\n"
+                        "valid range: [0, %lld]\n", procedure->contents.procedure.name, index, (long long int)length - 1);
+        exit(EXIT_FAILURE);
+    }
+    return TYPECAST(size_t, index);
+}
+
+// (flvector x ...) -> flvector?
+static AST_Node *racket_native_flvector(AST_Node *procedure, Vector *operands)
+{
+    size_t operands_count = VectorLength(operands);
+
+    // check every operand before the elements are allocated
+    for (size_t i = 0; i < operands_count; i++) flonum_operand(procedure, operands, i);
+
+    AST_Node *flvector = ast_node_new(NOT_IN_AST, Flvector, operands_count);
+    for (size_t i = 0; i < operands_count; i++)
+    {
+        flvector->contents.flvector.elements[i] = flonum_operand(procedure, operands, i);
+    }
+
+    return flvector;
+}
+
+// (make-flvector size [x]) -> flvector?, x is 0.0 by default
+static AST_Node *racket_native_make_flvector(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count < arity || operands_count > arity + 1)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu to %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, arity + 1, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *size = *(AST_Node **)VectorNth(operands, 0);
+    if (!value_is_fixnum(size) || value_to_fixnum(size) < 0)
+    {
+        fprintf(stderr, "#<procedure:%s>: size must be exact-nonnegative-integer\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
+    }
+    double x = operands_count == 2 ? flonum_operand(procedure, operands, 1) : 0.0;
+
+    size_t length = TYPECAST(size_t, value_to_fixnum(size));
+    AST_Node *flvector = ast_node_new(NOT_IN_AST, Flvector, length);
+    if (operands_count == 2)
+    {
+        for (size_t i = 0; i < length; i++) flvector->contents.flvector.elements[i] = x;
+    }
+
+    return flvector;
+}
+
+// (flvector-length vec) -> exact-nonnegative-integer?
+static AST_Node *racket_native_flvector_length(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *vec = flvector_operand(procedure, operands, 0);
+    return value_from_integer(TYPECAST(long long int, vec->contents.flvector.length));
+}
+
+// (flvector-ref vec pos) -> flonum?
+static AST_Node *racket_native_flvector_ref(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *vec = flvector_operand(procedure, operands, 0);
+    size_t pos = index_operand(procedure, operands, 1, vec->contents.flvector.length);
+    return value_from_double(vec->contents.flvector.elements[pos]);
+}
+
+// (flvector-set! vec pos x) -> void?
+static AST_Node *racket_native_flvector_set(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *vec = flvector_operand(procedure, operands, 0);
+    size_t pos = index_operand(procedure, operands, 1, vec->contents.flvector.length);
+    vec->contents.flvector.elements[pos] = flonum_operand(procedure, operands, 2);
+    return NULL; // void, like set!
+}
+
+// (flvector+ xs ys) and (flvector* xs ys) -> flvector?, element-wise over vectors of the same length
+static AST_Node *flvector_elementwise(AST_Node *procedure, Vector *operands,
+                                      void (*kernel)(double *result, const double *a, const double *b, size_t length))
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *xs = flvector_operand(procedure, operands, 0);
+    AST_Node *ys = flvector_operand(procedure, operands, 1);
+    size_t length = xs->contents.flvector.length;
+    if (ys->contents.flvector.length != length)
+    {
+        fprintf(stderr, "%s: flvectors must have the same length\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
+    }
+
+    // xs and ys are operands, so they stay rooted while the result is allocated
+    AST_Node *result = ast_node_new(NOT_IN_AST, Flvector, length);
+    kernel(result->contents.flvector.elements, xs->contents.flvector.elements, ys->contents.flvector.elements, length);
+    return result;
+}
+
+static AST_Node *racket_native_flvector_add(AST_Node *procedure, Vector *operands)
+{
+    return flvector_elementwise(procedure, operands, flvector_add);
+}
+
+static AST_Node *racket_native_flvector_multiply(AST_Node *procedure, Vector *operands)
+{
+    return flvector_elementwise(procedure, operands, flvector_multiply);
+}
+
+// (flvector-sum xs) -> flonum?
+static AST_Node *racket_native_flvector_sum(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *xs = flvector_operand(procedure, operands, 0);
+    return value_from_double(flvector_sum(xs->contents.flvector.elements, xs->contents.flvector.length));
+}
+
+// (flvector-dot xs ys) -> flonum?, the sum of the element-wise products
+static AST_Node *racket_native_flvector_dot(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *xs = flvector_operand(procedure, operands, 0);
+    AST_Node *ys = flvector_operand(procedure, operands, 1);
+    if (ys->contents.flvector.length != xs->contents.flvector.length)
+    {
+        fprintf(stderr, "%s: flvectors must have the same length\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
+    }
+
+    return value_from_double(flvector_dot(xs->contents.flvector.elements, ys->contents.flvector.elements, xs->contents.flvector.length));
+}
+
+// a number operand, or exit with racket's complaint
+static AST_Node *number_operand(AST_Node *procedure, Vector *operands, size_t i)
+{
+    AST_Node *operand = *(AST_Node **)VectorNth(operands, i);
+    if (value_type(operand) != Number_Literal)
+    {
+        fprintf(stderr, "#<procedure:%s>: operands must be number\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
+    }
+    return operand;
+}
+
+// the only operand of a unary math procedure
+static AST_Node *unary_number_operand(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    return number_operand(procedure, operands, 0);
+}
+
+// (sqrt z) -> number?, exact for an exact square, the root of a negative number is complex, which is not supported
+static AST_Node *racket_native_sqrt(AST_Node *procedure, Vector *operands)
+{
+    AST_Node *z = unary_number_operand(procedure, operands);
+    if (number_compare(z, value_from_fixnum(0)) == -1)
+    {
+        fprintf(stderr, "sqrt: complex results are not supported\n");
+        exit(EXIT_FAILURE);
+    }
+    return number_sqrt(z);
+}
+
+// (abs x) -> number?
+static AST_Node *racket_native_abs(AST_Node *procedure, Vector *operands)
+{
+    return number_abs(unary_number_operand(procedure, operands));
+}
+
+// (floor x), (ceiling x), (round x), (truncate x) -> number?, of the same exactness as x
+static AST_Node *racket_native_floor(AST_Node *procedure, Vector *operands)
+{
+    return number_round(unary_number_operand(procedure, operands), NUMBER_FLOOR);
+}
+
+static AST_Node *racket_native_ceiling(AST_Node *procedure, Vector *operands)
+{
+    return number_round(unary_number_operand(procedure, operands), NUMBER_CEILING);
+}
+
+static AST_Node *racket_native_round(AST_Node *procedure, Vector *operands)
+{
+    return number_round(unary_number_operand(procedure, operands), NUMBER_ROUND);
+}
+
+static AST_Node *racket_native_truncate(AST_Node *procedure, Vector *operands)
+{
+    return number_round(unary_number_operand(procedure, operands), NUMBER_TRUNCATE);
+}
+
+// (exp z), (log z), (sin z), (cos z) -> number?, inexact except at the exact point racket keeps exact, such as (exp 0) -> 1
+static AST_Node *elementary_function(AST_Node *procedure, Vector *operands, double (*function)(double x),
+                                     long long int exact_argument, long long int exact_result)
+{
+    AST_Node *z = unary_number_operand(procedure, operands);
+    if (z == value_from_fixnum(exact_argument)) return value_from_fixnum(exact_result);
+    return value_from_double(function(value_to_double(z)));
+}
+
+static AST_Node *racket_native_exp(AST_Node *procedure, Vector *operands)
+{
+    return elementary_function(procedure, operands, exp, 0, 1);
+}
+
+static AST_Node *racket_native_log(AST_Node *procedure, Vector *operands)
+{
+    AST_Node *z = unary_number_operand(procedure, operands);
+    if (z == value_from_fixnum(0))
+    {
+        fprintf(stderr, "log: undefined for 0\n");
+        exit(EXIT_FAILURE);
+    }
+    if (number_compare(z, value_from_fixnum(0)) == -1)
+    {
+        fprintf(stderr, "log: complex results are not supported\n");
+        exit(EXIT_FAILURE);
+    }
+    return elementary_function(procedure, operands, log, 1, 0);
+}
+
+static AST_Node *racket_native_sin(AST_Node *procedure, Vector *operands)
+{
+    return elementary_function(procedure, operands, sin, 0, 0);
+}
+
+static AST_Node *racket_native_cos(AST_Node *procedure, Vector *operands)
+{
+    return elementary_function(procedure, operands, cos, 0, 1);
+}
+
+// (expt z w) -> number?, exact when z is exact and w is an exact integer
+static AST_Node *racket_native_expt(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *base = number_operand(procedure, operands, 0);
+    AST_Node *exponent = number_operand(procedure, operands, 1);
+    if (base == value_from_fixnum(0) && value_is_exact(exponent) && number_compare(exponent, value_from_fixnum(0)) < 0)
+    {
+        fprintf(stderr, "expt: division by zero\n");
+        exit(EXIT_FAILURE);
+    }
+    // any other exact base to a bignum power has more digits than memory can hold
+    if (value_is_exact(base) && value_is_bignum(exponent) &&
+        base != value_from_fixnum(0) && base != value_from_fixnum(1) && base != value_from_fixnum(-1))
+    {
+        fprintf(stderr, "expt: out of memory\n"
+                        "the exact result is too large\n");
+        exit(EXIT_FAILURE);
+    }
+    return number_expt(base, exponent);
+}
+
+// (quotient n m), (remainder n m), (modulo n m) -> integer?, exact integers never go through double
+static AST_Node *integer_division(AST_Node *procedure, Vector *operands, Number_Division division)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    for (size_t i = 0; i < operands_count; i++)
+    {
+        if (number_is_integer(number_operand(procedure, operands, i)) == false)
+        {
+            fprintf(stderr, "#<procedure:%s>: operands must be integer\n", procedure->contents.procedure.name);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    AST_Node *n = *(AST_Node **)VectorNth(operands, 0);
+    AST_Node *m = *(AST_Node **)VectorNth(operands, 1);
+    if (value_to_double(m) == 0)
+    {
+        fprintf(stderr, "%s: undefined for 0\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
+    }
+    return number_integer_divide(n, m, division);
+}
+
+static AST_Node *racket_native_quotient(AST_Node *procedure, Vector *operands)
+{
+    return integer_division(procedure, operands, NUMBER_QUOTIENT);
+}
+
+static AST_Node *racket_native_remainder(AST_Node *procedure, Vector *operands)
+{
+    return integer_division(procedure, operands, NUMBER_REMAINDER);
+}
+
+static AST_Node *racket_native_modulo(AST_Node *procedure, Vector *operands)
+{
+    return integer_division(procedure, operands, NUMBER_MODULO);
+}
+
+// (min x ...+) and (max x ...+) -> number?, inexact when any x is, NaN when any x is
+static AST_Node *extremum(AST_Node *procedure, Vector *operands, int wanted_order)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count < arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: at least %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *result = number_operand(procedure, operands, 0);
+    bool inexact = !value_is_exact(result);
+    for (size_t i = 1; i < operands_count; i++)
+    {
+        AST_Node *x = number_operand(procedure, operands, i);
+        if (!value_is_exact(x)) inexact = true;
+
+        int order = number_compare(x, result);
+        if (order == NUMBER_UNORDERED) result = value_from_double(NAN);
+        else if (order == wanted_order) result = x;
+    }
+
+    if (inexact == true) return value_from_double(value_to_double(result));
+    return result;
+}
+
+static AST_Node *racket_native_min(AST_Node *procedure, Vector *operands)
+{
+    return extremum(procedure, operands, -1);
+}
+
+static AST_Node *racket_native_max(AST_Node *procedure, Vector *operands)
+{
+    return extremum(procedure, operands, 1);
+}
+
+// (flvector-sqrt xs), (flvector-exp xs) ... -> flvector?, the function of every element in one native call
+static AST_Node *flvector_unary(AST_Node *procedure, Vector *operands,
+                                void (*kernel)(double *result, const double *a, size_t length), double (*function)(double x))
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *xs = flvector_operand(procedure, operands, 0);
+    size_t length = xs->contents.flvector.length;
+
+    // xs is an operand, so it stays rooted while the result is allocated
+    AST_Node *result = ast_node_new(NOT_IN_AST, Flvector, length);
+    if (kernel != NULL) kernel(result->contents.flvector.elements, xs->contents.flvector.elements, length);
+    else flvector_map(result->contents.flvector.elements, xs->contents.flvector.elements, length, function);
+    return result;
+}
+
+static AST_Node *racket_native_flvector_sqrt(AST_Node *procedure, Vector *operands)
+{
+    return flvector_unary(procedure, operands, flvector_sqrt, NULL);
+}
+
+static AST_Node *racket_native_flvector_abs(AST_Node *procedure, Vector *operands)
+{
+    return flvector_unary(procedure, operands, flvector_abs, NULL);
+}
+
+static AST_Node *racket_native_flvector_exp(AST_Node *procedure, Vector *operands)
+{
+    return flvector_unary(procedure, operands, NULL, exp);
+}
+
+static AST_Node *racket_native_flvector_log(AST_Node *procedure, Vector *operands)
+{
+    return flvector_unary(procedure, operands, NULL, log);
+}
+
+static AST_Node *racket_native_flvector_sin(AST_Node *procedure, Vector *operands)
+{
+    return flvector_unary(procedure, operands, NULL, sin);
+}
+
+static AST_Node *racket_native_flvector_cos(AST_Node *procedure, Vector *operands)
+{
+    return flvector_unary(procedure, operands, NULL, cos);
+}
+
+static AST_Node *racket_native_flvector_floor(AST_Node *procedure, Vector *operands)
+{
+    return flvector_unary(procedure, operands, NULL, floor);
+}
+
+static AST_Node *racket_native_flvector_ceiling(AST_Node *procedure, Vector *operands)
+{
+    return flvector_unary(procedure, operands, NULL, ceil);
+}
+
+static AST_Node *racket_native_flvector_round(AST_Node *procedure, Vector *operands)
+{
+    return flvector_unary(procedure, operands, NULL, nearbyint);
+}
+
+static AST_Node *racket_native_flvector_truncate(AST_Node *procedure, Vector *operands)
+{
+    return flvector_unary(procedure, operands, NULL, trunc);
+}
+
+// an exact integer operand, a fixnum or a bignum
+static AST_Node *exact_integer_operand(AST_Node *procedure, Vector *operands, size_t i)
+{
+    AST_Node *operand = *(AST_Node **)VectorNth(operands, i);
+    if (!value_is_fixnum(operand) && !value_is_bignum(operand))
+    {
+        fprintf(stderr, "#<procedure:%s>: operands must be exact integer\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
+    }
+    return operand;
+}
+
+// (bitwise-and n ...), (bitwise-ior n ...), (bitwise-xor n ...) -> exact-integer?
+static AST_Node *bitwise_fold(AST_Node *procedure, Vector *operands, Bignum_Bitwise operation)
+{
+    // every step makes its result after it is done with the operands, so the result so far needs no rooting
+    AST_Node *result = value_from_fixnum(operation == BIGNUM_AND ? -1 : 0);
+    for (size_t i = 0; i < VectorLength(operands); i++)
+    {
+        result = number_bitwise(result, exact_integer_operand(procedure, operands, i), operation);
+    }
+    return result;
+}
+
+static AST_Node *racket_native_bitwise_and(AST_Node *procedure, Vector *operands)
+{
+    return bitwise_fold(procedure, operands, BIGNUM_AND);
+}
+
+static AST_Node *racket_native_bitwise_ior(AST_Node *procedure, Vector *operands)
+{
+    return bitwise_fold(procedure, operands, BIGNUM_IOR);
+}
+
+static AST_Node *racket_native_bitwise_xor(AST_Node *procedure, Vector *operands)
+{
+    return bitwise_fold(procedure, operands, BIGNUM_XOR);
+}
+
+// two fixnums stay in native words, anything else goes through the variadic entry point
+static AST_Node *racket_native_binary_bitwise_and(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    if (!value_is_fixnum(a) || !value_is_fixnum(b)) return binary_fallback(procedure, a, b);
+    return value_from_fixnum(value_to_fixnum(a) & value_to_fixnum(b));
+}
+
+static AST_Node *racket_native_binary_bitwise_ior(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    if (!value_is_fixnum(a) || !value_is_fixnum(b)) return binary_fallback(procedure, a, b);
+    return value_from_fixnum(value_to_fixnum(a) | value_to_fixnum(b));
+}
+
+static AST_Node *racket_native_binary_bitwise_xor(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    if (!value_is_fixnum(a) || !value_is_fixnum(b)) return binary_fallback(procedure, a, b);
+    return value_from_fixnum(value_to_fixnum(a) ^ value_to_fixnum(b));
+}
+
+// (bitwise-not n) -> exact-integer?
+static AST_Node *racket_native_bitwise_not(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    return number_bitwise_not(exact_integer_operand(procedure, operands, 0));
+}
+
+// (arithmetic-shift n m) -> exact-integer?, n * 2^m rounded down
+static AST_Node *racket_native_arithmetic_shift(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *n = exact_integer_operand(procedure, operands, 0);
+    AST_Node *m = exact_integer_operand(procedure, operands, 1);
+    if (value_is_bignum(m))
+    {
+        // only a shift to the right or of 0 can be done, it leaves the sign
+        if (value_to_bignum(m)->negative == true || n == value_from_fixnum(0))
+            return value_from_fixnum(number_compare(n, value_from_fixnum(0)) < 0 ? -1 : 0);
+        fprintf(stderr, "%s: shift is too large\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
+    }
+    return number_arithmetic_shift(n, value_to_fixnum(m));
+}
+
+// (bitwise-bit-set? n m) -> boolean?, whether bit m of n in two's complement is 1
+static AST_Node *racket_native_bitwise_bit_set(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *n = exact_integer_operand(procedure, operands, 0);
+    AST_Node *m = exact_integer_operand(procedure, operands, 1);
+    if (number_compare(m, value_from_fixnum(0)) < 0)
+    {
+        fprintf(stderr, "#<procedure:%s>: bit index must be exact-nonnegative-integer\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
+    }
+
+    // beyond the magnitude every bit is the sign
+    if (value_is_bignum(m)) return value_from_boolean(number_compare(n, value_from_fixnum(0)) < 0 ? R_TRUE : R_FALSE);
+
+    // -m and m are both odd or both even, so the lowest bit of the magnitude is the one of two's complement
+    AST_Node *shifted = number_arithmetic_shift(n, -value_to_fixnum(m));
+    bool odd = value_is_fixnum(shifted) ? (value_to_fixnum(shifted) & 1) != 0 : (value_to_bignum(shifted)->limbs[0] & 1) != 0;
+    return value_from_boolean(odd == true ? R_TRUE : R_FALSE);
+}
+
+// (integer-length n) -> exact-integer?
+static AST_Node *racket_native_integer_length(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    return value_from_integer((long long int)number_integer_length(exact_integer_operand(procedure, operands, 0)));
+}
+
+// a vector operand, one which is changed must not be IMMUTABLE, such as a literal
+static AST_Node *vector_operand(AST_Node *procedure, Vector *operands, size_t i, bool mutable)
+{
+    AST_Node *operand = *(AST_Node **)VectorNth(operands, i);
+    if (value_type(operand) != Racket_Vector)
+    {
+        fprintf(stderr, "#<procedure:%s>: operands must be vector\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
+    }
+    if (mutable == true && operand->tag == IMMUTABLE)
+    {
+        fprintf(stderr, "%s: contract violation\n"
+                        "expected: (and/c vector? (not/c immutable?))\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
+    }
+    return operand;
+}
+
+// (vector v ...) -> vector?
+static AST_Node *racket_native_vector(AST_Node *procedure, Vector *operands)
+{
+    size_t operands_count = VectorLength(operands);
+
+    AST_Node *vector = ast_node_new(NOT_IN_AST, Racket_Vector, operands_count, NULL);
+    if (operands_count > 0)
+    {
+        memcpy(vector->contents.racket_vector.elements, VectorNth(operands, 0), sizeof(AST_Node *) * operands_count);
+    }
+
+    return vector;
+}
+
+// (make-vector size [v]) -> vector?, v is 0 by default
+static AST_Node *racket_native_make_vector(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count < arity || operands_count > arity + 1)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu to %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, arity + 1, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *size = *(AST_Node **)VectorNth(operands, 0);
+    if (!value_is_fixnum(size) || value_to_fixnum(size) < 0)
+    {
+        fprintf(stderr, "#<procedure:%s>: size must be exact-nonnegative-integer\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
+    }
+    AST_Node *v = operands_count == 2 ? *(AST_Node **)VectorNth(operands, 1) : value_from_fixnum(0);
+
+    return ast_node_new(NOT_IN_AST, Racket_Vector, TYPECAST(size_t, value_to_fixnum(size)), v);
+}
+
+// (vector-length vec) -> exact-nonnegative-integer?
+static AST_Node *racket_native_vector_length(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *vec = vector_operand(procedure, operands, 0, false);
+    return value_from_integer(TYPECAST(long long int, vec->contents.racket_vector.length));
+}
+
+// (vector-ref vec pos) -> any/c
+static AST_Node *racket_native_vector_ref(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *vec = vector_operand(procedure, operands, 0, false);
+    size_t pos = index_operand(procedure, operands, 1, vec->contents.racket_vector.length);
+    return vec->contents.racket_vector.elements[pos];
+}
+
+static AST_Node *racket_native_binary_vector_ref(AST_Node *procedure, AST_Node *vec, AST_Node *pos)
+{
+    if (value_type(vec) != Racket_Vector || !value_is_fixnum(pos) || value_to_fixnum(pos) < 0 ||
+        (unsigned long long int)value_to_fixnum(pos) >= vec->contents.racket_vector.length)
+        return binary_fallback(procedure, vec, pos);
+    return vec->contents.racket_vector.elements[value_to_fixnum(pos)];
+}
+
+// (vector-set! vec pos v) -> void?
+static AST_Node *racket_native_vector_set(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *vec = vector_operand(procedure, operands, 0, true);
+    size_t pos = index_operand(procedure, operands, 1, vec->contents.racket_vector.length);
+    AST_Node *v = *(AST_Node **)VectorNth(operands, 2);
+    vec->contents.racket_vector.elements[pos] = v;
+    gc_write_barrier(vec, v);
+    return NULL; // void, like set!
+}
+
+// (vector-fill! vec v) -> void?
+static AST_Node *racket_native_vector_fill(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *vec = vector_operand(procedure, operands, 0, true);
+    AST_Node *v = *(AST_Node **)VectorNth(operands, 1);
+    for (size_t i = 0; i < vec->contents.racket_vector.length; i++)
+    {
+        vec->contents.racket_vector.elements[i] = v;
+    }
+    gc_write_barrier(vec, v);
+    return NULL;
+}
+
+// (vector-copy! dest dest-start src [src-start src-end]) -> void?, dest and src may be the same vector and overlap
+static AST_Node *racket_native_vector_copy(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count < arity || operands_count > arity + 2)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu to %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, arity + 2, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    // a start or an end may be the length itself, so the positions are checked as indexes below length + 1
+    AST_Node *dest = vector_operand(procedure, operands, 0, true);
+    size_t dest_start = index_operand(procedure, operands, 1, dest->contents.racket_vector.length + 1);
+    AST_Node *src = vector_operand(procedure, operands, 2, false);
+    size_t src_start = operands_count > 3 ? index_operand(procedure, operands, 3, src->contents.racket_vector.length + 1) : 0;
+    size_t src_end = operands_count > 4 ? index_operand(procedure, operands, 4, src->contents.racket_vector.length + 1) : src->contents.racket_vector.length;
+    if (src_end < src_start)
+    {
+        fprintf(stderr, "%s: ending index is smaller than starting index\n"
+                        "ending index: %zu\n"
+                        "starting index: %zu\n", procedure->contents.procedure.name, src_end, src_start);
+        exit(EXIT_FAILURE);
+    }
+
+    size_t count = src_end - src_start;
+    if (count > dest->contents.racket_vector.length - dest_start)
+    {
+        fprintf(stderr, "%s: not enough room in target vector\n"
+                        "target start: %zu\n"
+                        "source length: %zu\n", procedure->contents.procedure.name, dest_start, count);
+        exit(EXIT_FAILURE);
+    }
+    if (count == 0) return NULL;
+
+    AST_Node **elements = &dest->contents.racket_vector.elements[dest_start];
+    memmove(elements, &src->contents.racket_vector.elements[src_start], sizeof(AST_Node *) * count);
+    for (size_t i = 0; i < count; i++)
+    {
+        gc_write_barrier(dest, elements[i]);
+    }
+    return NULL;
+}
+
+typedef enum _z_hash_kind {
+    ANY_HASH, MUTABLE_HASH, IMMUTABLE_HASH
+} Hash_Kind;
+
+// a hash operand of kind, or exit with racket's complaint, the mutable ones are tables, the IMMUTABLE ones tries
+static AST_Node *hash_operand(AST_Node *procedure, Vector *operands, size_t i, Hash_Kind kind)
+{
+    AST_Node *operand = *(AST_Node **)VectorNth(operands, i);
+    if (value_type(operand) != Racket_Hash)
+    {
+        fprintf(stderr, "#<procedure:%s>: operands must be hash\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
+    }
+    if (kind == MUTABLE_HASH && operand->tag == IMMUTABLE)
+    {
+        fprintf(stderr, "%s: contract violation\n"
+                        "expected: (and/c hash? (not/c immutable?))\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
+    }
+    if (kind == IMMUTABLE_HASH && operand->tag != IMMUTABLE)
+    {
+        fprintf(stderr, "%s: contract violation\n"
+                        "expected: (and/c hash? immutable?)\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
+    }
+    return operand;
+}
+
+// an IMMUTABLE hash of the trie root, which must be rooted by the caller, a new hash is young, it needs no write barrier
+static AST_Node *immutable_hash(AST_Node *root, size_t length)
+{
+    AST_Node *hash = ast_node_new(NOT_IN_AST, Racket_Hash, NULL, root, length);
+    ast_node_set_tag(hash, IMMUTABLE);
+    return hash;
+}
+
+// hash_table_for_each() or hamt_for_each(), whichever hash has
+static void hash_for_each(AST_Node *hash, Hash_Table_Function function, void *aux_data)
+{
+    if (hash->contents.racket_hash.table != NULL)
+        hash_table_for_each(hash->contents.racket_hash.table, function, aux_data);
+    else
+        hamt_for_each(hash->contents.racket_hash.root, function, aux_data);
+}
+
+// the value of key in hash, found is false when key is not in it
+static AST_Node *hash_lookup(AST_Node *hash, AST_Node *key, bool *found)
+{
+    if (hash->contents.racket_hash.table == NULL) return hamt_get(hash->contents.racket_hash.root, key, found);
+
+    Hash_Table_Entry *entry = hash_table_get(hash->contents.racket_hash.table, key);
+    *found = entry != NULL;
+    return entry != NULL ? entry->value : NULL;
+}
+
+// the failure-result operand i of hash-ref or hash-update when the key is missing, a procedure is called with no operands
+static AST_Node *hash_failure_result(AST_Node *procedure, Vector *operands, size_t i)
+{
+    if (VectorLength(operands) <= i)
+    {
+        fprintf(stderr, "%s: no value found for key\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
+    }
+
+    AST_Node *failure_result = *(AST_Node **)VectorNth(operands, i);
+    if (value_type(failure_result) != Procedure) return failure_result;
+
+    return apply_procedure(failure_result, 0, NULL);
+}
+
+// (make-hash [assocs]) and (make-hasheq [assocs]) -> hash?, assocs is a list of pairs of a key and its value
+static AST_Node *make_hash(AST_Node *procedure, Vector *operands, Hash_Table_Equality equality)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count < arity || operands_count > arity + 1)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu to %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, arity + 1, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *assocs = operands_count == 1 ? *(AST_Node **)VectorNth(operands, 0) : value_empty_list();
+    bool assocs_valid = value_is_list(assocs);
+    for (AST_Node *assoc = assocs; assocs_valid == true && value_is_pair(assoc); assoc = value_cdr(assoc))
+    {
+        if (!value_is_pair(value_car(assoc))) assocs_valid = false;
+    }
+    if (assocs_valid == false)
+    {
+        fprintf(stderr, "%s: contract violation\n"
+                        "expected: (listof pair?)\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
+    }
+
+    // a new table is young, it needs no write barrier
+    AST_Node *hash = ast_node_new(NOT_IN_AST, Racket_Hash, hash_table_new(equality), NULL, (size_t)0);
+    for (AST_Node *assoc = assocs; value_is_pair(assoc); assoc = value_cdr(assoc))
+    {
+        AST_Node *pair = value_car(assoc);
+        hash_table_set(hash->contents.racket_hash.table, value_car(pair), value_cdr(pair));
+    }
+
+    return hash;
+}
+
+static AST_Node *racket_native_make_hash(AST_Node *procedure, Vector *operands)
+{
+    return make_hash(procedure, operands, HASH_EQUAL);
+}
+
+static AST_Node *racket_native_make_hasheq(AST_Node *procedure, Vector *operands)
+{
+    return make_hash(procedure, operands, HASH_EQ);
+}
+
+// (hash-ref hash key [failure-result]) -> any/c, a procedure as failure-result is called with no operands
+static AST_Node *racket_native_hash_ref(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count < arity || operands_count > arity + 1)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu to %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, arity + 1, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *hash = hash_operand(procedure, operands, 0, ANY_HASH);
+    bool found = false;
+    AST_Node *value = hash_lookup(hash, *(AST_Node **)VectorNth(operands, 1), &found);
+    if (found == true) return value;
+    return hash_failure_result(procedure, operands, 2);
+}
+
+// (hash-set! hash key v) -> void?
+static AST_Node *racket_native_hash_set(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *hash = hash_operand(procedure, operands, 0, MUTABLE_HASH);
+    AST_Node *key = *(AST_Node **)VectorNth(operands, 1);
+    AST_Node *v = *(AST_Node **)VectorNth(operands, 2);
+    hash_table_set(hash->contents.racket_hash.table, key, v);
+    gc_write_barrier(hash, key);
+    gc_write_barrier(hash, v);
+    return NULL;
+}
+
+// (hash-remove! hash key) -> void?
+static AST_Node *racket_native_hash_remove(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *hash = hash_operand(procedure, operands, 0, MUTABLE_HASH);
+    hash_table_remove(hash->contents.racket_hash.table, *(AST_Node **)VectorNth(operands, 1));
+    return NULL;
+}
+
+// (hash-count hash) -> exact-nonnegative-integer?
+static AST_Node *racket_native_hash_count(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *hash = hash_operand(procedure, operands, 0, ANY_HASH);
+    Hash_Table *table = hash->contents.racket_hash.table;
+    return value_from_integer(TYPECAST(long long int, table != NULL ? table->length : hash->contents.racket_hash.length));
+}
+
+// the key and the value of every entry in a AST_Node *[]
+static void collect_entry(Hash_Table_Entry *entry, void *aux_data)
+{
+    VectorAppend(TYPECAST(Vector *, aux_data), &entry->key);
+    VectorAppend(TYPECAST(Vector *, aux_data), &entry->value);
+}
+
+// (hash-keys hash) -> list?, in no particular order
+static AST_Node *racket_native_hash_keys(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    // the keys are held by the hash, which is held by operands
+    AST_Node *hash = hash_operand(procedure, operands, 0, ANY_HASH);
+    Vector *entries = VectorNew(sizeof(AST_Node *));
+    hash_for_each(hash, collect_entry, entries);
+
+    AST_Node *list = value_empty_list();
+    gc_push_values(&list, 1);
+    for (size_t i = VectorLength(entries); i > 0; i -= 2)
+    {
+        list = value_cons(*(AST_Node **)VectorNth(entries, i - 2), list);
+    }
+    gc_pop(1);
+    VectorFree(entries, NULL, NULL);
+    return list;
+}
+
+// (hash-for-each hash proc) -> void?, proc is called with every key and its value, in no particular order
+static AST_Node *racket_native_hash_for_each(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *hash = hash_operand(procedure, operands, 0, ANY_HASH);
+    AST_Node *fn = *(AST_Node **)VectorNth(operands, 1);
+    if (value_type(fn) != Procedure)
+    {
+        fprintf(stderr, "#<procedure:%s>: operands must be procedure\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
+    }
+
+    // proc may change a table, so it walks a copy of the entries, which keeps them alive as well
+    Vector *entries = VectorNew(sizeof(AST_Node *));
+    hash_for_each(hash, collect_entry, entries);
+    gc_push_vector(entries);
+
+    for (size_t i = 0; i < VectorLength(entries); i += 2)
+    {
+        apply_procedure(fn, 2, (AST_Node **)VectorNth(entries, i));
+    }
+
+    gc_pop(1);
+    VectorFree(entries, NULL, NULL);
+    return NULL;
+}
+
+// (hash key val ... ...) -> (and/c hash? immutable?)
+static AST_Node *racket_native_hash(AST_Node *procedure, Vector *operands)
+{
+    size_t operands_count = VectorLength(operands);
+    if (operands_count % 2 != 0)
+    {
+        fprintf(stderr, "%s: key does not have a value (i.e., an odd number of arguments were provided)\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
+    }
+
+    AST_Node *root = NULL;
+    size_t length = 0;
+    gc_push_values(&root, 1);
+    for (size_t i = 0; i < operands_count; i += 2)
+    {
+        bool added = false;
+        root = hamt_set(root, *(AST_Node **)VectorNth(operands, i), *(AST_Node **)VectorNth(operands, i + 1), &added);
+        if (added == true) length++;
+    }
+    AST_Node *hash = immutable_hash(root, length);
+    gc_pop(1);
+    return hash;
+}
+
+// (hash-set hash key v) -> (and/c hash? immutable?), hash is unchanged, the new one shares all but the path to key with it
+static AST_Node *racket_native_hash_set_functional(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *hash = hash_operand(procedure, operands, 0, IMMUTABLE_HASH);
+    bool added = false;
+    AST_Node *root = hamt_set(hash->contents.racket_hash.root, *(AST_Node **)VectorNth(operands, 1), *(AST_Node **)VectorNth(operands, 2), &added);
+    if (root == hash->contents.racket_hash.root) return hash;
+
+    gc_push_values(&root, 1);
+    AST_Node *result = immutable_hash(root, hash->contents.racket_hash.length + (added == true ? 1 : 0));
+    gc_pop(1);
+    return result;
+}
+
+// (hash-remove hash key) -> (and/c hash? immutable?)
+static AST_Node *racket_native_hash_remove_functional(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count != arity)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *hash = hash_operand(procedure, operands, 0, IMMUTABLE_HASH);
+    bool removed = false;
+    AST_Node *root = hamt_remove(hash->contents.racket_hash.root, *(AST_Node **)VectorNth(operands, 1), &removed);
+    if (removed == false) return hash;
+
+    gc_push_values(&root, 1);
+    AST_Node *result = immutable_hash(root, hash->contents.racket_hash.length - 1);
+    gc_pop(1);
+    return result;
+}
+
+// (hash-update hash key updater [failure-result]) -> (and/c hash? immutable?), the value of key becomes (updater value)
+static AST_Node *racket_native_hash_update(AST_Node *procedure, Vector *operands)
+{
+    // check arity
+    size_t arity = procedure->contents.procedure.required_params_count;
+    size_t operands_count = VectorLength(operands);
+    if (operands_count < arity || operands_count > arity + 1)
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu to %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, arity, arity + 1, operands_count);
+        exit(EXIT_FAILURE); 
+    }
+
+    AST_Node *hash = hash_operand(procedure, operands, 0, IMMUTABLE_HASH);
+    AST_Node *key = *(AST_Node **)VectorNth(operands, 1);
+    AST_Node *updater = *(AST_Node **)VectorNth(operands, 2);
+    if (value_type(updater) != Procedure)
+    {
+        fprintf(stderr, "#<procedure:%s>: operands must be procedure\n", procedure->contents.procedure.name);
+        exit(EXIT_FAILURE);
+    }
+
+    bool found = false;
+    AST_Node *value = hash_lookup(hash, key, &found);
+    if (found == false) value = hash_failure_result(procedure, operands, 3);
+
+    // a failure thunk may have made value, the updater makes a new one
+    gc_push_values(&value, 1);
+    value = apply_procedure(updater, 1, &value);
+    gc_pop(1);
+
+    gc_push_values(&value, 1);
+    bool added = false;
+    AST_Node *root = hamt_set(hash->contents.racket_hash.root, key, value, &added);
+    gc_push_values(&root, 1);
+    AST_Node *result = immutable_hash(root, hash->contents.racket_hash.length + (added == true ? 1 : 0));
+    gc_pop(2);
+    return result;
+}
+
+Vector *generate_built_in_bindings(void)
+{
+    Vector *built_in_bindings = VectorNew(sizeof(AST_Node *));
+    AST_Node *binding = NULL;
+    AST_Node *procedure = NULL;
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "+", 0, NULL, NULL, TYPECAST(void(*)(void), racket_native_addition)); 
+    procedure->contents.procedure.c_native_binary_function = TYPECAST(void(*)(void), racket_native_binary_addition);
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "+", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE,Procedure,  "-", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_subtraction)); 
+    procedure->contents.procedure.c_native_binary_function = TYPECAST(void(*)(void), racket_native_binary_subtraction);
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "-", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "*", 0, NULL, NULL, TYPECAST(void(*)(void), racket_native_multiplication)); 
+    procedure->contents.procedure.c_native_binary_function = TYPECAST(void(*)(void), racket_native_binary_multiplication);
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "*", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "/", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_division)); 
+    procedure->contents.procedure.c_native_binary_function = TYPECAST(void(*)(void), racket_native_binary_division);
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "/", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "=", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_number_equal)); 
+    procedure->contents.procedure.c_native_binary_function = TYPECAST(void(*)(void), racket_native_binary_number_equal);
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "=", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, ">", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_number_more_than)); 
+    procedure->contents.procedure.c_native_binary_function = TYPECAST(void(*)(void), racket_native_binary_number_more_than);
     binding = ast_node_new(BUILT_IN_BINDING, Binding, ">", procedure);
     VectorAppend(built_in_bindings, &binding);
 
     procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "<", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_number_less_than)); 
+    procedure->contents.procedure.c_native_binary_function = TYPECAST(void(*)(void), racket_native_binary_number_less_than);
     binding = ast_node_new(BUILT_IN_BINDING, Binding, "<", procedure);
     VectorAppend(built_in_bindings, &binding);
 
@@ -1356,6 +2667,58 @@ Vector *generate_built_in_bindings(void)
     binding = ast_node_new(BUILT_IN_BINDING, Binding, "filter", procedure);
     VectorAppend(built_in_bindings, &binding);
 
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "foldl", 3, NULL, NULL, TYPECAST(void(*)(void), racket_native_foldl)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "foldl", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "foldr", 3, NULL, NULL, TYPECAST(void(*)(void), racket_native_foldr)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "foldr", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "for-each", 2, NULL, NULL, TYPECAST(void(*)(void), racket_native_for_each)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "for-each", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "andmap", 2, NULL, NULL, TYPECAST(void(*)(void), racket_native_andmap)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "andmap", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "ormap", 2, NULL, NULL, TYPECAST(void(*)(void), racket_native_ormap)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "ormap", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "apply", 2, NULL, NULL, TYPECAST(void(*)(void), racket_native_apply)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "apply", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "range", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_range)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "range", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "build-list", 2, NULL, NULL, TYPECAST(void(*)(void), racket_native_build_list)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "build-list", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "length", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_length)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "length", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "reverse", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_reverse)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "reverse", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "append", 0, NULL, NULL, TYPECAST(void(*)(void), racket_native_append)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "append", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "list-ref", 2, NULL, NULL, TYPECAST(void(*)(void), racket_native_list_ref)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "list-ref", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "list-tail", 2, NULL, NULL, TYPECAST(void(*)(void), racket_native_list_tail)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "list-tail", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
     procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "list?", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_is_list)); 
     binding = ast_node_new(BUILT_IN_BINDING, Binding, "list?", procedure);
     VectorAppend(built_in_bindings, &binding);
@@ -1381,13 +2744,275 @@ Vector *generate_built_in_bindings(void)
     VectorAppend(built_in_bindings, &binding);
 
     procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "<=", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_less_or_equal_than)); 
+    procedure->contents.procedure.c_native_binary_function = TYPECAST(void(*)(void), racket_native_binary_less_or_equal_than);
     binding = ast_node_new(BUILT_IN_BINDING, Binding, "<=", procedure);
     VectorAppend(built_in_bindings, &binding);
 
     procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, ">=", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_more_or_equal_than)); 
+    procedure->contents.procedure.c_native_binary_function = TYPECAST(void(*)(void), racket_native_binary_more_or_equal_than);
     binding = ast_node_new(BUILT_IN_BINDING, Binding, ">=", procedure);
     VectorAppend(built_in_bindings, &binding);
 
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "number->string", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_number_to_string)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "number->string", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "flvector", 0, NULL, NULL, TYPECAST(void(*)(void), racket_native_flvector)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "flvector", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "make-flvector", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_make_flvector)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "make-flvector", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "flvector-length", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_flvector_length)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "flvector-length", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "flvector-ref", 2, NULL, NULL, TYPECAST(void(*)(void), racket_native_flvector_ref)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "flvector-ref", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "flvector-set!", 3, NULL, NULL, TYPECAST(void(*)(void), racket_native_flvector_set)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "flvector-set!", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "flvector+", 2, NULL, NULL, TYPECAST(void(*)(void), racket_native_flvector_add)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "flvector+", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "flvector*", 2, NULL, NULL, TYPECAST(void(*)(void), racket_native_flvector_multiply)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "flvector*", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "flvector-sum", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_flvector_sum)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "flvector-sum", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "flvector-dot", 2, NULL, NULL, TYPECAST(void(*)(void), racket_native_flvector_dot)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "flvector-dot", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "sqrt", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_sqrt)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "sqrt", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "expt", 2, NULL, NULL, TYPECAST(void(*)(void), racket_native_expt)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "expt", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "exp", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_exp)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "exp", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "log", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_log)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "log", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "sin", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_sin)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "sin", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "cos", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_cos)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "cos", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "abs", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_abs)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "abs", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "floor", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_floor)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "floor", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "ceiling", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_ceiling)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "ceiling", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "round", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_round)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "round", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "truncate", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_truncate)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "truncate", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "min", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_min)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "min", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "max", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_max)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "max", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "quotient", 2, NULL, NULL, TYPECAST(void(*)(void), racket_native_quotient)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "quotient", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "remainder", 2, NULL, NULL, TYPECAST(void(*)(void), racket_native_remainder)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "remainder", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "modulo", 2, NULL, NULL, TYPECAST(void(*)(void), racket_native_modulo)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "modulo", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "flvector-sqrt", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_flvector_sqrt)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "flvector-sqrt", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "flvector-abs", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_flvector_abs)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "flvector-abs", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "flvector-exp", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_flvector_exp)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "flvector-exp", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "flvector-log", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_flvector_log)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "flvector-log", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "flvector-sin", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_flvector_sin)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "flvector-sin", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "flvector-cos", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_flvector_cos)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "flvector-cos", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "flvector-floor", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_flvector_floor)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "flvector-floor", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "flvector-ceiling", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_flvector_ceiling)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "flvector-ceiling", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "flvector-round", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_flvector_round)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "flvector-round", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "flvector-truncate", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_flvector_truncate)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "flvector-truncate", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "bitwise-and", 0, NULL, NULL, TYPECAST(void(*)(void), racket_native_bitwise_and)); 
+    procedure->contents.procedure.c_native_binary_function = TYPECAST(void(*)(void), racket_native_binary_bitwise_and);
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "bitwise-and", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "bitwise-ior", 0, NULL, NULL, TYPECAST(void(*)(void), racket_native_bitwise_ior)); 
+    procedure->contents.procedure.c_native_binary_function = TYPECAST(void(*)(void), racket_native_binary_bitwise_ior);
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "bitwise-ior", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "bitwise-xor", 0, NULL, NULL, TYPECAST(void(*)(void), racket_native_bitwise_xor)); 
+    procedure->contents.procedure.c_native_binary_function = TYPECAST(void(*)(void), racket_native_binary_bitwise_xor);
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "bitwise-xor", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "bitwise-not", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_bitwise_not)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "bitwise-not", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "arithmetic-shift", 2, NULL, NULL, TYPECAST(void(*)(void), racket_native_arithmetic_shift)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "arithmetic-shift", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "bitwise-bit-set?", 2, NULL, NULL, TYPECAST(void(*)(void), racket_native_bitwise_bit_set)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "bitwise-bit-set?", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "integer-length", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_integer_length)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "integer-length", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "vector", 0, NULL, NULL, TYPECAST(void(*)(void), racket_native_vector)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "vector", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "make-vector", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_make_vector)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "make-vector", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "vector-length", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_vector_length)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "vector-length", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "vector-ref", 2, NULL, NULL, TYPECAST(void(*)(void), racket_native_vector_ref)); 
+    procedure->contents.procedure.c_native_binary_function = TYPECAST(void(*)(void), racket_native_binary_vector_ref);
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "vector-ref", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "vector-set!", 3, NULL, NULL, TYPECAST(void(*)(void), racket_native_vector_set)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "vector-set!", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "vector-fill!", 2, NULL, NULL, TYPECAST(void(*)(void), racket_native_vector_fill)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "vector-fill!", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "vector-copy!", 3, NULL, NULL, TYPECAST(void(*)(void), racket_native_vector_copy)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "vector-copy!", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "make-hash", 0, NULL, NULL, TYPECAST(void(*)(void), racket_native_make_hash)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "make-hash", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "make-hasheq", 0, NULL, NULL, TYPECAST(void(*)(void), racket_native_make_hasheq)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "make-hasheq", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "hash-ref", 2, NULL, NULL, TYPECAST(void(*)(void), racket_native_hash_ref)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "hash-ref", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "hash-set!", 3, NULL, NULL, TYPECAST(void(*)(void), racket_native_hash_set)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "hash-set!", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "hash-remove!", 2, NULL, NULL, TYPECAST(void(*)(void), racket_native_hash_remove)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "hash-remove!", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "hash", 0, NULL, NULL, TYPECAST(void(*)(void), racket_native_hash)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "hash", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "hash-set", 3, NULL, NULL, TYPECAST(void(*)(void), racket_native_hash_set_functional)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "hash-set", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "hash-remove", 2, NULL, NULL, TYPECAST(void(*)(void), racket_native_hash_remove_functional)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "hash-remove", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "hash-update", 3, NULL, NULL, TYPECAST(void(*)(void), racket_native_hash_update)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "hash-update", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "hash-count", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_hash_count)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "hash-count", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "hash-keys", 1, NULL, NULL, TYPECAST(void(*)(void), racket_native_hash_keys)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "hash-keys", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, "hash-for-each", 2, NULL, NULL, TYPECAST(void(*)(void), racket_native_hash_for_each)); 
+    binding = ast_node_new(BUILT_IN_BINDING, Binding, "hash-for-each", procedure);
+    VectorAppend(built_in_bindings, &binding);
+
+    // racket/unsafe/ops, see racket_unsafe.h
+    Vector *unsafe_bindings = generate_unsafe_bindings();
+    for (size_t i = 0; i < VectorLength(unsafe_bindings); i++)
+    {
+        VectorAppend(built_in_bindings, VectorNth(unsafe_bindings, i));
+    }
+    VectorFree(unsafe_bindings, NULL, NULL);
+
     return built_in_bindings;
 }
 
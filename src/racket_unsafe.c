@@ -0,0 +1,222 @@
+#include "../include/global.h"
+#include "../include/racket_unsafe.h"
+#include "../include/parser.h"
+#include "../include/value.h"
+#include "../include/vector.h"
+#include "../include/gc.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef AST_Node *(*Unsafe_Binary_Function)(AST_Node *procedure, AST_Node *a, AST_Node *b);
+
+static AST_Node *unsafe_binary(AST_Node *procedure, Vector *operands);
+static AST_Node *procedure_new(Vector *bindings, const char *name, size_t arity, AST_Node *(*function)(AST_Node *procedure, Vector *operands));
+static void binary_procedure_new(Vector *bindings, const char *name, Unsafe_Binary_Function function);
+
+// fixnums, the operands must be fixnums and a divisor must not be 0
+static AST_Node *unsafe_fx_add(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    return value_from_fixnum(value_to_fixnum(a) + value_to_fixnum(b));
+}
+
+static AST_Node *unsafe_fx_subtract(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    return value_from_fixnum(value_to_fixnum(a) - value_to_fixnum(b));
+}
+
+static AST_Node *unsafe_fx_multiply(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    // unsigned, so an overflow wraps instead of being undefined in c
+    return value_from_fixnum((long long int)((unsigned long long int)value_to_fixnum(a) * (unsigned long long int)value_to_fixnum(b)));
+}
+
+static AST_Node *unsafe_fx_quotient(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    return value_from_fixnum(value_to_fixnum(a) / value_to_fixnum(b));
+}
+
+static AST_Node *unsafe_fx_remainder(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    return value_from_fixnum(value_to_fixnum(a) % value_to_fixnum(b));
+}
+
+static AST_Node *unsafe_fx_equal(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    return value_from_boolean(value_to_fixnum(a) == value_to_fixnum(b) ? R_TRUE : R_FALSE);
+}
+
+static AST_Node *unsafe_fx_less_than(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    return value_from_boolean(value_to_fixnum(a) < value_to_fixnum(b) ? R_TRUE : R_FALSE);
+}
+
+static AST_Node *unsafe_fx_more_than(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    return value_from_boolean(value_to_fixnum(a) > value_to_fixnum(b) ? R_TRUE : R_FALSE);
+}
+
+static AST_Node *unsafe_fx_less_or_equal_than(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    return value_from_boolean(value_to_fixnum(a) <= value_to_fixnum(b) ? R_TRUE : R_FALSE);
+}
+
+static AST_Node *unsafe_fx_more_or_equal_than(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    return value_from_boolean(value_to_fixnum(a) >= value_to_fixnum(b) ? R_TRUE : R_FALSE);
+}
+
+// flonums, the operands must be flonums
+static AST_Node *unsafe_fl_add(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    return value_from_double(value_to_flonum(a) + value_to_flonum(b));
+}
+
+static AST_Node *unsafe_fl_subtract(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    return value_from_double(value_to_flonum(a) - value_to_flonum(b));
+}
+
+static AST_Node *unsafe_fl_multiply(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    return value_from_double(value_to_flonum(a) * value_to_flonum(b));
+}
+
+static AST_Node *unsafe_fl_divide(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    return value_from_double(value_to_flonum(a) / value_to_flonum(b));
+}
+
+static AST_Node *unsafe_fl_equal(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    return value_from_boolean(value_to_flonum(a) == value_to_flonum(b) ? R_TRUE : R_FALSE);
+}
+
+static AST_Node *unsafe_fl_less_than(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    return value_from_boolean(value_to_flonum(a) < value_to_flonum(b) ? R_TRUE : R_FALSE);
+}
+
+static AST_Node *unsafe_fl_more_than(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    return value_from_boolean(value_to_flonum(a) > value_to_flonum(b) ? R_TRUE : R_FALSE);
+}
+
+static AST_Node *unsafe_fl_less_or_equal_than(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    return value_from_boolean(value_to_flonum(a) <= value_to_flonum(b) ? R_TRUE : R_FALSE);
+}
+
+static AST_Node *unsafe_fl_more_or_equal_than(AST_Node *procedure, AST_Node *a, AST_Node *b)
+{
+    return value_from_boolean(value_to_flonum(a) >= value_to_flonum(b) ? R_TRUE : R_FALSE);
+}
+
+// (unsafe-flsqrt x), x must be a flonum
+static AST_Node *unsafe_fl_sqrt(AST_Node *procedure, Vector *operands)
+{
+    return value_from_double(sqrt(value_to_flonum(*(AST_Node **)VectorNth(operands, 0))));
+}
+
+// (unsafe-car p) and (unsafe-cdr p), p must be a pair
+static AST_Node *unsafe_car(AST_Node *procedure, Vector *operands)
+{
+    return value_car(*(AST_Node **)VectorNth(operands, 0));
+}
+
+static AST_Node *unsafe_cdr(AST_Node *procedure, Vector *operands)
+{
+    return value_cdr(*(AST_Node **)VectorNth(operands, 0));
+}
+
+// (unsafe-flvector-ref xs i), xs must be an flvector and i a fixnum in range
+static AST_Node *unsafe_flvector_ref(AST_Node *procedure, AST_Node *xs, AST_Node *i)
+{
+    return value_from_double(xs->contents.flvector.elements[value_to_fixnum(i)]);
+}
+
+// (unsafe-flvector-set! xs i x), x must be a flonum too
+static AST_Node *unsafe_flvector_set(AST_Node *procedure, Vector *operands)
+{
+    AST_Node *xs = *(AST_Node **)VectorNth(operands, 0);
+    AST_Node *i = *(AST_Node **)VectorNth(operands, 1);
+    AST_Node *x = *(AST_Node **)VectorNth(operands, 2);
+    xs->contents.flvector.elements[value_to_fixnum(i)] = value_to_flonum(x);
+    return NULL; // void, like set!
+}
+
+// (unsafe-vector-ref vec i), vec must be a vector and i a fixnum in range
+static AST_Node *unsafe_vector_ref(AST_Node *procedure, AST_Node *vec, AST_Node *i)
+{
+    return vec->contents.racket_vector.elements[value_to_fixnum(i)];
+}
+
+// (unsafe-vector-set! vec i v), vec must not be IMMUTABLE either, the write barrier is kept since the collector needs it
+static AST_Node *unsafe_vector_set(AST_Node *procedure, Vector *operands)
+{
+    AST_Node *vec = *(AST_Node **)VectorNth(operands, 0);
+    AST_Node *i = *(AST_Node **)VectorNth(operands, 1);
+    AST_Node *v = *(AST_Node **)VectorNth(operands, 2);
+    vec->contents.racket_vector.elements[value_to_fixnum(i)] = v;
+    gc_write_barrier(vec, v);
+    return NULL;
+}
+
+Vector *generate_unsafe_bindings(void)
+{
+    Vector *unsafe_bindings = VectorNew(sizeof(AST_Node *));
+
+    binary_procedure_new(unsafe_bindings, "unsafe-fx+", unsafe_fx_add);
+    binary_procedure_new(unsafe_bindings, "unsafe-fx-", unsafe_fx_subtract);
+    binary_procedure_new(unsafe_bindings, "unsafe-fx*", unsafe_fx_multiply);
+    binary_procedure_new(unsafe_bindings, "unsafe-fxquotient", unsafe_fx_quotient);
+    binary_procedure_new(unsafe_bindings, "unsafe-fxremainder", unsafe_fx_remainder);
+    binary_procedure_new(unsafe_bindings, "unsafe-fx=", unsafe_fx_equal);
+    binary_procedure_new(unsafe_bindings, "unsafe-fx<", unsafe_fx_less_than);
+    binary_procedure_new(unsafe_bindings, "unsafe-fx>", unsafe_fx_more_than);
+    binary_procedure_new(unsafe_bindings, "unsafe-fx<=", unsafe_fx_less_or_equal_than);
+    binary_procedure_new(unsafe_bindings, "unsafe-fx>=", unsafe_fx_more_or_equal_than);
+
+    binary_procedure_new(unsafe_bindings, "unsafe-fl+", unsafe_fl_add);
+    binary_procedure_new(unsafe_bindings, "unsafe-fl-", unsafe_fl_subtract);
+    binary_procedure_new(unsafe_bindings, "unsafe-fl*", unsafe_fl_multiply);
+    binary_procedure_new(unsafe_bindings, "unsafe-fl/", unsafe_fl_divide);
+    binary_procedure_new(unsafe_bindings, "unsafe-fl=", unsafe_fl_equal);
+    binary_procedure_new(unsafe_bindings, "unsafe-fl<", unsafe_fl_less_than);
+    binary_procedure_new(unsafe_bindings, "unsafe-fl>", unsafe_fl_more_than);
+    binary_procedure_new(unsafe_bindings, "unsafe-fl<=", unsafe_fl_less_or_equal_than);
+    binary_procedure_new(unsafe_bindings, "unsafe-fl>=", unsafe_fl_more_or_equal_than);
+    procedure_new(unsafe_bindings, "unsafe-flsqrt", 1, unsafe_fl_sqrt);
+
+    procedure_new(unsafe_bindings, "unsafe-car", 1, unsafe_car);
+    procedure_new(unsafe_bindings, "unsafe-cdr", 1, unsafe_cdr);
+
+    binary_procedure_new(unsafe_bindings, "unsafe-flvector-ref", unsafe_flvector_ref);
+    procedure_new(unsafe_bindings, "unsafe-flvector-set!", 3, unsafe_flvector_set);
+
+    binary_procedure_new(unsafe_bindings, "unsafe-vector-ref", unsafe_vector_ref);
+    procedure_new(unsafe_bindings, "unsafe-vector-set!", 3, unsafe_vector_set);
+
+    return unsafe_bindings;
+}
+
+// the general entry point of the binary ones, for apply, map and the like
+static AST_Node *unsafe_binary(AST_Node *procedure, Vector *operands)
+{
+    Unsafe_Binary_Function function = TYPECAST(Unsafe_Binary_Function, procedure->contents.procedure.c_native_binary_function);
+    return function(procedure, *(AST_Node **)VectorNth(operands, 0), *(AST_Node **)VectorNth(operands, 1));
+}
+
+static AST_Node *procedure_new(Vector *bindings, const char *name, size_t arity, AST_Node *(*function)(AST_Node *procedure, Vector *operands))
+{
+    AST_Node *procedure = ast_node_new(BUILT_IN_PROCEDURE, Procedure, name, arity, NULL, NULL, TYPECAST(void(*)(void), function));
+    AST_Node *binding = ast_node_new(BUILT_IN_BINDING, Binding, name, procedure);
+    VectorAppend(bindings, &binding);
+    return procedure;
+}
+
+static void binary_procedure_new(Vector *bindings, const char *name, Unsafe_Binary_Function function)
+{
+    AST_Node *procedure = procedure_new(bindings, name, 2, unsafe_binary);
+    procedure->contents.procedure.c_native_binary_function = TYPECAST(void(*)(void), function);
+}
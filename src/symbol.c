@@ -0,0 +1,214 @@
+#include "../include/global.h"
+#include "../include/symbol.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+typedef struct _z_interned {
+    size_t hash;
+    unsigned char *name; // NULL for an empty entry
+} Interned;
+
+// the intern pool lives as long as the process, released by symbols_free()
+static Interned *pool = NULL;
+static size_t pool_length = 0;
+static size_t pool_allocated_length = 0;
+
+static size_t string_hash(const unsigned char *name);
+static size_t address_hash(const unsigned char *symbol);
+static void pool_expand(void);
+static void symbol_table_expand(Symbol_Table *table);
+
+// return: the only copy of name, the same name always gives the same pointer
+const unsigned char *symbol_intern(const unsigned char *name)
+{
+    if (pool_length * 2 >= pool_allocated_length) pool_expand();
+
+    size_t hash = string_hash(name);
+    size_t mask = pool_allocated_length - 1;
+
+    for (size_t i = hash & mask; ; i = (i + 1) & mask)
+    {
+        Interned *interned = &pool[i];
+
+        if (interned->name == NULL)
+        {
+            interned->hash = hash;
+            interned->name = (unsigned char *)malloc(strlen(TYPECAST(const char *, name)) + 1);
+            if (interned->name == NULL)
+            {
+                perror("symbol_intern(): malloc failed");
+                exit(EXIT_FAILURE);
+            }
+            strcpy(TYPECAST(char *, interned->name), TYPECAST(const char *, name));
+            pool_length++;
+            return interned->name;
+        }
+
+        if (interned->hash == hash && strcmp(TYPECAST(const char *, interned->name), TYPECAST(const char *, name)) == 0)
+        {
+            return interned->name;
+        }
+    }
+}
+
+int symbols_free(void)
+{
+    if (pool == NULL) return 1;
+
+    for (size_t i = 0; i < pool_allocated_length; i++)
+    {
+        free(pool[i].name);
+    }
+    free(pool);
+
+    pool = NULL;
+    pool_length = 0;
+    pool_allocated_length = 0;
+
+    return 0;
+}
+
+Symbol_Table *symbol_table_new(void)
+{
+    Symbol_Table *table = (Symbol_Table *)malloc(sizeof(Symbol_Table));
+    if (table == NULL)
+    {
+        perror("symbol_table_new(): malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    table->length = 0;
+    table->allocated_length = 64;
+    table->entries = (Symbol_Table_Entry *)calloc(table->allocated_length, sizeof(Symbol_Table_Entry));
+    if (table->entries == NULL)
+    {
+        perror("symbol_table_new(): calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    return table;
+}
+
+int symbol_table_free(Symbol_Table *table)
+{
+    if (table == NULL) return 1;
+
+    free(table->entries);
+    free(table);
+
+    return 0;
+}
+
+// add or replace the value of symbol
+void symbol_table_set(Symbol_Table *table, const unsigned char *symbol, size_t value)
+{
+    if (table->length * 2 >= table->allocated_length) symbol_table_expand(table);
+
+    size_t mask = table->allocated_length - 1;
+    for (size_t i = address_hash(symbol) & mask; ; i = (i + 1) & mask)
+    {
+        Symbol_Table_Entry *entry = &table->entries[i];
+
+        if (entry->symbol == NULL)
+        {
+            entry->symbol = symbol;
+            entry->value = value;
+            table->length++;
+            return;
+        }
+
+        if (entry->symbol == symbol)
+        {
+            entry->value = value;
+            return;
+        }
+    }
+}
+
+// return: the entry of symbol, NULL if not found
+Symbol_Table_Entry *symbol_table_get(Symbol_Table *table, const unsigned char *symbol)
+{
+    size_t mask = table->allocated_length - 1;
+    for (size_t i = address_hash(symbol) & mask; ; i = (i + 1) & mask)
+    {
+        Symbol_Table_Entry *entry = &table->entries[i];
+        if (entry->symbol == symbol) return entry;
+        if (entry->symbol == NULL) return NULL;
+    }
+}
+
+// FNV-1a
+static size_t string_hash(const unsigned char *name)
+{
+    uint64_t hash = 14695981039346656037ULL;
+
+    for (const unsigned char *c = name; *c != '\0'; c++)
+    {
+        hash ^= *c;
+        hash *= 1099511628211ULL;
+    }
+
+    return (size_t)hash;
+}
+
+// symbols are malloced, so the low bits of the address are always 0, mix them with the high bits
+static size_t address_hash(const unsigned char *symbol)
+{
+    uint64_t hash = (uint64_t)(uintptr_t)symbol;
+    hash *= 11400714819323198485ULL;
+    return (size_t)(hash ^ (hash >> 32));
+}
+
+static void pool_expand(void)
+{
+    Interned *old_pool = pool;
+    size_t old_allocated_length = pool_allocated_length;
+
+    pool_allocated_length = old_allocated_length == 0 ? 256 : old_allocated_length * 2;
+    pool = (Interned *)calloc(pool_allocated_length, sizeof(Interned));
+    if (pool == NULL)
+    {
+        perror("pool_expand(): calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t mask = pool_allocated_length - 1;
+    for (size_t i = 0; i < old_allocated_length; i++)
+    {
+        if (old_pool[i].name == NULL) continue;
+
+        size_t j = old_pool[i].hash & mask;
+        while (pool[j].name != NULL) j = (j + 1) & mask;
+        pool[j] = old_pool[i];
+    }
+
+    free(old_pool);
+}
+
+static void symbol_table_expand(Symbol_Table *table)
+{
+    Symbol_Table_Entry *old_entries = table->entries;
+    size_t old_allocated_length = table->allocated_length;
+
+    table->allocated_length = old_allocated_length * 2;
+    table->entries = (Symbol_Table_Entry *)calloc(table->allocated_length, sizeof(Symbol_Table_Entry));
+    if (table->entries == NULL)
+    {
+        perror("symbol_table_expand(): calloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t mask = table->allocated_length - 1;
+    for (size_t i = 0; i < old_allocated_length; i++)
+    {
+        if (old_entries[i].symbol == NULL) continue;
+
+        size_t j = address_hash(old_entries[i].symbol) & mask;
+        while (table->entries[j].symbol != NULL) j = (j + 1) & mask;
+        table->entries[j] = old_entries[i];
+    }
+
+    free(old_entries);
+}
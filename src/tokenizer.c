@@ -180,12 +180,22 @@ static void tokenizer_helper(const unsigned char *line, void *aux_data)
             continue;
         }
 
-        // handle language, character, boolean
+        // handle language, character, boolean, vector
         // language: supports only: #lang racket
         if (line[i] == POUND)
         {
             cursor = i + 1;
 
+            // handle vector literal such as: #(1 2 3)
+            if (line[cursor] == LEFT_PAREN)
+            {
+                Token *token = token_new(PUNCTUATION, TYPECAST(const unsigned char *, "#("));
+                add_token(tokens, token);
+
+                i = cursor;
+                continue;
+            }
+
             // handle character such as: '#\a'
             if (line[cursor] == BACK_SLASH)
             {
@@ -0,0 +1,289 @@
+#include "../include/global.h"
+#include "../include/value.h"
+#include "../include/parser.h"
+#include "../include/vector.h"
+#include "../include/gc.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// a fixnum if n fits in 48 bits, otherwise a bignum
+AST_Node *value_from_integer(long long int n)
+{
+    if (value_fixnum_fits(n)) return value_from_fixnum(n);
+    return ast_node_new(NOT_IN_AST, Number_Literal, NULL, EXACT, bignum_from_integer(n));
+}
+
+// n is taken over, it is demoted back to a fixnum when it fits in 48 bits
+AST_Node *value_from_bignum(Bignum *n)
+{
+    long long int integer = 0;
+    if (bignum_to_integer(n, &integer) == true && value_fixnum_fits(integer))
+    {
+        free(n);
+        return value_from_fixnum(integer);
+    }
+
+    return ast_node_new(NOT_IN_AST, Number_Literal, NULL, EXACT, n);
+}
+
+// the runtime value of a literal in the ast, the ast is never borrowed, so the value can be shared freely
+AST_Node *value_from_literal(AST_Node *literal)
+{
+    if (value_is_immediate(literal)) return literal;
+
+    if (literal->type == Number_Literal)
+    {
+        if (value_is_exact(literal))
+            return value_from_bignum(bignum_copy(TYPECAST(Bignum *, literal->contents.literal.c_native_value)));
+        else
+            return value_from_double(*(double *)(literal->contents.literal.c_native_value));
+    }
+
+    if (literal->type == Boolean_Literal)
+    {
+        return value_from_boolean(*(Boolean_Type *)(literal->contents.literal.value));
+    }
+
+    if (literal->type == Character_Literal)
+    {
+        return value_from_character(*(unsigned char *)(literal->contents.literal.value));
+    }
+
+    if (literal->type == NULL_Expression ||
+        literal->type == EMPTY_Expression)
+    {
+        return value_empty_list();
+    }
+
+    if (literal->type == List_Literal ||
+        literal->type == Pair_Literal)
+    {
+        Vector *elements = TYPECAST(Vector *, literal->contents.literal.value);
+        Vector *values = VectorNew(sizeof(AST_Node *));
+        gc_push_vector(values); // the elements built so far are held by nothing else
+
+        for (size_t i = 0; i < VectorLength(elements); i++)
+        {
+            AST_Node *element = value_from_literal(*(AST_Node **)VectorNth(elements, i));
+            VectorAppend(values, &element);
+        }
+
+        AST_Node **elements_values = TYPECAST(AST_Node **, VectorNth(values, 0));
+        AST_Node *value = NULL;
+        if (literal->type == List_Literal)
+            value = value_list_from_array(elements_values, VectorLength(values), value_empty_list());
+        else
+            value = value_cons(elements_values[0], elements_values[1]);
+        gc_pop(1);
+        VectorFree(values, NULL, NULL);
+        return value;
+    }
+
+    // a constant shared by every evaluation, so it is IMMUTABLE like racket's vector literals
+    if (literal->type == Vector_Literal)
+    {
+        Vector *elements = TYPECAST(Vector *, literal->contents.literal.value);
+        Vector *values = VectorNew(sizeof(AST_Node *));
+        gc_push_vector(values); // the elements built so far are held by nothing else
+
+        for (size_t i = 0; i < VectorLength(elements); i++)
+        {
+            AST_Node *element = value_from_literal(*(AST_Node **)VectorNth(elements, i));
+            VectorAppend(values, &element);
+        }
+
+        AST_Node *value = ast_node_new(NOT_IN_AST, Racket_Vector, VectorLength(values), NULL);
+        for (size_t i = 0; i < VectorLength(values); i++)
+        {
+            value->contents.racket_vector.elements[i] = *(AST_Node **)VectorNth(values, i);
+        }
+        ast_node_set_tag(value, IMMUTABLE);
+        gc_pop(1);
+        VectorFree(values, NULL, NULL);
+        return value;
+    }
+
+    if (literal->type == String_Literal)
+    {
+        return ast_node_new(NOT_IN_AST, String_Literal, literal->contents.literal.value);
+    }
+
+    fprintf(stderr, "value_from_literal(): can not handle AST_Node_Type: %d\n", literal->type);
+    exit(EXIT_FAILURE);
+}
+
+/*
+    the value of a literal evaluated by eval() or compile(), built on the first evaluation and shared by the later ones
+    values are immutable, nothing can change a constant through another reference, so it is never copied
+*/
+AST_Node *value_from_constant(AST_Node *literal)
+{
+    if (value_is_immediate(literal)) return literal;
+    if (literal->type == NULL_Expression || literal->type == EMPTY_Expression) return value_empty_list();
+    if (literal->contents.literal.constant != NULL) return literal->contents.literal.constant;
+
+    AST_Node *value = value_from_literal(literal);
+    if (value_is_pointer(value))
+    {
+        literal->contents.literal.constant = value;
+        gc_keep(value);
+    }
+    return value;
+}
+
+// one Pair cell, car and cdr must be rooted by the caller since this allocates
+AST_Node *value_cons(AST_Node *car, AST_Node *cdr)
+{
+    return ast_node_new(NOT_IN_AST, Pair, car, cdr);
+}
+
+// a list of elements in order ending with tail, elements must be rooted by the caller
+AST_Node *value_list_from_array(AST_Node **elements, size_t length, AST_Node *tail)
+{
+    AST_Node *list = tail;
+    gc_push_values(&list, 1); // the cells built so far are held by nothing else
+
+    // built from the back, so each cell is allocated once and never touched again
+    for (size_t i = length; i > 0; i--)
+    {
+        list = value_cons(elements[i - 1], list);
+    }
+
+    gc_pop(1);
+    return list;
+}
+
+// a proper list is '() or a chain of pairs ending with '()
+bool value_is_list(AST_Node *value)
+{
+    while (value_is_pair(value)) value = value_cdr(value);
+    return value == value_empty_list();
+}
+
+// list must be a proper list
+size_t value_list_length(AST_Node *list)
+{
+    size_t length = 0;
+    for (; value_is_pair(list); list = value_cdr(list)) length++;
+    return length;
+}
+
+/*
+    equal? of racket: numbers are the same when they are eqv?, of the same exactness and value,
+    strings by their characters, pairs, vectors and flvectors by their elements, anything else only by itself
+    cyclic data never ends, like a vector which holds itself
+*/
+bool value_equal(AST_Node *a, AST_Node *b)
+{
+    for (;;)
+    {
+        // immediates are canonical, a flonum NaN too, and integers in the fixnum range are never bignums
+        if (a == b) return true;
+        if (value_is_immediate(a) || value_is_immediate(b) || a == NULL || b == NULL || a->type != b->type) return false;
+
+        if (a->type == Number_Literal)
+        {
+            if (value_is_exact(a) != value_is_exact(b)) return false;
+            if (value_is_exact(a)) return bignum_compare(value_to_bignum(a), value_to_bignum(b)) == 0;
+            return value_to_double(a) == value_to_double(b);
+        }
+
+        if (a->type == Rational)
+        {
+            return value_equal(a->contents.rational.numerator, b->contents.rational.numerator) &&
+                   value_equal(a->contents.rational.denominator, b->contents.rational.denominator);
+        }
+
+        if (a->type == String_Literal)
+        {
+            return strcmp(TYPECAST(const char *, a->contents.literal.value), TYPECAST(const char *, b->contents.literal.value)) == 0;
+        }
+
+        if (a->type == Racket_Vector)
+        {
+            if (a->contents.racket_vector.length != b->contents.racket_vector.length) return false;
+            for (size_t i = 0; i < a->contents.racket_vector.length; i++)
+            {
+                if (!value_equal(a->contents.racket_vector.elements[i], b->contents.racket_vector.elements[i])) return false;
+            }
+            return true;
+        }
+
+        if (a->type == Flvector)
+        {
+            return a->contents.flvector.length == b->contents.flvector.length &&
+                   memcmp(a->contents.flvector.elements, b->contents.flvector.elements, sizeof(double) * a->contents.flvector.length) == 0;
+        }
+
+        if (a->type != Pair) return false;
+
+        // the cdr is walked by the loop, so a long list takes no stack
+        if (!value_equal(value_car(a), value_car(b))) return false;
+        a = value_cdr(a);
+        b = value_cdr(b);
+    }
+}
+
+// equal values hash the same, see value_equal(), the bits are not mixed, a hash table does it
+size_t value_hash(AST_Node *value)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL; // fnv-1a
+    for (;;)
+    {
+        if (value_is_immediate(value) || value == NULL)
+        {
+            return TYPECAST(size_t, (hash ^ value_bits(value)) * 0x100000001B3ULL);
+        }
+
+        if (value->type == Number_Literal && value_is_exact(value))
+        {
+            Bignum *n = value_to_bignum(value);
+            hash = (hash ^ TYPECAST(uint64_t, n->negative)) * 0x100000001B3ULL;
+            for (size_t i = 0; i < n->length; i++) hash = (hash ^ n->limbs[i]) * 0x100000001B3ULL;
+            return TYPECAST(size_t, hash);
+        }
+
+        if (value->type == Number_Literal)
+        {
+            return value_hash(value_from_double(value_to_double(value)));
+        }
+
+        if (value->type == Rational)
+        {
+            hash = (hash ^ value_hash(value->contents.rational.numerator)) * 0x100000001B3ULL;
+            return TYPECAST(size_t, (hash ^ value_hash(value->contents.rational.denominator)) * 0x100000001B3ULL);
+        }
+
+        if (value->type == String_Literal)
+        {
+            for (const unsigned char *c = value->contents.literal.value; *c != '\0'; c++) hash = (hash ^ *c) * 0x100000001B3ULL;
+            return TYPECAST(size_t, hash);
+        }
+
+        if (value->type == Racket_Vector)
+        {
+            for (size_t i = 0; i < value->contents.racket_vector.length; i++)
+            {
+                hash = (hash ^ value_hash(value->contents.racket_vector.elements[i])) * 0x100000001B3ULL;
+            }
+            return TYPECAST(size_t, hash);
+        }
+
+        if (value->type == Flvector)
+        {
+            for (size_t i = 0; i < value->contents.flvector.length; i++)
+            {
+                hash = (hash ^ value_bits(value_from_double(value->contents.flvector.elements[i]))) * 0x100000001B3ULL;
+            }
+            return TYPECAST(size_t, hash);
+        }
+
+        if (value->type != Pair)
+        {
+            return TYPECAST(size_t, (hash ^ value_bits(value)) * 0x100000001B3ULL);
+        }
+
+        hash = (hash ^ value_hash(value_car(value))) * 0x100000001B3ULL;
+        value = value_cdr(value);
+    }
+}
@@ -0,0 +1,395 @@
+#include "../include/global.h"
+#include "../include/vm.h"
+#include "../include/interpreter.h"
+#include "../include/environment.h"
+#include "../include/gc.h"
+#include "../include/parser.h"
+#include "../include/value.h"
+#include "../include/vector.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+typedef struct _z_call_frame {
+    Chunk *chunk;
+    size_t pc; // index of the next instruction
+    Environment *env; // the innermost environment, owned by the frame
+} Call_Frame;
+
+typedef struct _z_vm_stack {
+    AST_Node **values; // the same as eval() results
+    size_t length;
+    size_t allocated_length;
+    Call_Frame *frames;
+    size_t frames_length;
+    size_t frames_allocated_length;
+} VM_Stack;
+
+static void push(VM_Stack *stack, AST_Node *value);
+static AST_Node *pop(VM_Stack *stack);
+static Call_Frame *push_frame(VM_Stack *stack, Chunk *chunk, Environment *env);
+static void check_arity(AST_Node *procedure, size_t required_params_count, size_t operands_count);
+static void mark_stack(void *data);
+
+/*
+    run a chunk from compile() against env, return the value of the top level form
+    the return value is the same as the one of eval()
+    values on the stack are evaluated by eval() from literals, so both engines share the value rules
+    the values and the environments of the frames are gc roots while it runs
+*/
+AST_Node *vm_run(Chunk *chunk, Environment *env, void *aux_data)
+{
+    VM_Stack stack = { NULL, 0, 0, NULL, 0, 0 };
+    AST_Node *result = NULL;
+
+    Call_Frame *frame = push_frame(&stack, chunk, environment_retain(env));
+    gc_push_root(mark_stack, &stack);
+
+    for (;;)
+    {
+        Instruction instruction = frame->chunk->code[frame->pc++];
+
+        switch (instruction.opcode)
+        {
+            case OP_CONSTANT:
+            {
+                // a value folded by compile(), a procedure, or a Lambda_Form called directly by OP_CALL which never escapes
+                push(&stack, frame->chunk->constants[instruction.operand]);
+                break;
+            }
+
+            case OP_EMPTY_LIST:
+                push(&stack, value_empty_list());
+                break;
+
+            case OP_TRUE:
+                push(&stack, value_from_boolean(R_TRUE));
+                break;
+
+            case OP_FALSE:
+                push(&stack, value_from_boolean(R_FALSE));
+                break;
+
+            case OP_VOID:
+                push(&stack, NULL);
+                break;
+
+            case OP_LOAD:
+            {
+                // shared with the environment, nothing is copied
+                push(&stack, lookup_value(frame->env, frame->chunk->addresses[instruction.operand], frame->chunk->names[instruction.operand]));
+                break;
+            }
+
+            case OP_DEFINE:
+            {
+                const unsigned char *name = frame->chunk->names[instruction.operand];
+                AST_Node *value = pop(&stack);
+                set_procedure_name(value, name);
+                *environment_slot(frame->env, frame->chunk->addresses[instruction.operand]) = value;
+                break;
+            }
+
+            case OP_SET:
+            {
+                const unsigned char *name = frame->chunk->names[instruction.operand];
+                AST_Node *value = pop(&stack);
+
+                Lexical_Address address = frame->chunk->addresses[instruction.operand];
+                if (address.resolved == false)
+                {
+                    fprintf(stderr, "eval(): set!: unbound identifier: %s\n", name);
+                    exit(EXIT_FAILURE);
+                }
+
+                set_procedure_name(value, name);
+                *environment_slot(frame->env, address) = value;
+                break;
+            }
+
+            case OP_POP:
+                pop(&stack);
+                break;
+
+            case OP_CLOSURE:
+            {
+                AST_Node *lambda_form = frame->chunk->constants[instruction.operand];
+                Vector *params = lambda_form->contents.lambda_form.params;
+                Vector *body_exprs = lambda_form->contents.lambda_form.body_exprs;
+
+                AST_Node *procedure = ast_node_new(NOT_IN_AST, Procedure, NULL, VectorLength(params), params, body_exprs, NULL);
+                procedure->contents.procedure.environment = environment_retain(frame->env);
+                procedure->contents.procedure.code = lambda_form->contents.lambda_form.code;
+                procedure->contents.procedure.frame_length = VectorLength(lambda_form->context);
+                push(&stack, procedure);
+                break;
+            }
+
+            case OP_JUMP:
+                frame->pc = instruction.operand;
+                break;
+
+            case OP_JUMP_IF_FALSE:
+            {
+                AST_Node *value = pop(&stack);
+                if (value == NULL)
+                {
+                    fprintf(stderr, "eval(): if: bad syntax\n");
+                    exit(EXIT_FAILURE);
+                }
+                if (is_false(value)) frame->pc = instruction.operand;
+                break;
+            }
+
+            case OP_JUMP_IF_FALSE_KEEP:
+            {
+                AST_Node *value = stack.values[stack.length - 1];
+                if (is_false(value))
+                {
+                    frame->pc = instruction.operand;
+                }
+                else
+                {
+                    pop(&stack);
+                }
+                break;
+            }
+
+            case OP_JUMP_IF_TRUE_KEEP:
+            {
+                AST_Node *value = stack.values[stack.length - 1];
+                if (!is_false(value))
+                {
+                    frame->pc = instruction.operand;
+                }
+                else
+                {
+                    pop(&stack);
+                }
+                break;
+            }
+
+            case OP_NOT:
+            {
+                AST_Node *value = pop(&stack);
+                push(&stack, value_from_boolean(is_false(value) ? R_TRUE : R_FALSE));
+                break;
+            }
+
+            case OP_ENTER:
+            {
+                Environment *inner = environment_new(frame->env, instruction.operand);
+                environment_release(frame->env);
+                frame->env = inner;
+                break;
+            }
+
+            case OP_LEAVE:
+            {
+                Environment *outer = frame->env;
+                for (size_t i = 0; i < instruction.operand; i++) outer = outer->parent;
+                environment_retain(outer);
+                environment_release(frame->env);
+                frame->env = outer;
+                break;
+            }
+
+            case OP_CALL:
+            case OP_TAIL_CALL:
+            {
+                size_t operands_count = instruction.operand;
+                AST_Node **operands = &stack.values[stack.length - operands_count];
+                AST_Node *procedure = operands[-1];
+
+                if (procedure == NULL)
+                {
+                    fprintf(stderr, "eval(): call expression error\n");
+                    exit(EXIT_FAILURE);
+                }
+
+                Environment *parent = NULL;
+                Chunk *code = NULL;
+                size_t frame_length = 0;
+
+                AST_Node_Type type = value_type(procedure);
+
+                if (type == Lambda_Form)
+                {
+                    // ((lambda (x) x) 1)
+                    check_arity(NULL, VectorLength(procedure->contents.lambda_form.params), operands_count);
+                    parent = frame->env;
+                    code = procedure->contents.lambda_form.code;
+                    frame_length = VectorLength(procedure->context);
+                }
+                else if (type == Procedure && operands_count == 2 && procedure->contents.procedure.c_native_binary_function != NULL)
+                {
+                    // (+ a b), (= n 0): the fixed-arity entry point takes the operands off the stack
+                    Function c_native_binary_function = procedure->contents.procedure.c_native_binary_function;
+                    AST_Node *value = ((AST_Node *(*)(AST_Node *procedure, AST_Node *a, AST_Node *b))c_native_binary_function)(procedure, operands[0], operands[1]);
+
+                    stack.length -= 3;
+                    push(&stack, value);
+                    break;
+                }
+                else if (type == Procedure && procedure->contents.procedure.c_native_function != NULL)
+                {
+                    // built-in or addon procedure, operands are passed in place
+                    Vector operands_vector = { operands, sizeof(AST_Node *), operands_count, operands_count };
+                    Function c_native_function = procedure->contents.procedure.c_native_function;
+                    AST_Node *value = ((AST_Node *(*)(AST_Node *procedure, Vector *operands))c_native_function)(procedure, &operands_vector);
+
+                    stack.length -= operands_count + 1;
+                    push(&stack, value);
+                    break;
+                }
+                else if (type == Procedure)
+                {
+                    check_arity(procedure, procedure->contents.procedure.required_params_count, operands_count);
+                    parent = procedure->contents.procedure.environment;
+                    code = procedure->contents.procedure.code;
+                    frame_length = procedure->contents.procedure.frame_length;
+
+                    // compile() compiles every Lambda_Form of a top level form before it runs
+                    if (code == NULL)
+                    {
+                        fprintf(stderr, "vm_run(): procedure has no bytecode\n");
+                        exit(EXIT_FAILURE);
+                    }
+                }
+                else
+                {
+                    fprintf(stderr, "eval(): not a procedure\n");
+                    exit(EXIT_FAILURE);
+                }
+
+                // one environment for every function call, holds the operands in the first slots, the body is shared
+                Environment *inner = environment_new(parent, frame_length);
+                for (size_t i = 0; i < operands_count; i++)
+                {
+                    inner->slots[i] = operands[i];
+                }
+                stack.length -= operands_count + 1; // operands are held by inner now
+
+                if (instruction.opcode == OP_TAIL_CALL)
+                {
+                    // the callee replaces the current call frame, so the stack of frames stays constant
+                    environment_release(frame->env);
+                    frame->chunk = code;
+                    frame->pc = 0;
+                    frame->env = inner;
+                }
+                else
+                {
+                    frame = push_frame(&stack, code, inner);
+                }
+                break;
+            }
+
+            case OP_RETURN:
+            {
+                environment_release(frame->env);
+                stack.frames_length--;
+
+                if (stack.frames_length == 0)
+                {
+                    gc_pop(1);
+                    result = pop(&stack);
+                    free(stack.values);
+                    free(stack.frames);
+                    return result;
+                }
+
+                // the result stays on the top of the stack for the caller
+                frame = &stack.frames[stack.frames_length - 1];
+                break;
+            }
+
+            default:
+            {
+                fprintf(stderr, "vm_run(): can not run Opcode: %d\n", instruction.opcode);
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+}
+
+static void push(VM_Stack *stack, AST_Node *value)
+{
+    if (stack->length == stack->allocated_length)
+    {
+        stack->allocated_length = stack->allocated_length == 0 ? 64 : stack->allocated_length * 2;
+        stack->values = (AST_Node **)realloc(stack->values, sizeof(AST_Node *) * stack->allocated_length);
+        if (stack->values == NULL)
+        {
+            perror("push(): realloc failed");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    stack->values[stack->length++] = value;
+}
+
+static AST_Node *pop(VM_Stack *stack)
+{
+    return stack->values[--stack->length];
+}
+
+// return: the new top frame, frames may be moved so the old pointers are invalid after this
+static Call_Frame *push_frame(VM_Stack *stack, Chunk *chunk, Environment *env)
+{
+    if (stack->frames_length == stack->frames_allocated_length)
+    {
+        stack->frames_allocated_length = stack->frames_allocated_length == 0 ? 16 : stack->frames_allocated_length * 2;
+        stack->frames = (Call_Frame *)realloc(stack->frames, sizeof(Call_Frame) * stack->frames_allocated_length);
+        if (stack->frames == NULL)
+        {
+            perror("push_frame(): realloc failed");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    Call_Frame *frame = &stack->frames[stack->frames_length++];
+    frame->chunk = chunk;
+    frame->pc = 0;
+    frame->env = env;
+
+    return frame;
+}
+
+// same messages as eval(), procedure is NULL for ((lambda ...) ...)
+static void check_arity(AST_Node *procedure, size_t required_params_count, size_t operands_count)
+{
+    if (operands_count == required_params_count) return;
+
+    if (procedure == NULL || procedure->contents.procedure.name == NULL)
+    {
+        fprintf(stderr, "anomyous procedure: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", required_params_count, operands_count);
+    }
+    else
+    {
+        fprintf(stderr, "%s: arity mismatch;\n"
+                        "the expected number of arguments does not match the given number\n"
+                        "expected: %zu\n"
+                        "given: %zu\n", procedure->contents.procedure.name, required_params_count, operands_count);
+    }
+    exit(EXIT_FAILURE);
+}
+
+// GC_Root_Function of vm_run(), data is the VM_Stack
+static void mark_stack(void *data)
+{
+    VM_Stack *stack = TYPECAST(VM_Stack *, data);
+
+    for (size_t i = 0; i < stack->length; i++)
+    {
+        gc_mark_value(stack->values[i]);
+    }
+
+    for (size_t i = 0; i < stack->frames_length; i++)
+    {
+        gc_mark_environment(stack->frames[i].env);
+    }
+}